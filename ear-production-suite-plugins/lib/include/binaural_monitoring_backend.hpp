@@ -1,5 +1,6 @@
 #pragma once
 
+#include "communication/common_types.hpp"
 #include "communication/monitoring_control_connection.hpp"
 #include "scene_store.pb.h"
 #include "log.hpp"
@@ -12,9 +13,10 @@
 #include <memory>
 #include <mutex>
 #include <optional>
-#include <map>
+#include <unordered_map>
+#include <unordered_set>
 
-using ConnId = std::string;
+using ConnId = ear::plugin::communication::ConnectionId;
 
 namespace ear {
 namespace plugin {
@@ -75,7 +77,7 @@ class BinauralMonitoringBackend {
   void onConnectionLost();
 
   std::mutex latestMonitoringItemMetadataMutex_;
-  std::map<ConnId, ear::plugin::proto::MonitoringItemMetadata>
+  std::unordered_map<ConnId, ear::plugin::proto::MonitoringItemMetadata>
       latestMonitoringItemMetadata;
 
   std::mutex activeDirectSpeakersIdsMutex_;
@@ -88,15 +90,16 @@ class BinauralMonitoringBackend {
   std::vector<ConnId> activeHoaIds;
   size_t hoaChannelCount{0};
 
-  std::vector<ConnId> allActiveIds;
+  std::unordered_set<ConnId> allActiveIds;
 
   std::mutex latestDirectSpeakersTypeMetadataMutex_;
-  std::map<ConnId, DirectSpeakersEarMetadataAndRouting>
+  std::unordered_map<ConnId, DirectSpeakersEarMetadataAndRouting>
       latestDirectSpeakersTypeMetadata;
   std::mutex latestObjectsTypeMetadataMutex_;
-  std::map<ConnId, ObjectsEarMetadataAndRouting> latestObjectsTypeMetadata;
+  std::unordered_map<ConnId, ObjectsEarMetadataAndRouting>
+      latestObjectsTypeMetadata;
   std::mutex latestHoaTypeMetadataMutex_;
-  std::map<ConnId, HoaEarMetadataAndRouting> latestHoaTypeMetadata;
+  std::unordered_map<ConnId, HoaEarMetadataAndRouting> latestHoaTypeMetadata;
 
   std::shared_ptr<spdlog::logger> logger_;
   ui::MonitoringFrontendBackendConnector* frontendConnector_;
@@ -91,14 +91,20 @@ class ObjectDetailsMessage {
 class ConnectionDetailsResponse {
  public:
   ConnectionDetailsResponse(ConnectionId connectionID,
-                            const std::string& metadataEndpoint)
-      : connectionId_(connectionID), endpoint_(metadataEndpoint) {}
+                            const std::string& metadataEndpoint,
+                            bool metadataHeartbeat = false)
+      : connectionId_(connectionID),
+        endpoint_(metadataEndpoint),
+        metadataHeartbeat_(metadataHeartbeat) {}
   ConnectionId connectionId() const { return connectionId_; }
   std::string metadataEndpoint() const { return endpoint_; }
+  // Whether the Scene accepts heartbeats on the metadata endpoint
+  bool metadataHeartbeat() const { return metadataHeartbeat_; }
 
  private:
   ConnectionId connectionId_;
   std::string endpoint_;
+  bool metadataHeartbeat_;
 };
 
 class ItemPropertiesChangedMessage {
@@ -3,6 +3,8 @@
 
 #include "../detail/named_type.hpp"
 #include <stdint.h>
+#include <cstring>
+#include <functional>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -59,6 +61,16 @@ class ConnectionId {
     return this->getUuid() < other.getUuid();
   }
 
+  /// Hash of the 128-bit id, suitable for unordered containers.
+  /// The id is random, so folding the two 64-bit halves is sufficient and
+  /// avoids the per-byte combine of boost::hash.
+  std::size_t hash() const noexcept {
+    uint64_t halves[2];
+    static_assert(sizeof(halves) == sizeof(id_.data));
+    std::memcpy(halves, id_.data, sizeof(halves));
+    return static_cast<std::size_t>(halves[0] ^ (halves[1] * 0x9E3779B97F4A7C15ull));
+  }
+
  private:
   boost::uuids::uuid id_;
 };
@@ -79,6 +91,31 @@ enum class ErrorCode {
 
 enum class ConnectionType { METADATA_INPUT, MONITORING };
 
+/**
+ * How an input keeps the Scene up to date when nothing has changed.
+ *
+ * FULL_RESEND is the original behaviour: the full metadata is resent whenever
+ * nothing has been sent for a while.
+ * HEARTBEAT sends a small message carrying only the connection id and the
+ * continuity counter of the last full message. The full metadata is resent
+ * only when requested, i.e. when a new pipe to the Scene is established
+ * (Scene restart) or when the Scene closes our pipe after detecting a
+ * continuity counter mismatch.
+ * Only Scenes which say they accept heartbeats when the input connects are
+ * sent them; any other Scene gets FULL_RESEND.
+ */
+enum class ResendMode { FULL_RESEND, HEARTBEAT };
+
 }  // namespace communication
 }  // namespace plugin
 }  // namespace ear
+
+namespace std {
+template <>
+struct hash<ear::plugin::communication::ConnectionId> {
+  std::size_t operator()(
+      const ear::plugin::communication::ConnectionId& id) const noexcept {
+    return id.hash();
+  }
+};
+}  // namespace std
@@ -26,14 +26,37 @@ class DataWrapper {
     return std::invoke(accessor, data);
   }
 
+  // The message carries the next continuity counter, but it is only kept
+  // once confirmSent() is called, so heartbeats never report a message the
+  // Scene has not received
   MessageBuffer prepareMessage() {
     std::lock_guard<std::mutex> lock{mutex_};
+    auto lastSent = data_.continuity_counter();
+    data_.set_continuity_counter(lastSent + 1);
     MessageBuffer buffer = allocBuffer(data_.ByteSizeLong());
     data_.SerializeToArray(buffer.data(), buffer.size());
+    data_.set_continuity_counter(lastSent);
     data_.set_changed(false);
     return buffer;
   }
 
+  void confirmSent() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    data_.set_continuity_counter(data_.continuity_counter() + 1);
+  }
+
+  MessageBuffer prepareHeartbeat() {
+    std::lock_guard<std::mutex> lock{mutex_};
+    proto::InputItemMetadata heartbeat;
+    heartbeat.set_connection_id(data_.connection_id());
+    heartbeat.set_continuity_counter(data_.continuity_counter());
+    heartbeat.set_changed(false);
+    heartbeat.set_heartbeat(true);
+    MessageBuffer buffer = allocBuffer(heartbeat.ByteSizeLong());
+    heartbeat.SerializeToArray(buffer.data(), buffer.size());
+    return buffer;
+  }
+
  private:
   proto::InputItemMetadata data_;
   std::mutex mutex_;
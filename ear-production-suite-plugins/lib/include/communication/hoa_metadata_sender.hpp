@@ -15,7 +15,8 @@ class HoaMetadataSender {
  public:
   HoaMetadataSender(std::shared_ptr<spdlog::logger> logger = nullptr);
   void logger(std::shared_ptr<spdlog::logger> logger);
-  void connect(const std::string& endpoint, ConnectionId connectionId);
+  void connect(const std::string& endpoint, ConnectionId connectionId,
+               ResendMode resendMode);
   void disconnect();
   void triggerSend();
 
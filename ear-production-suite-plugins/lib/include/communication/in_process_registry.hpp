@@ -0,0 +1,87 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace ear::plugin {
+class MetadataThread;
+}
+
+namespace ear::plugin::communication {
+
+/**
+ * @brief Process-wide registry of in-process message receivers
+ *
+ * All EPS plugins normally live in the same DAW process, so metadata can be
+ * handed over directly instead of travelling through an IPC socket.
+ *
+ * Every plugin binary links its own copy of ear-plugin-base, so a plain
+ * static cannot be shared between them. The receiver table is allocated once
+ * per process and its address is published in an environment variable
+ * together with the table layout version and the process id. Plugins built
+ * against a different layout, or running in another (e.g. bridged) process,
+ * won't find a usable table and keep using IPC.
+ *
+ * Only plain data and C function pointers cross the binary boundary: messages
+ * are handed over as serialised bytes, because protobuf objects created by one
+ * plugin binary must not be used by the protobuf runtime of another.
+ */
+class InProcessRegistry {
+ public:
+  using DeliverFunction = void (*)(void* context, const void* data,
+                                   std::size_t size);
+
+  static InProcessRegistry& instance();
+
+  /// Register a receiver for `endpoint`, returns a handle for `remove()` or
+  /// -1 if the table is full. `deliver` is called on the publisher's thread,
+  /// so should only copy or flag what it is given.
+  int add(const std::string& endpoint, void* context, DeliverFunction deliver);
+  /// After this returns, `deliver` will not be called for the handle again.
+  void remove(int handle);
+
+  /// Deliver a copy of `data` to all receivers registered for `endpoint`.
+  /// Returns the number of receivers the data was delivered to.
+  std::size_t publish(const std::string& endpoint, const void* data,
+                      std::size_t size);
+  bool hasReceiver(const std::string& endpoint);
+
+ private:
+  InProcessRegistry();
+  struct Table;
+  Table* table_;
+};
+
+/// Endpoint on which the sender of `connectionId` listens for requests to
+/// resend its full metadata, as there is no pipe to close in-process
+std::string resendRequestEndpoint(const std::string& connectionId);
+
+/**
+ * @brief Receives messages published to an endpoint via the InProcessRegistry
+ *
+ * Delivered bytes are copied and handed to `handler` on a dedicated thread, so
+ * a publisher (possibly running on an audio thread) never runs receiver code.
+ */
+class InProcessReceiver {
+ public:
+  using Handler = std::function<void(const void* data, std::size_t size)>;
+  InProcessReceiver();
+  ~InProcessReceiver();
+  InProcessReceiver(const InProcessReceiver&) = delete;
+  InProcessReceiver& operator=(const InProcessReceiver&) = delete;
+
+  bool start(const std::string& endpoint, Handler handler);
+  /// Unregister from the registry. Does not block, so may be called from
+  /// within the handler.
+  void stop();
+
+ private:
+  static void deliver(void* context, const void* data, std::size_t size);
+  Handler handler_;
+  std::atomic<int> handle_{-1};
+  std::unique_ptr<MetadataThread> thread_;
+};
+
+}  // namespace ear::plugin::communication
@@ -33,8 +33,10 @@ class Request;
  */
 class InputControlConnection {
  public:
+  // Called with the assigned id, the metadata endpoint and how to keep the
+  // Scene up to date on it
   using ConnectionEstablishedHandler =
-      std::function<void(ConnectionId, std::string)>;
+      std::function<void(ConnectionId, std::string, ResendMode)>;
   using ConnectionLostHandler = std::function<void()>;
 
   EAR_PLUGIN_BASE_EXPORT explicit InputControlConnection(std::shared_ptr<spdlog::logger> logger);
@@ -19,14 +19,22 @@ class MetadataSender {
                           std::shared_ptr<spdlog::logger> logger = nullptr);
   ~MetadataSender();
   void connect(const std::string& endpoint,
-               ConnectionId id);
+               ConnectionId id,
+               ResendMode resendMode);
   ConnectionId connectionId();
   void disconnect();
   void triggerSend(bool force = false);
+  void requestFullResend();
   void logger(std::shared_ptr<spdlog::logger> logger);
  private:
   void startTimer();
   void handleTimeout(std::error_code ec);
+  void sendHeartbeat();
+  bool sendInProcess(const MessageBuffer& msg);
+  static void handleResendRequest(void* context, const void* data,
+                                  std::size_t size);
+  void stopResendRequests();
+  void registerPipeEvents();
   DataWrapper& data_;
   std::shared_ptr<spdlog::logger> logger_;
   nng::PushSocket socket_;
@@ -35,8 +43,13 @@ class MetadataSender {
   std::mutex timeoutMutex_;
   std::mutex sendMutex_;
   ConnectionId connectionId_;
+  std::string endpoint_;
   std::chrono::system_clock::time_point lastSendTimestamp_;
   std::chrono::milliseconds maxSendInterval_;
+  std::chrono::milliseconds heartbeatInterval_;
+  std::atomic<ResendMode> resendMode_;
+  std::atomic<bool> resendRequested_{false};
+  std::atomic<int> resendRequestHandle_{-1};
   std::atomic<bool> timerRunning{false};
 };
 }
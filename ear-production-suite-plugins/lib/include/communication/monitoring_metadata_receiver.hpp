@@ -2,6 +2,7 @@
 
 #include "log.hpp"
 #include "nng-cpp/nng.hpp"
+#include "communication/in_process_registry.hpp"
 #include <memory>
 
 namespace ear {
@@ -47,10 +48,12 @@ class MonitoringMetadataReceiver {
  private:
   void waitForMetadata();
   void handleReceive(std::error_code ec, nng::Message message);
+  void dispatch(const void* data, std::size_t size);
 
   std::shared_ptr<spdlog::logger> logger_;
   RequestHandler handler_;
   nng::SubSocket socket_;
+  InProcessReceiver inProcessReceiver_;
 };
 }  // namespace communication
 }  // namespace plugin
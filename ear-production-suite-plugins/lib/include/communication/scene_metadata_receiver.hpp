@@ -3,9 +3,13 @@
 #include "nng-cpp/nng.hpp"
 #include "log.hpp"
 #include "communication/common_types.hpp"
+#include "communication/in_process_registry.hpp"
 #include "input_item_metadata.pb.h"
 #include <boost/variant.hpp>
 #include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
 
 namespace ear {
 namespace plugin {
@@ -42,12 +46,22 @@ class SceneMetadataReceiver {
   void run(const std::string& endpoint, const RequestHandler& handler);
   void checkEndpoint(const std::string& endpoint);
 
+  /// Forget the continuity state of a connection that has been closed
+  void removeConnection(const communication::ConnectionId& id);
+
  private:
   void waitForMetadata();
   void handleReceive(std::error_code ec, nng::Message message);
+  void dispatch(const void* data, std::size_t size,
+                std::optional<nng::Pipe> pipe);
+  void handleHeartbeat(const proto::InputItemMetadata& heartbeat,
+                       std::optional<nng::Pipe> pipe);
   RequestHandler handler_;
+  std::mutex continuityMutex_;
+  std::unordered_map<communication::ConnectionId, uint32_t> lastContinuityCounter_;
   nng::PullSocket socket_;
   std::shared_ptr<spdlog::logger> logger_;
+  InProcessReceiver inProcessReceiver_;
 };
 
 }  // namespace communication
@@ -30,7 +30,8 @@ class DirectSpeakersBackend {
 
  private:
   void onConnection(communication::ConnectionId connectionId,
-                    const std::string& streamEndpoint);
+                    const std::string& streamEndpoint,
+                    communication::ResendMode resendMode);
   void onConnectionLost();
   void onParameterChanged(
       ui::DirectSpeakersFrontendBackendConnector::ParameterId parameter,
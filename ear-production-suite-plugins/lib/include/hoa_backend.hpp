@@ -29,7 +29,8 @@ class HoaBackend {
 
  private:
   void onConnection(communication::ConnectionId connectionId,
-                    const std::string& streamEndpoint);
+                    const std::string& streamEndpoint,
+                    communication::ResendMode resendMode);
   void onConnectionLost();
   void onParameterChanged(
       ui::HoaFrontendBackendConnector::ParameterId parameter,
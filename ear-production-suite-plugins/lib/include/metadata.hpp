@@ -8,6 +8,10 @@
 #include "input_item_metadata.pb.h"
 #include "programme_internal_id.hpp"
 #include "communication/common_types.hpp"
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+#include <vector>
 
 namespace ear::plugin {
 
@@ -16,9 +20,21 @@ struct InputItem {
   proto::InputItemMetadata data;
 };
 
-using ItemMap = std::map<communication::ConnectionId, proto::InputItemMetadata>;
+using ItemMap = std::unordered_map<communication::ConnectionId, proto::InputItemMetadata>;
 using RouteMap = std::multimap<int, communication::ConnectionId>;
 
+// ItemMap is unordered; use this wherever iteration order reaches the UI or serialised output
+inline std::vector<ItemMap::const_pointer> sortedById(ItemMap const& items) {
+  std::vector<ItemMap::const_pointer> sorted;
+  sorted.reserve(items.size());
+  for (auto const& entry : items) {
+    sorted.push_back(&entry);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](auto lhs, auto rhs) { return lhs->first < rhs->first; });
+  return sorted;
+}
+
 struct ProgrammeStatus {
   ProgrammeInternalId id;
   bool isSelected;
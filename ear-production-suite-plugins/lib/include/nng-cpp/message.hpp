@@ -1,5 +1,6 @@
 #pragma once
 #include "error_handling.hpp"
+#include "pipe.hpp"
 #include <nng/nng.h>
 
 namespace nng {
@@ -62,6 +63,11 @@ class Message {
    */
   bool isValid() const { return msg_ != nullptr; }
 
+  /**
+   * The pipe the message was received on, equivalent to `nng_msg_get_pipe`
+   */
+  Pipe pipe() const { return Pipe{nng_msg_get_pipe(msg_)}; }
+
   /**
    * Releases the underlying `nng_msg` to the caller, the Message instance is no
    * longer valid. It's the callers responsibility to free the message using
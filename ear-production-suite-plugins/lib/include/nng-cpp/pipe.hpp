@@ -2,6 +2,7 @@
 #include "error_handling.hpp"
 #include "ear-plugin-base/config.h"
 #include <nng/nng.h>
+#include <functional>
 
 namespace nng {
 /**
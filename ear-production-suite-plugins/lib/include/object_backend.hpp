@@ -30,7 +30,8 @@ class ObjectBackend {
 
  private:
   void onConnection(communication::ConnectionId connectionId,
-                    const std::string& streamEndpoint);
+                    const std::string& streamEndpoint,
+                    communication::ResendMode resendMode);
   void onConnectionLost();
   void onParameterChanged(
       ui::ObjectsFrontendBackendConnector::ParameterId parameter,
@@ -42,7 +42,7 @@ class ProgrammeStoreAdmSerializer {
   bool isAlreadySerialized(proto::Object const& object) const;
 
   proto::ProgrammeStore programmes_;
-  std::map<communication::ConnectionId, proto::InputItemMetadata> items_;
+  ItemMap items_;
   std::shared_ptr<adm::Document> doc;
   std::vector<PluginMap> pluginMap;
   std::map<std::string, std::shared_ptr<adm::AudioObject>> serializedObjects;
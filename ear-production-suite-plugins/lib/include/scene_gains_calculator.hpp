@@ -6,8 +6,8 @@
 #include "communication/common_types.hpp"
 #include <ear/ear.hpp>
 #include <Eigen/Eigen>
-#include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include "helper/common_definition_helper.h"
 
@@ -43,7 +43,7 @@ class SceneGainsCalculator {
   ear::GainCalculatorDirectSpeakers directSpeakersCalculator_;
   ear::GainCalculatorHOA hoaCalculator_;
 
-  std::map<communication::ConnectionId, ItemRouting> routingCache_;
+  std::unordered_map<communication::ConnectionId, ItemRouting> routingCache_;
 
   std::mutex commonDefinitionHelperMutex_;
   AdmCommonDefinitionHelper commonDefinitionHelper_{};
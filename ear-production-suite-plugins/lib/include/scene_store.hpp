@@ -8,6 +8,7 @@
 #include <functional>
 #include <mutex>
 #include <set>
+#include <unordered_set>
 #include "metadata_listener.hpp"
 #include "scene_store.pb.h"
 
@@ -19,7 +20,7 @@ public:
 
 private:
     proto::SceneStore store_;
-    std::set<communication::ConnectionId> itemsChangedSinceLastSend;
+    std::unordered_set<communication::ConnectionId> itemsChangedSinceLastSend;
     std::set<std::string> overlappingIds_;
     std::function<void(proto::SceneStore const&)> updateCallback_;
     enum ExportingSendState {
@@ -213,13 +213,13 @@ void BinauralMonitoringBackend::onSceneReceived(proto::SceneStore store) {
   size_t totalObjChannels = 0;
   size_t totalHoaChannels = 0;
 
-  std::vector<ConnId> availableItemIds;
+  std::unordered_set<ConnId> availableItemIds;
   availableItemIds.reserve(store.all_available_items_size());
 
   for (const auto& item : store.all_available_items()) {
     if(item.has_connection_id() &&
        isValidId(item.connection_id())) {
-      availableItemIds.push_back(item.connection_id());
+      availableItemIds.insert(ConnId{item.connection_id()});
     }
     if (item.has_ds_metadata()) {
       totalDsChannels += item.ds_metadata().speakers_size();
@@ -250,11 +250,13 @@ void BinauralMonitoringBackend::onSceneReceived(proto::SceneStore store) {
   activeHoaIds.clear();
 
   for (const auto& item : store.monitoring_items()) {
-    if (item.has_connection_id() &&
-        isValidId(item.connection_id()) &&
-        contains(availableItemIds, item.connection_id())) {
+    if (!item.has_connection_id() || !isValidId(item.connection_id())) {
+      continue;
+    }
+    ConnId const id{item.connection_id()};
+    if (contains(availableItemIds, id)) {
 
-      bool newItem = !contains(allActiveIds, item.connection_id());
+      bool newItem = !contains(allActiveIds, id);
 
       // clang-format off
       if (item.has_hoa_metadata()) {
@@ -262,16 +264,16 @@ void BinauralMonitoringBackend::onSceneReceived(proto::SceneStore store) {
           {
             std::lock_guard<std::mutex> lock(latestHoaTypeMetadataMutex_);
             removeFromMap<ConnId, HoaEarMetadataAndRouting>(
-                latestHoaTypeMetadata, item.connection_id());
+                latestHoaTypeMetadata, id);
           }
           {
             std::lock_guard<std::mutex> lock(
                 latestMonitoringItemMetadataMutex_);
             setInMap<ConnId, ear::plugin::proto::MonitoringItemMetadata>(
-                latestMonitoringItemMetadata, item.connection_id(), item);
+                latestMonitoringItemMetadata, id, item);
           }
         }
-        activeHoaIds.push_back(item.connection_id());
+        activeHoaIds.push_back(id);
       }
 
       if (item.has_ds_metadata()) {
@@ -280,16 +282,16 @@ void BinauralMonitoringBackend::onSceneReceived(proto::SceneStore store) {
             std::lock_guard<std::mutex> lock(
                 latestDirectSpeakersTypeMetadataMutex_);
             removeFromMap<ConnId, DirectSpeakersEarMetadataAndRouting>(
-                latestDirectSpeakersTypeMetadata, item.connection_id());
+                latestDirectSpeakersTypeMetadata, id);
           }
           {
             std::lock_guard<std::mutex> lock(
                 latestMonitoringItemMetadataMutex_);
             setInMap<ConnId, ear::plugin::proto::MonitoringItemMetadata>(
-                latestMonitoringItemMetadata, item.connection_id(), item);
+                latestMonitoringItemMetadata, id, item);
           }
         }
-        activeDirectSpeakersIds.push_back(item.connection_id());
+        activeDirectSpeakersIds.push_back(id);
       }
 
       if (item.has_obj_metadata()) {
@@ -297,23 +299,25 @@ void BinauralMonitoringBackend::onSceneReceived(proto::SceneStore store) {
           {
             std::lock_guard<std::mutex> lock(latestObjectsTypeMetadataMutex_);
             removeFromMap<ConnId, ObjectsEarMetadataAndRouting>(
-                latestObjectsTypeMetadata, item.connection_id());
+                latestObjectsTypeMetadata, id);
           }
           {
             std::lock_guard<std::mutex> lock(
                 latestMonitoringItemMetadataMutex_);
             setInMap<ConnId, ear::plugin::proto::MonitoringItemMetadata>(
-                latestMonitoringItemMetadata, item.connection_id(), item);
+                latestMonitoringItemMetadata, id, item);
           }
         }
-        activeObjectIds.push_back(item.connection_id());
+        activeObjectIds.push_back(id);
       }
     }
   }
 
   allActiveIds.clear();
   for(const auto& item : store.monitoring_items()) {
-    allActiveIds.push_back(item.connection_id());
+    if(item.has_connection_id() && isValidId(item.connection_id())) {
+      allActiveIds.insert(ConnId{item.connection_id()});
+    }
   }
 
   objectChannelCount = totalObjChannels;
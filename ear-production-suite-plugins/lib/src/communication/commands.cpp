@@ -90,6 +90,7 @@ MessageBuffer serialize(const ConnectionDetailsResponse& msg) {
       proto::CmdConnectionDetailsResp::cmdConnectionDetailsResp);
   payload->set_connection_id(msg.connectionId().string());
   payload->set_metadata_endpoint(msg.metadataEndpoint());
+  payload->set_metadata_heartbeat(msg.metadataHeartbeat());
   return serialize(response);
 }
 
@@ -205,7 +206,8 @@ Response parseResponse(const void* data, int size) {
         proto::CmdConnectionDetailsResp::cmdConnectionDetailsResp);
     auto id = communication::ConnectionId{ext.connection_id()};
     auto endpoint = ext.metadata_endpoint();
-    auto payload = ConnectionDetailsResponse(id, endpoint);
+    auto payload =
+        ConnectionDetailsResponse(id, endpoint, ext.metadata_heartbeat());
     return Response(payload);
   }
   if (response.HasExtension(proto::CmdMonitoringConnectionDetailsResp::
@@ -18,8 +18,9 @@ void DirectSpeakersMetadataSender::logger(
 }
 
 void DirectSpeakersMetadataSender::connect(const std::string& endpoint,
-                                           ConnectionId id) {
-  sender_.connect(endpoint, id);
+                                           ConnectionId id,
+                                           ResendMode resendMode) {
+  sender_.connect(endpoint, id, resendMode);
 }
 
 void DirectSpeakersMetadataSender::disconnect() { sender_.disconnect(); }
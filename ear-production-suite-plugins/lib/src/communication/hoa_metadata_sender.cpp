@@ -14,8 +14,9 @@ void HoaMetadataSender::logger(std::shared_ptr<spdlog::logger> logger) {
   sender_.logger(std::move(logger));
 }
 
-void HoaMetadataSender::connect(const std::string& endpoint, ConnectionId id) {
-  sender_.connect(endpoint, id);
+void HoaMetadataSender::connect(const std::string& endpoint, ConnectionId id,
+                                ResendMode resendMode) {
+  sender_.connect(endpoint, id, resendMode);
 }
 
 void HoaMetadataSender::disconnect() { sender_.disconnect(); }
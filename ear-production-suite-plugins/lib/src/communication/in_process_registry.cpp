@@ -0,0 +1,239 @@
+#include "communication/in_process_registry.hpp"
+#include "communication/metadata_thread.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#ifdef WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace ear::plugin::communication {
+
+namespace {
+constexpr const char* REGISTRY_ENV_VAR = "EPS_IN_PROCESS_REGISTRY";
+constexpr uint32_t TABLE_LAYOUT_VERSION = 2;
+constexpr std::size_t MAX_ENDPOINT_LENGTH = 128;
+constexpr std::size_t MAX_RECEIVERS = 64;
+
+unsigned long long currentProcessId() {
+#ifdef WIN32
+  return static_cast<unsigned long long>(GetCurrentProcessId());
+#else
+  return static_cast<unsigned long long>(getpid());
+#endif
+}
+
+// Plugins linking the CRT statically each have their own copy of the C
+// runtime's environment, so on Windows the process environment block is used
+// directly.
+std::string getProcessEnvironmentVariable(const char* name) {
+#ifdef WIN32
+  char value[128];
+  auto length = GetEnvironmentVariableA(name, value, sizeof(value));
+  if (length == 0 || length >= sizeof(value)) {
+    return {};
+  }
+  return std::string(value, length);
+#else
+  auto value = std::getenv(name);
+  return value ? std::string(value) : std::string{};
+#endif
+}
+
+void setProcessEnvironmentVariable(const char* name, const char* value) {
+#ifdef WIN32
+  SetEnvironmentVariableA(name, value);
+#else
+  setenv(name, value, 1);
+#endif
+}
+}  // namespace
+
+std::string resendRequestEndpoint(const std::string& connectionId) {
+  return "eps-resend/" + connectionId;
+}
+
+// Shared between plugin binaries, so must stay plain data.
+// Bump TABLE_LAYOUT_VERSION when changing it.
+struct InProcessRegistry::Table {
+  struct Slot {
+    char endpoint[MAX_ENDPOINT_LENGTH];
+    void* context;
+    DeliverFunction deliver;
+    // Deliveries made from this slot since the table was unlocked
+    std::atomic<uint32_t> delivering;
+  };
+
+  std::atomic_flag busy = ATOMIC_FLAG_INIT;
+  Slot slots[MAX_RECEIVERS];
+
+  void lock() {
+    while (busy.test_and_set(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+  void unlock() { busy.clear(std::memory_order_release); }
+};
+
+InProcessRegistry::InProcessRegistry() : table_{nullptr} {
+  // Note: plugins are instantiated from the host's main thread, so there is
+  // no need to guard against two binaries creating a table concurrently.
+  // The process id guards against child processes inheriting the variable.
+  char tagBuffer[64];
+  std::snprintf(tagBuffer, sizeof(tagBuffer), "%u:%zu:%llu:",
+                TABLE_LAYOUT_VERSION, sizeof(Table), currentProcessId());
+  std::string const tag{tagBuffer};
+  auto existing = getProcessEnvironmentVariable(REGISTRY_ENV_VAR);
+  if (existing.compare(0, tag.size(), tag) == 0) {
+    unsigned long long address{0};
+    if (std::sscanf(existing.c_str() + tag.size(), "%llx", &address) == 1) {
+      table_ = reinterpret_cast<Table*>(static_cast<uintptr_t>(address));
+    }
+  }
+  if (!table_) {
+    // Deliberately leaked: plugin binaries may be unloaded in any order
+    table_ = new Table{};
+    char value[128];
+    std::snprintf(value, sizeof(value), "%s%llx", tag.c_str(),
+                  static_cast<unsigned long long>(
+                      reinterpret_cast<uintptr_t>(table_)));
+    setProcessEnvironmentVariable(REGISTRY_ENV_VAR, value);
+  }
+}
+
+InProcessRegistry& InProcessRegistry::instance() {
+  static InProcessRegistry registry;
+  return registry;
+}
+
+int InProcessRegistry::add(const std::string& endpoint, void* context,
+                           DeliverFunction deliver) {
+  if (endpoint.size() >= MAX_ENDPOINT_LENGTH || !deliver) {
+    return -1;
+  }
+  table_->lock();
+  int handle = -1;
+  for (std::size_t i = 0; i < MAX_RECEIVERS; ++i) {
+    auto& slot = table_->slots[i];
+    if (!slot.deliver) {
+      std::strncpy(slot.endpoint, endpoint.c_str(), MAX_ENDPOINT_LENGTH);
+      slot.context = context;
+      slot.deliver = deliver;
+      handle = static_cast<int>(i);
+      break;
+    }
+  }
+  table_->unlock();
+  return handle;
+}
+
+void InProcessRegistry::remove(int handle) {
+  if (handle < 0 || handle >= static_cast<int>(MAX_RECEIVERS)) {
+    return;
+  }
+  auto& slot = table_->slots[handle];
+  table_->lock();
+  slot.endpoint[0] = '\0';
+  slot.context = nullptr;
+  slot.deliver = nullptr;
+  table_->unlock();
+  // A publisher may still be delivering to the receiver it found earlier
+  while (slot.delivering.load(std::memory_order_acquire) != 0) {
+    std::this_thread::yield();
+  }
+}
+
+std::size_t InProcessRegistry::publish(const std::string& endpoint,
+                                       const void* data, std::size_t size) {
+  // Receivers copy what they are given, so they are called with the table
+  // unlocked, leaving it free for other publishers in the meantime
+  struct Delivery {
+    Table::Slot* slot;
+    void* context;
+    DeliverFunction deliver;
+  };
+  std::array<Delivery, MAX_RECEIVERS> deliveries;
+  std::size_t count{0};
+  table_->lock();
+  for (auto& slot : table_->slots) {
+    if (slot.deliver && endpoint == slot.endpoint) {
+      slot.delivering.fetch_add(1, std::memory_order_relaxed);
+      deliveries[count++] = {&slot, slot.context, slot.deliver};
+    }
+  }
+  table_->unlock();
+  for (std::size_t i = 0; i < count; ++i) {
+    deliveries[i].deliver(deliveries[i].context, data, size);
+    deliveries[i].slot->delivering.fetch_sub(1, std::memory_order_release);
+  }
+  return count;
+}
+
+bool InProcessRegistry::hasReceiver(const std::string& endpoint) {
+  bool found{false};
+  table_->lock();
+  for (auto const& slot : table_->slots) {
+    if (slot.deliver && endpoint == slot.endpoint) {
+      found = true;
+      break;
+    }
+  }
+  table_->unlock();
+  return found;
+}
+
+InProcessReceiver::InProcessReceiver() = default;
+
+InProcessReceiver::~InProcessReceiver() {
+  stop();
+  // joins the handler thread
+  thread_.reset();
+}
+
+bool InProcessReceiver::start(const std::string& endpoint, Handler handler) {
+  stop();
+  if (!thread_) {
+    thread_ = std::make_unique<MetadataThread>();
+    handler_ = std::move(handler);
+  } else {
+    // Deliveries from before stop() may still be queued, so the handler is
+    // swapped on the thread which calls it, ahead of any new deliveries
+    thread_->post([this, handler = std::move(handler)]() mutable {
+      handler_ = std::move(handler);
+    });
+  }
+  handle_ = InProcessRegistry::instance().add(endpoint, this,
+                                              &InProcessReceiver::deliver);
+  return handle_ >= 0;
+}
+
+void InProcessReceiver::stop() {
+  if (auto handle = handle_.exchange(-1); handle >= 0) {
+    InProcessRegistry::instance().remove(handle);
+  }
+}
+
+void InProcessReceiver::deliver(void* context, const void* data,
+                                std::size_t size) {
+  // Runs on the publisher's thread - copy and defer
+  auto receiver = static_cast<InProcessReceiver*>(context);
+  auto bytes = std::make_shared<std::vector<char>>(
+      static_cast<const char*>(data), static_cast<const char*>(data) + size);
+  receiver->thread_->post([receiver, bytes]() {
+    receiver->handler_(bytes->data(), bytes->size());
+  });
+}
+
+}  // namespace ear::plugin::communication
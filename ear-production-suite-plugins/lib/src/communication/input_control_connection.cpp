@@ -86,7 +86,10 @@ void InputControlConnection::handshake(ConnectionId const& id) {
       connected_ = true;
 
       if (connectedCallback_) {
-        connectedCallback_(connectionId_, streamEndpoint);
+        connectedCallback_(connectionId_, streamEndpoint,
+                           payload.metadataHeartbeat()
+                               ? ResendMode::HEARTBEAT
+                               : ResendMode::FULL_RESEND);
       } else {
           EAR_LOGGER_WARN(logger_, "Connected with {} but no callback provided", connectionId_.string());
       }
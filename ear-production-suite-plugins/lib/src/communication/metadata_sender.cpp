@@ -1,4 +1,5 @@
 #include "communication/metadata_sender.hpp"
+#include "communication/in_process_registry.hpp"
 namespace ear {
 namespace plugin {
 namespace communication {
@@ -9,9 +10,12 @@ MetadataSender::MetadataSender(
     : data_{data},
       logger_{std::move(logger)},
       maxSendInterval_{std::chrono::milliseconds(250)},
+      heartbeatInterval_{std::chrono::milliseconds(1000)},
+      resendMode_{ResendMode::FULL_RESEND},
       lastSendTimestamp_{std::chrono::system_clock::now()} {}
 
 MetadataSender::~MetadataSender() {
+  stopResendRequests();
   timer_.stop();
   timer_.wait();
 }
@@ -20,18 +24,24 @@ ConnectionId MetadataSender::connectionId() { return connectionId_; }
 
 void MetadataSender::disconnect() {
     EAR_LOGGER_TRACE(logger_, "Disconnecting from metadata endpoint");
+  stopResendRequests();
   timer_.cancel();
   timer_.wait();
   socket_.asyncCancel();
   socket_.asyncWait();
   dialer_.close();
   connectionId_ = ConnectionId{};
+  {
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    endpoint_.clear();
+  }
   socket_ = nng::PushSocket{};
 }
 
 void MetadataSender::triggerSend(bool force) {
   std::lock_guard<std::mutex> lock(sendMutex_);
-  if(force || data_.readAccess([](auto const& item) {
+  bool resendRequested = resendRequested_.exchange(false);
+  if(force || resendRequested || data_.readAccess([](auto const& item) {
      return item.changed();
   })) {
       socket_.asyncWait();
@@ -39,9 +49,14 @@ void MetadataSender::triggerSend(bool force) {
           return;
       }
       auto msg = data_.prepareMessage();
+      if (sendInProcess(msg)) {
+        data_.confirmSent();
+        return;
+      }
       socket_.asyncSend(
               msg, [this](std::error_code ec, const nng::Message &ignored) {
                   if (!ec) {
+                      data_.confirmSent();
                       std::lock_guard<std::mutex> lock(timeoutMutex_);
                       lastSendTimestamp_ = std::chrono::system_clock::now();
                   } else {
@@ -53,12 +68,65 @@ void MetadataSender::triggerSend(bool force) {
   }
 }
 
+void MetadataSender::sendHeartbeat() {
+  std::lock_guard<std::mutex> lock(sendMutex_);
+  socket_.asyncWait();
+  if (!connectionId_.isValid()) {
+    return;
+  }
+  auto msg = data_.prepareHeartbeat();
+  if (sendInProcess(msg)) {
+    return;
+  }
+  socket_.asyncSend(
+          msg, [this](std::error_code ec, const nng::Message &ignored) {
+              if (!ec) {
+                  std::lock_guard<std::mutex> lock(timeoutMutex_);
+                  lastSendTimestamp_ = std::chrono::system_clock::now();
+              } else {
+                  EAR_LOGGER_WARN(logger_, "Metadata heartbeat failed: {}", ec.message());
+              }
+          });
+}
+
+bool MetadataSender::sendInProcess(const MessageBuffer& msg) {
+  // Prefer handing over directly if the Scene lives in this process
+  if (InProcessRegistry::instance().publish(endpoint_, msg.data(),
+                                            msg.size()) == 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(timeoutMutex_);
+  lastSendTimestamp_ = std::chrono::system_clock::now();
+  return true;
+}
+
+void MetadataSender::requestFullResend() {
+  // Called from nng pipe callbacks, possibly while connect() holds the data
+  // lock, so only flag the request here and leave sending to triggerSend()
+  resendRequested_.store(true);
+}
+
+void MetadataSender::handleResendRequest(void* context, const void*,
+                                         std::size_t) {
+  // A Scene in this process missed our latest full metadata
+  static_cast<MetadataSender*>(context)->requestFullResend();
+}
+
+void MetadataSender::stopResendRequests() {
+  if (auto handle = resendRequestHandle_.exchange(-1); handle >= 0) {
+    InProcessRegistry::instance().remove(handle);
+  }
+}
+
 void MetadataSender::startTimer() {
   using namespace std::chrono_literals;
-  if (maxSendInterval_ > 0ms) {
+  auto interval = resendMode_.load() == ResendMode::FULL_RESEND
+                      ? maxSendInterval_
+                      : heartbeatInterval_;
+  if (interval > 0ms) {
     bool expected{false};
     if (timerRunning.compare_exchange_strong(expected, true)) {
-      timer_.sleep(maxSendInterval_ + 5ms,
+      timer_.sleep(interval + 5ms,
                    std::bind(&MetadataSender::handleTimeout, this,
                              nng::placeholders::ErrorCode));
     }
@@ -68,23 +136,55 @@ void MetadataSender::startTimer() {
 void MetadataSender::handleTimeout(std::error_code ec) {
   timerRunning.store(false);
   if (!ec) {
+    auto mode = resendMode_.load();
+    auto interval = mode == ResendMode::FULL_RESEND ? maxSendInterval_
+                                                    : heartbeatInterval_;
     auto now = std::chrono::system_clock::now();
     std::chrono::system_clock::duration deltaT{0};
     {
       std::lock_guard<std::mutex> lock(timeoutMutex_);
       deltaT = now - lastSendTimestamp_;
     }
-    if (deltaT > maxSendInterval_) {
-      triggerSend(true);
+    if (deltaT > interval) {
+      if (mode == ResendMode::FULL_RESEND) {
+        triggerSend(true);
+      } else if (resendRequested_.load() ||
+                 data_.readAccess(
+                     [](auto const& item) { return item.changed(); })) {
+        triggerSend();
+      } else {
+        sendHeartbeat();
+      }
     }
     startTimer();
   }
 }
+
 void MetadataSender::logger(std::shared_ptr<spdlog::logger> logger) {
   logger_ = std::move(logger);
 }
 
-void MetadataSender::connect(const std::string& endpoint, ConnectionId id) {
+void MetadataSender::registerPipeEvents() {
+  // A new pipe means the Scene (re)started listening and holds none of our
+  // metadata, or it dropped our previous pipe after detecting a gap.
+  socket_.onPipeEvent(nng::PipeEvent::postAdd,
+                      [this](nng::Pipe, nng::PipeEvent) {
+                        EAR_LOGGER_DEBUG(logger_, "Metadata pipe added, requesting full resend");
+                        requestFullResend();
+                      });
+}
+
+void MetadataSender::connect(const std::string& endpoint, ConnectionId id,
+                             ResendMode resendMode) {
+  {
+    std::lock_guard<std::mutex> lock(sendMutex_);
+    endpoint_ = endpoint;
+  }
+  resendMode_.store(resendMode);
+  stopResendRequests();
+  resendRequestHandle_ = InProcessRegistry::instance().add(
+      resendRequestEndpoint(id.string()), this,
+      &MetadataSender::handleResendRequest);
   data_.writeAccess([this, &id, &endpoint](auto data) {
     connectionId_ = id;
     data->set_connection_id(connectionId_.string());
@@ -92,6 +192,7 @@ void MetadataSender::connect(const std::string& endpoint, ConnectionId id) {
     // to the scene master when the connection has been established,
     // even if the data hasn't ""changed"" from the object input point of view.
     EAR_LOGGER_DEBUG(logger_, "Connecting metadata stream to {}", endpoint);
+    registerPipeEvents();
     dialer_ = socket_.createDialer(endpoint.c_str());
     dialer_.start();
     EAR_LOGGER_DEBUG(logger_, "Metadata stream connected", endpoint);
@@ -1,4 +1,6 @@
 #include "communication/monitoring_metadata_receiver.hpp"
+#include "communication/in_process_registry.hpp"
+#include "detail/constants.hpp"
 #include "scene_store.pb.h"
 #include <functional>
 
@@ -24,6 +26,17 @@ void MonitoringMetadataReceiver::start(const std::string& endpoint,
   // Subscribe to "all" (== "") notifications, without setting this option
   // _nothing_ will be received!
   handler_ = handler;
+  // A Scene in this process publishes to in-process receivers, so only fall
+  // back to the socket if it lives elsewhere (e.g. a bridged plugin)
+  if (InProcessRegistry::instance().hasReceiver(
+          detail::SCENE_MASTER_METADATA_ENDPOINT) &&
+      inProcessReceiver_.start(endpoint,
+                               [this](const void* data, std::size_t size) {
+                                 dispatch(data, size);
+                               })) {
+    EAR_LOGGER_INFO(logger_, "Receiving scene metadata in-process");
+    return;
+  }
   socket_.setOpt(nng::options::SubSubscribe, "", 0);
   socket_.dial(endpoint.c_str());
   waitForMetadata();
@@ -43,30 +56,14 @@ void MonitoringMetadataReceiver::shutdown() {
   // from wtihin the handler
   // Although tempting, don't try to use asyncWait() or asyncStop()
   // here, as this will block forever as well.
+  inProcessReceiver_.stop();
   socket_.asyncCancel();
 }
 
 void MonitoringMetadataReceiver::handleReceive(std::error_code ec,
                                                nng::Message message) {
   if (!ec) {
-    EAR_LOGGER_TRACE(logger_, "Received scene metadata");
-    try {
-      proto::SceneStore sceneStore;
-      if (message.size() > std::numeric_limits<int>::max()) {
-        throw std::runtime_error("Incoming message too large");
-      }
-      if (message.data() == nullptr) {
-        throw std::runtime_error(
-            "Failed to parse Scene Object: Invalid Buffer - null pointer");
-      }
-      if (!sceneStore.ParseFromArray(message.data(), message.size())) {
-        throw std::runtime_error("Failed to parse Scene Object");
-      }
-      handler_(std::move(sceneStore));
-    } catch (const std::runtime_error& e) {
-      EAR_LOGGER_ERROR(
-          logger_, "Failed to parse and dispatch scene metadata: {}", e.what());
-    }
+    dispatch(message.data(), message.size());
     waitForMetadata();
   } else if (ec.value() == NNG_ECANCELED) {
     EAR_LOGGER_INFO(logger_, "Operation cancelled, stopping stream receiver");
@@ -77,6 +74,27 @@ void MonitoringMetadataReceiver::handleReceive(std::error_code ec,
   }
 }
 
+void MonitoringMetadataReceiver::dispatch(const void* data, std::size_t size) {
+  EAR_LOGGER_TRACE(logger_, "Received scene metadata");
+  try {
+    proto::SceneStore sceneStore;
+    if (size > std::numeric_limits<int>::max()) {
+      throw std::runtime_error("Incoming message too large");
+    }
+    if (data == nullptr) {
+      throw std::runtime_error(
+          "Failed to parse Scene Object: Invalid Buffer - null pointer");
+    }
+    if (!sceneStore.ParseFromArray(data, static_cast<int>(size))) {
+      throw std::runtime_error("Failed to parse Scene Object");
+    }
+    handler_(std::move(sceneStore));
+  } catch (const std::runtime_error& e) {
+    EAR_LOGGER_ERROR(
+        logger_, "Failed to parse and dispatch scene metadata: {}", e.what());
+  }
+}
+
 }  // namespace communication
 }  // namespace plugin
 }  // namespace ear
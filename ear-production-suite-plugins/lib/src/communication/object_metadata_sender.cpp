@@ -20,8 +20,9 @@ void ObjectMetadataSender::logger(std::shared_ptr<spdlog::logger> logger) {
 }
 
 void ObjectMetadataSender::connect(const std::string& endpoint,
-                                   ConnectionId id) {
-  sender_.connect(endpoint, std::move(id));
+                                   ConnectionId id,
+                                   ResendMode resendMode) {
+  sender_.connect(endpoint, std::move(id), resendMode);
 }
 
 void ObjectMetadataSender::disconnect() {
@@ -8,6 +8,14 @@ namespace ear {
 namespace plugin {
 namespace communication {
 
+namespace {
+#ifdef EPS_LEGACY_METADATA_RESEND
+constexpr bool acceptMetadataHeartbeats = false;
+#else
+constexpr bool acceptMetadataHeartbeats = true;
+#endif
+}
+
 struct SceneConnectionManager::RequestDispatcher
     : public boost::static_visitor<communication::Response> {
   RequestDispatcher(SceneConnectionManager* manager) : manager_(manager) {}
@@ -69,7 +77,8 @@ communication::ConnectionDetailsResponse SceneConnectionManager::doHandle(
   inputConnections_.get(message.connectionId()).state = Connection::ACTIVE;
   notify(Event::INPUT_ADDED, message.connectionId());
   return communication::ConnectionDetailsResponse(
-      message.connectionId(), detail::SCENE_MASTER_METADATA_ENDPOINT);
+      message.connectionId(), detail::SCENE_MASTER_METADATA_ENDPOINT,
+      acceptMetadataHeartbeats);
 }
 
 communication::MonitoringConnectionDetailsResponse
@@ -12,7 +12,10 @@ SceneMetadataReceiver::SceneMetadataReceiver(
     std::shared_ptr<spdlog::logger> logger)
     : logger_(logger) {}
 
-SceneMetadataReceiver::~SceneMetadataReceiver() { socket_.asyncStop(); }
+SceneMetadataReceiver::~SceneMetadataReceiver() {
+  inProcessReceiver_.stop();
+  socket_.asyncStop();
+}
 
 void SceneMetadataReceiver::run(const std::string& endpoint,
                                 const RequestHandler& handler) {
@@ -20,6 +23,12 @@ void SceneMetadataReceiver::run(const std::string& endpoint,
   EAR_LOGGER_INFO(logger_, "Listening for metatdata on {}", endpoint);
   socket_.listen(endpoint.c_str());
   waitForMetadata();
+  if (!inProcessReceiver_.start(endpoint, [this](const void* data,
+                                                 std::size_t size) {
+        dispatch(data, size, std::nullopt);
+      })) {
+    EAR_LOGGER_WARN(logger_, "In-process metadata receiver unavailable");
+  }
 }
 
 void SceneMetadataReceiver::checkEndpoint(const std::string& endpoint) {
@@ -39,21 +48,72 @@ void SceneMetadataReceiver::handleReceive(std::error_code ec,
     return;  // stop receiving ... todo: check: maybe there are some error
              // conditions that allow us to keep going
   }
+  dispatch(message.data(), message.size(), message.pipe());
+  waitForMetadata();
+}
+
+void SceneMetadataReceiver::dispatch(const void* data, std::size_t size,
+                                     std::optional<nng::Pipe> pipe) {
   try {
     proto::InputItemMetadata inputItem;
-    if (message.size() > std::numeric_limits<int>::max()) {
+    if (size > std::numeric_limits<int>::max()) {
       throw std::runtime_error("Incoming message too large");
     }
-    if (!inputItem.ParseFromArray(message.data(),
-                                  static_cast<int>(message.size()))) {
+    if (!inputItem.ParseFromArray(data, static_cast<int>(size))) {
       throw std::runtime_error("Failed to parse Scene Store Metadata");
     }
-    handler_(inputItem.connection_id(), inputItem);
+    if (inputItem.heartbeat()) {
+      handleHeartbeat(inputItem, pipe);
+    } else {
+      {
+        std::lock_guard<std::mutex> lock(continuityMutex_);
+        lastContinuityCounter_[inputItem.connection_id()] =
+            inputItem.continuity_counter();
+      }
+      handler_(inputItem.connection_id(), inputItem);
+    }
   } catch (const std::runtime_error& e) {
     EAR_LOGGER_ERROR(logger_, "Failed to parse and dispatch metadata: {}",
                      e.what());
   }
-  waitForMetadata();
+}
+
+void SceneMetadataReceiver::handleHeartbeat(
+    const proto::InputItemMetadata& heartbeat, std::optional<nng::Pipe> pipe) {
+  ConnectionId id{heartbeat.connection_id()};
+  {
+    std::lock_guard<std::mutex> lock(continuityMutex_);
+    auto it = lastContinuityCounter_.find(id);
+    if (it != lastContinuityCounter_.end() &&
+        it->second == heartbeat.continuity_counter()) {
+      return;
+    }
+  }
+  // We have missed the latest full metadata from this input. There is no
+  // return channel on a push/pull pair, so close the pipe: the sender redials
+  // and resends its full metadata when the new pipe is added.
+  // In-process, there is no pipe, so the request is published to the sender.
+  EAR_LOGGER_WARN(logger_,
+                  "Continuity gap for connection {}, requesting full resend",
+                  id.string());
+  if (!pipe) {
+    if (InProcessRegistry::instance().publish(
+            resendRequestEndpoint(id.string()), nullptr, 0) == 0) {
+      EAR_LOGGER_WARN(logger_, "No in-process sender for connection {}",
+                      id.string());
+    }
+    return;
+  }
+  try {
+    pipe->close();
+  } catch (const std::runtime_error& e) {
+    EAR_LOGGER_ERROR(logger_, "Failed to close metadata pipe: {}", e.what());
+  }
+}
+
+void SceneMetadataReceiver::removeConnection(const ConnectionId& id) {
+  std::lock_guard<std::mutex> lock(continuityMutex_);
+  lastContinuityCounter_.erase(id);
 }
 
 }  // namespace communication
@@ -8,6 +8,7 @@
 
 using std::placeholders::_1;
 using std::placeholders::_2;
+using std::placeholders::_3;
 
 namespace ear {
 namespace plugin {
@@ -30,7 +31,7 @@ DirectSpeakersBackend::DirectSpeakersBackend(
         std::bind(&DirectSpeakersBackend::onParameterChanged, this, _1, _2));
   }
   controlConnection_.onConnectionEstablished(
-      std::bind(&DirectSpeakersBackend::onConnection, this, _1, _2));
+      std::bind(&DirectSpeakersBackend::onConnection, this, _1, _2, _3));
   controlConnection_.onConnectionLost(
       std::bind(&DirectSpeakersBackend::onConnectionLost, this));
   controlConnection_.start(detail::SCENE_MASTER_CONTROL_ENDPOINT);
@@ -58,13 +59,15 @@ void DirectSpeakersBackend::triggerMetadataSend() {
 
 void DirectSpeakersBackend::onConnection(
     communication::ConnectionId connectionId,
-    const std::string& streamEndpoint) {
+    const std::string& streamEndpoint,
+    communication::ResendMode resendMode) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (connector_) {
     connector_->setStatusBarText("Ready: Connected to Scene");
   }
   metadataSender_.connect(streamEndpoint,
-                          communication::ConnectionId{connectionId});
+                          communication::ConnectionId{connectionId},
+                          resendMode);
 }
 void DirectSpeakersBackend::onConnectionLost() {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -6,6 +6,7 @@
 
 using std::placeholders::_1;
 using std::placeholders::_2;
+using std::placeholders::_3;
 
 namespace ear {
 namespace plugin {
@@ -27,7 +28,7 @@ HoaBackend::HoaBackend(ui::HoaFrontendBackendConnector* connector)
         std::bind(&HoaBackend::onParameterChanged, this, _1, _2));
   }
   controlConnection_.onConnectionEstablished(
-      std::bind(&HoaBackend::onConnection, this, _1, _2));
+      std::bind(&HoaBackend::onConnection, this, _1, _2, _3));
   controlConnection_.onConnectionLost(
       std::bind(&HoaBackend::onConnectionLost, this));
   controlConnection_.start(detail::SCENE_MASTER_CONTROL_ENDPOINT);
@@ -52,13 +53,15 @@ void HoaBackend::setConnectionId(communication::ConnectionId id) {
 void HoaBackend::triggerMetadataSend() { metadataSender_.triggerSend(); }
 
 void HoaBackend::onConnection(communication::ConnectionId connectionId,
-                              const std::string& streamEndpoint) {
+                              const std::string& streamEndpoint,
+                              communication::ResendMode resendMode) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (connector_) {
     connector_->setStatusBarText("Ready: Connected to Scene");
   }
   metadataSender_.connect(streamEndpoint,
-                          communication::ConnectionId{connectionId});
+                          communication::ConnectionId{connectionId},
+                          resendMode);
 }
 void HoaBackend::onConnectionLost() {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -6,6 +6,7 @@
 
 using std::placeholders::_1;
 using std::placeholders::_2;
+using std::placeholders::_3;
 
 namespace ear {
 namespace plugin {
@@ -29,7 +30,7 @@ ObjectBackend::ObjectBackend(ui::ObjectsFrontendBackendConnector* connector)
         std::bind(&ObjectBackend::onParameterChanged, this, _1, _2));
   }
   controlConnection_.onConnectionEstablished(
-      std::bind(&ObjectBackend::onConnection, this, _1, _2));
+      std::bind(&ObjectBackend::onConnection, this, _1, _2, _3));
   controlConnection_.onConnectionLost(
       std::bind(&ObjectBackend::onConnectionLost, this));
   controlConnection_.start(detail::SCENE_MASTER_CONTROL_ENDPOINT);
@@ -55,13 +56,15 @@ void ObjectBackend::setConnectionId(communication::ConnectionId id) {
 void ObjectBackend::triggerMetadataSend() { metadataSender_.triggerSend(); }
 
 void ObjectBackend::onConnection(communication::ConnectionId connectionId,
-                                 const std::string& streamEndpoint) {
+                                 const std::string& streamEndpoint,
+                                 communication::ResendMode resendMode) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (connector_) {
     connector_->setStatusBarText("Ready: Connected to Scene");
   }
   metadataSender_.connect(streamEndpoint,
-                          communication::ConnectionId{connectionId});
+                          communication::ConnectionId{connectionId},
+                          resendMode);
 }
 void ObjectBackend::onConnectionLost() {
   std::lock_guard<std::mutex> lock(mutex_);
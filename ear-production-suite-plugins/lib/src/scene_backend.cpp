@@ -1,4 +1,5 @@
 #include "scene_backend.hpp"
+#include "communication/in_process_registry.hpp"
 #include "detail/constants.hpp"
 #include <functional>
 #include <memory>
@@ -33,6 +34,10 @@ void SceneBackend::triggerMetadataSend(const proto::SceneStore &store) {
     communication::MessageBuffer buffer =
             communication::allocBuffer(store.ByteSizeLong());
     store.SerializeToArray(buffer.data(), buffer.size());
+    // Monitoring plugins in this process receive directly, others via socket
+    communication::InProcessRegistry::instance().publish(
+            detail::SCENE_MASTER_SCENE_STREAM_ENDPOINT, buffer.data(),
+            buffer.size());
     metadataSender_.asyncWait();
     metadataSender_.asyncSend(
             buffer, [this](std::error_code ec, const nng::Message&) {
@@ -115,6 +120,7 @@ void SceneBackend::onConnectionEvent(
   } else if (event ==
              communication::SceneConnectionManager::Event::INPUT_REMOVED) {
     EAR_LOGGER_INFO(logger_, "Input {} disconnected", id.string());
+      metadataReceiver_.removeConnection(id);
       data_.removeInput(id);
   } else if (event ==
              communication::SceneConnectionManager::Event::MONITORING_ADDED) {
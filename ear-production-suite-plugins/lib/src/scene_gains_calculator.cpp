@@ -4,6 +4,7 @@
 #include "helper/container_helpers.hpp"
 #include <future>
 #include <algorithm>
+#include <unordered_set>
 
 
 namespace {
@@ -40,15 +41,15 @@ bool SceneGainsCalculator::update(proto::SceneStore store) {
   auto future = std::async(std::launch::async, [this, store]() {
 
     // First figure out what we need to process updates for
-    std::vector<communication::ConnectionId> cachedIdsChecklist;
+    std::unordered_set<communication::ConnectionId> cachedIdsChecklist;
     cachedIdsChecklist.reserve(routingCache_.size());
     for(auto const&[key, val] : routingCache_) {
-      cachedIdsChecklist.push_back(key);
+      cachedIdsChecklist.insert(key);
     }
     /// Check-off found items, and also zero original gains for changed items and delete from routing cache to be re-evaluated
     for(const auto& item : store.monitoring_items()) {
       auto itemId = communication::ConnectionId{ item.connection_id() };
-      cachedIdsChecklist.erase(std::remove(cachedIdsChecklist.begin(), cachedIdsChecklist.end(), itemId), cachedIdsChecklist.end());
+      cachedIdsChecklist.erase(itemId);
       if(item.changed()) {
         removeItem(itemId);
       }
@@ -148,8 +148,8 @@ void ear::plugin::SceneStore::inputAdded(const InputItem & item, bool autoModeSt
 }
 
 void SceneStore::addAvailableInputItemsToSceneStore(const ear::plugin::ItemMap& items) {
-    for (auto const& itemPair : items) {
-        auto& itemStoreInputItem = itemPair.second;
+    for (auto const* itemPair : sortedById(items)) {
+        auto& itemStoreInputItem = itemPair->second;
         auto sceneStoreInputItem = store_.add_all_available_items();
         sceneStoreInputItem->CopyFrom(itemStoreInputItem);
         itemsChangedSinceLastSend.insert(itemStoreInputItem.connection_id());
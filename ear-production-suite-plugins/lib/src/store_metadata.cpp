@@ -374,11 +374,12 @@ void Metadata::doChangeInputItem(
 
 RouteMap Metadata::routeMap() const {
     RouteMap routes;
-    std::transform(itemStore_.cbegin(), itemStore_.cend(),
-                   std::inserter(routes, routes.begin()),
-                   [](auto const& idItemPair) {
-                       return std::make_pair(idItemPair.second.routing(),
-                                             idItemPair.first);
+    auto const items = sortedById(itemStore_);
+    std::transform(items.cbegin(), items.cend(),
+                   std::inserter(routes, routes.end()),
+                   [](auto const* idItemPair) {
+                       return std::make_pair(idItemPair->second.routing(),
+                                             idItemPair->first);
                    });
     return routes;
 }
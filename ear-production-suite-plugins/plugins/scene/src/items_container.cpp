@@ -194,11 +194,9 @@ void ItemsContainer::createOrUpdateView(proto::InputItemMetadata const& item) {
     }
 }
 
-void ItemsContainer::createOrUpdateViews(
-    const std::map<communication::ConnectionId, proto::InputItemMetadata>&
-    allItems) {
-  for (auto const& entry : allItems) {
-      createOrUpdateView(entry.second);
+void ItemsContainer::createOrUpdateViews(const ItemMap& allItems) {
+  for (auto const* entry : sortedById(allItems)) {
+      createOrUpdateView(entry->second);
   }
 }
 
@@ -58,7 +58,7 @@ SceneAudioProcessor::SceneAudioProcessor()
 }
 
 SceneAudioProcessor::~SceneAudioProcessor() {
-  sendSamplesToExtension = false;
+  samplesStream.stop();
   backend_.reset();
   commandSocket->close();
   delete commandSocket;
@@ -112,6 +112,11 @@ void SceneAudioProcessor::prepareToPlay(double sampleRate,
                                         int samplesPerBlock) {
   backend_->triggerMetadataSend();
   doSampleRateChecks();
+  if (!samplesStream.isStreaming()) {
+    prepareSamplesRing(samplesPerBlock);
+    samplesMsgPool.prepare(static_cast<size_t>(samplesPerBlock) * 64 *
+                           sizeof(float));
+  }
 }
 
 void SceneAudioProcessor::releaseResources() {}
@@ -140,43 +145,53 @@ void SceneAudioProcessor::processBlock(AudioBuffer<float>& buffer,
   });
   doSampleRateChecks();
 
-  if(!sendSamplesToExtension) {
+  if(!samplesStream.beginBlock()) {
     if(getActiveEditor()) {
       levelMeter_->process(buffer);
     }
   } else {
-    size_t sampleSize = sizeof(float);
-    uint8_t numChannels = 64;
-    size_t msg_size = buffer.getNumSamples() * numChannels * sampleSize;
-
-    auto msg = std::make_shared<NngMsg>(msg_size);
-
-    char* msgPosPtr = (char*)msg->getBufferPointer();
-    int msgPosOffset = 0;
-    float curSample = 0.0;
-
-    int bufferChannels = buffer.getNumChannels();
-    int bufferSamplesPerChannel = buffer.getNumSamples();
-
-    for (int sample = 0; sample < bufferSamplesPerChannel; ++sample) {
-      for (int channel = 0; channel < numChannels; ++channel) {
-        curSample = buffer.getSample(channel, sample);
-        assert(msgPosOffset + sampleSize <= msg_size);
-        memcpy(msgPosPtr + msgPosOffset, &curSample, sampleSize);
-        msgPosOffset += sampleSize;
-      }
-    }
-
-    auto resSend = samplesSocket->sendBlock(msg, 0);
-    assert(resSend == 0);
-    if (resSend != 0) {
+    bool sent = sendSamples(buffer);
+    samplesStream.endBlock();
+    if (!sent) {
       // TODO: Log this error somewhere - this means we can't send our samples
       stopExport();
-      return;
     }
   }
 }
 
+bool SceneAudioProcessor::sendSamples(const AudioBuffer<float>& buffer) {
+  auto numChannels = static_cast<uint32_t>(exportChannels.size());
+  for (uint32_t i = 0; i < numChannels; ++i) {
+    exportChannelPointers[i] = buffer.getReadPointer(exportChannels[i]);
+  }
+  auto numSamples = static_cast<uint32_t>(buffer.getNumSamples());
+
+  if (sendSamplesViaRing) {
+    // Never waits on the audio thread. The ring holds many blocks, so the
+    // extension has fallen a long way behind if this one does not fit - it is
+    // dropped whole, keeping the ring frame aligned, and counted so the
+    // extension can report it.
+    if (samplesRing->writableFrames() < numSamples) {
+      samplesRing->countDroppedFrames(numSamples);
+      return true;
+    }
+    return samplesRing->writeFrames(exportChannelPointers.data(), numChannels,
+                                    numSamples, 0);
+  }
+
+  auto msg = samplesMsgPool.acquire(static_cast<size_t>(numSamples) *
+                                    numChannels * sizeof(float));
+  if (!msg) {
+    return false;
+  }
+  interleaveBlock(exportChannelPointers.data(), numChannels, 0, numSamples,
+                  static_cast<float*>(nng_msg_body(msg)), numChannels);
+
+  auto resSend = samplesSocket->sendBlock(msg, 0);
+  assert(resSend == 0);
+  return resSend == 0;
+}
+
 bool SceneAudioProcessor::hasEditor() const {
   return true;  // (change this to false if you choose to not supply an editor)
 }
@@ -252,6 +267,7 @@ void SceneAudioProcessor::incomingMessage(std::shared_ptr<NngMsg> msg) {
 
   } else if (cmd == commandSocket->Command::StopRender) {
     stopExport();
+    sendEndOfStream();
     commandSocket->sendResp(cmd);
 
   } else if (cmd == commandSocket->Command::GetAdmAndMappings) {
@@ -264,6 +280,10 @@ void SceneAudioProcessor::incomingMessage(std::shared_ptr<NngMsg> msg) {
     uint32_t sampleRate = samplerate_;
     commandSocket->sendInfo(numChannels, samplerate_);
 
+  } else if (cmd == commandSocket->Command::SetChannelMask) {
+    requestedChannelMask = commandSocket->decodeChannelMaskMessage(msg);
+    commandSocket->sendResp(commandSocket->Command::SetChannelMaskResp);
+
   } else if (cmd == commandSocket->Command::SetAdmAndMappings) {
     std::vector<PluginToAdmMap> pluginToAdmMaps;
     std::string admStr;
@@ -298,10 +318,57 @@ ear::plugin::Metadata &SceneAudioProcessor::metadata() {
 
 void SceneAudioProcessor::startExport() {
     metadata_.setExporting(true);
-    sendSamplesToExtension = true;
+    // Only stream the channels which make it into the BW64
+    uint64_t mask = requestedChannelMask.exchange(CommandCommon::ALL_CHANNELS_MASK);
+    exportChannels.clear();
+    for (int channel = 0; channel < 64; ++channel) {
+      if (mask & (uint64_t{1} << channel)) {
+        exportChannels.push_back(channel);
+      }
+    }
+    {
+      // The extension attaches to the ring before requesting a render,
+      // otherwise it is an older extension reading the samples socket
+      std::lock_guard<std::mutex> lock(samplesRingMutex);
+      sendSamplesViaRing = samplesRing && samplesRing->readerAttached();
+      if (sendSamplesViaRing) {
+        samplesRing->reset(static_cast<uint32_t>(exportChannels.size()));
+      }
+    }
+    if (!sendSamplesViaRing) {
+      samplesMsgPool.start();
+    }
+    samplesStream.start();
 }
 
 void SceneAudioProcessor::stopExport() {
     metadata_.setExporting(false);
-    sendSamplesToExtension = false;
+    samplesStream.stop();
+    samplesMsgPool.stop();
 };
+
+void SceneAudioProcessor::sendEndOfStream() {
+  // Must follow the last block, which may still be in flight on the audio thread
+  samplesStream.waitForBlockInProgress();
+  if (sendSamplesViaRing) {
+    std::lock_guard<std::mutex> lock(samplesRingMutex);
+    if (samplesRing) {
+      samplesRing->markEndOfStream();
+    }
+  } else {
+    samplesSocket->sendEndOfStream();
+  }
+}
+
+void SceneAudioProcessor::prepareSamplesRing(int samplesPerBlock) {
+  std::lock_guard<std::mutex> lock(samplesRingMutex);
+  auto port = samplesSocket->getPort();
+  auto required = static_cast<uint32_t>(samplesPerBlock) *
+                  SharedSamplesRing::BLOCKS_OF_HEADROOM;
+  if (port == NNG_PORT_UNKNOWN || samplesPerBlock <= 0 ||
+      (samplesRing && samplesRing->getCapacityFrames() >= required)) {
+    return;
+  }
+  samplesRing.reset();
+  samplesRing = SharedSamplesRing::create(port, 64, samplesPerBlock);
+}
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <vector>
 #include "JuceHeader.h"
 #include "helper/nng_wrappers.h"
+#include "helper/shared_samples_ring.h"
 #include "store_metadata.hpp"
 #include "components/read_only_audio_parameter_int.hpp"
 #include "components/level_meter_calculator.hpp"
@@ -70,6 +75,9 @@ class SceneAudioProcessor : public AudioProcessor {
   void recvAdmMetadata(std::string admStr, std::vector<PluginToAdmMap> pluginToAdmMaps);
   void startExport();
   void stopExport();
+  bool sendSamples(const AudioBuffer<float>& buffer);
+  void sendEndOfStream();
+  void prepareSamplesRing(int samplesPerBlock);
   ear::plugin::MetadataThread metadataThread_;
   std::unique_ptr<ear::plugin::SceneBackend> backend_;
   ear::plugin::Metadata metadata_;
@@ -81,7 +89,15 @@ class SceneAudioProcessor : public AudioProcessor {
   ReadOnlyAudioParameterInt* samplesPort;
   CommandReceiver* commandSocket;
   SamplesSender* samplesSocket;
-  bool sendSamplesToExtension{false};
+  SamplesMsgPool samplesMsgPool;
+  SamplesStreamState samplesStream;
+  // Requested by the extension before each render, see CommandCommon::SetChannelMask
+  std::atomic<uint64_t> requestedChannelMask{CommandCommon::ALL_CHANNELS_MASK};
+  std::vector<int> exportChannels;
+  std::array<const float*, 64> exportChannelPointers{};
+  std::mutex samplesRingMutex;
+  std::unique_ptr<SharedSamplesRing> samplesRing;
+  bool sendSamplesViaRing{false};
   uint32_t samplerate_{0};
 
   std::shared_ptr<ear::plugin::LevelMeterCalculator> levelMeter_;
@@ -1,5 +1,6 @@
 #include <catch2/catch_all.hpp>
 #include "communication/common_types.hpp"
+#include <unordered_set>
 
 TEST_CASE("connection id") {
   using namespace ear::plugin::communication;
@@ -7,3 +8,15 @@ TEST_CASE("connection id") {
   REQUIRE(id.string() == "00000000-0000-0000-0000-000000000000");
   ConnectionId idFromString("00000000-0000-0000-0000-000000000000");
 }
+
+TEST_CASE("connection id hash") {
+  using namespace ear::plugin::communication;
+  auto id = ConnectionId::generate();
+  ConnectionId sameId(id.string());
+  REQUIRE(std::hash<ConnectionId>{}(id) == std::hash<ConnectionId>{}(sameId));
+
+  std::unordered_set<ConnectionId> ids{id, ConnectionId::generate(), ConnectionId{}};
+  REQUIRE(ids.size() == 3);
+  REQUIRE(ids.count(sameId) == 1);
+  REQUIRE(ids.count(ConnectionId::generate()) == 0);
+}
@@ -0,0 +1,116 @@
+#include <catch2/catch_all.hpp>
+#include "communication/in_process_registry.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ear::plugin::communication;
+using namespace std::chrono_literals;
+
+namespace {
+struct Collector {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<std::string> messages;
+
+  InProcessReceiver::Handler handler() {
+    return [this](const void* data, std::size_t size) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        messages.emplace_back(static_cast<const char*>(data), size);
+      }
+      cv.notify_all();
+    };
+  }
+
+  bool waitFor(std::size_t count) {
+    std::unique_lock<std::mutex> lock(mutex);
+    return cv.wait_for(lock, 1s, [&] { return messages.size() >= count; });
+  }
+};
+}  // namespace
+
+TEST_CASE("in-process publish without receiver") {
+  auto& registry = InProcessRegistry::instance();
+  std::string const payload{"nobody listening"};
+  REQUIRE_FALSE(registry.hasReceiver("inproc-test-none"));
+  REQUIRE(registry.publish("inproc-test-none", payload.data(),
+                           payload.size()) == 0);
+}
+
+TEST_CASE("in-process publish reaches all receivers of an endpoint") {
+  auto& registry = InProcessRegistry::instance();
+  Collector first, second, other;
+  InProcessReceiver firstReceiver, secondReceiver, otherReceiver;
+  REQUIRE(firstReceiver.start("inproc-test-a", first.handler()));
+  REQUIRE(secondReceiver.start("inproc-test-a", second.handler()));
+  REQUIRE(otherReceiver.start("inproc-test-b", other.handler()));
+  REQUIRE(registry.hasReceiver("inproc-test-a"));
+
+  std::string const payload{"metadata"};
+  REQUIRE(registry.publish("inproc-test-a", payload.data(), payload.size()) ==
+          2);
+  REQUIRE(first.waitFor(1));
+  REQUIRE(second.waitFor(1));
+  REQUIRE(first.messages.front() == payload);
+  REQUIRE(other.messages.empty());
+
+  secondReceiver.stop();
+  REQUIRE(registry.publish("inproc-test-a", payload.data(), payload.size()) ==
+          1);
+}
+
+TEST_CASE("in-process receivers unregister on destruction") {
+  auto& registry = InProcessRegistry::instance();
+  {
+    Collector collector;
+    InProcessReceiver receiver;
+    REQUIRE(receiver.start("inproc-test-c", collector.handler()));
+    REQUIRE(registry.hasReceiver("inproc-test-c"));
+  }
+  REQUIRE_FALSE(registry.hasReceiver("inproc-test-c"));
+}
+
+TEST_CASE("in-process receivers are called with the registry unlocked") {
+  auto& registry = InProcessRegistry::instance();
+  struct Context {
+    InProcessRegistry* registry;
+    bool sawOtherEndpoint{false};
+  } context{&registry};
+  Collector other;
+  InProcessReceiver otherReceiver;
+  REQUIRE(otherReceiver.start("inproc-test-e", other.handler()));
+
+  // Would deadlock if the table were still locked
+  auto handle = registry.add(
+      "inproc-test-d", &context,
+      [](void* context, const void*, std::size_t) {
+        auto c = static_cast<Context*>(context);
+        c->sawOtherEndpoint = c->registry->hasReceiver("inproc-test-e");
+      });
+  REQUIRE(handle >= 0);
+  REQUIRE(registry.publish("inproc-test-d", nullptr, 0) == 1);
+  REQUIRE(context.sawOtherEndpoint);
+  registry.remove(handle);
+  REQUIRE_FALSE(registry.hasReceiver("inproc-test-d"));
+}
+
+TEST_CASE("in-process receiver restarted with another handler") {
+  auto& registry = InProcessRegistry::instance();
+  Collector first, second;
+  InProcessReceiver receiver;
+  REQUIRE(receiver.start("inproc-test-f", first.handler()));
+  std::string const before{"before"};
+  REQUIRE(registry.publish("inproc-test-f", before.data(), before.size()) == 1);
+
+  REQUIRE(receiver.start("inproc-test-f", second.handler()));
+  std::string const after{"after"};
+  REQUIRE(registry.publish("inproc-test-f", after.data(), after.size()) == 1);
+  REQUIRE(first.waitFor(1));
+  REQUIRE(second.waitFor(1));
+  REQUIRE(first.messages == std::vector<std::string>{before});
+  REQUIRE(second.messages == std::vector<std::string>{after});
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_all.hpp>
 #include "communication/commands.hpp"
+#include "communication/data_wrapper.hpp"
 
 TEST_CASE("NewConnectionMessage encoding/decoding") {
   SECTION("with default/invalid connection id") {
@@ -85,6 +86,20 @@ TEST_CASE("ConnectionDetailsResponse encoding/decoding") {
       resp.payloadAs<ear::plugin::communication::ConnectionDetailsResponse>();
   REQUIRE(received_msg.metadataEndpoint() ==
           "SomeString that describes an endpoint");
+  REQUIRE_FALSE(received_msg.metadataHeartbeat());
+}
+
+TEST_CASE("ConnectionDetailsResponse encodes whether heartbeats are accepted") {
+  auto id = ear::plugin::communication::ConnectionId::generate();
+  ear::plugin::communication::ConnectionDetailsResponse msg{
+      id, "SomeString that describes an endpoint", true};
+  auto buffer = ear::plugin::communication::serialize(msg);
+
+  auto resp = ear::plugin::communication::parseResponse(buffer);
+  REQUIRE(resp.errorCode() == ear::plugin::communication::ErrorCode::NO_ERROR);
+  auto received_msg =
+      resp.payloadAs<ear::plugin::communication::ConnectionDetailsResponse>();
+  REQUIRE(received_msg.metadataHeartbeat());
 }
 
 TEST_CASE("MonitoringConnectionDetails encoding/decoding") {
@@ -122,3 +137,61 @@ TEST_CASE("ErrorResponse encoding/decoding") {
   REQUIRE(resp.errorDescription() == "some message");
   REQUIRE_THROWS(resp.payload());
 }
+
+TEST_CASE("DataWrapper heartbeat carries continuity of last full message") {
+  using namespace ear::plugin;
+  auto id = communication::ConnectionId::generate();
+  communication::DataWrapper data([&id](proto::InputItemMetadata* item) {
+    item->set_connection_id(id.string());
+    item->set_name("item");
+  });
+
+  auto full = data.prepareMessage();
+  data.confirmSent();
+  proto::InputItemMetadata fullItem;
+  REQUIRE(fullItem.ParseFromArray(full.data(), static_cast<int>(full.size())));
+  REQUIRE_FALSE(fullItem.heartbeat());
+
+  auto beat = data.prepareHeartbeat();
+  proto::InputItemMetadata beatItem;
+  REQUIRE(beatItem.ParseFromArray(beat.data(), static_cast<int>(beat.size())));
+  REQUIRE(beatItem.heartbeat());
+  REQUIRE(beatItem.connection_id() == id.string());
+  REQUIRE(beatItem.continuity_counter() == fullItem.continuity_counter());
+  REQUIRE_FALSE(beatItem.has_name());
+  REQUIRE(beat.size() < full.size());
+
+  data.prepareMessage();
+  data.confirmSent();
+  beat = data.prepareHeartbeat();
+  REQUIRE(beatItem.ParseFromArray(beat.data(), static_cast<int>(beat.size())));
+  REQUIRE(beatItem.continuity_counter() == fullItem.continuity_counter() + 1);
+}
+
+TEST_CASE("DataWrapper continuity counter only advances on confirmed sends") {
+  using namespace ear::plugin;
+  communication::DataWrapper data([](proto::InputItemMetadata* item) {
+    item->set_connection_id(communication::ConnectionId::generate().string());
+  });
+
+  auto failed = data.prepareMessage();
+  proto::InputItemMetadata failedItem;
+  REQUIRE(failedItem.ParseFromArray(failed.data(),
+                                    static_cast<int>(failed.size())));
+
+  auto beat = data.prepareHeartbeat();
+  proto::InputItemMetadata beatItem;
+  REQUIRE(beatItem.ParseFromArray(beat.data(), static_cast<int>(beat.size())));
+  REQUIRE(beatItem.continuity_counter() == failedItem.continuity_counter() - 1);
+
+  auto retry = data.prepareMessage();
+  proto::InputItemMetadata retryItem;
+  REQUIRE(retryItem.ParseFromArray(retry.data(),
+                                   static_cast<int>(retry.size())));
+  REQUIRE(retryItem.continuity_counter() == failedItem.continuity_counter());
+
+  data.confirmSent();
+  beat = data.prepareHeartbeat();
+  REQUIRE(beatItem.ParseFromArray(beat.data(), static_cast<int>(beat.size())));
+  REQUIRE(beatItem.continuity_counter() == retryItem.continuity_counter());
+}
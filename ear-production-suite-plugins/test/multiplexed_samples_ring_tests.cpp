@@ -0,0 +1,96 @@
+#include <catch2/catch_all.hpp>
+#include "helper/multiplexed_samples_ring.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST_CASE("multiplexed samples ring is found by token") {
+  auto reader = MultiplexedSamplesRing::create({2, 1, 3}, 512);
+  REQUIRE(reader);
+  REQUIRE(reader->getToken() != 0);
+  REQUIRE(reader->getFrameChannels() == 6);
+
+  auto writer = MultiplexedSamplesRing::open(reader->getToken());
+  REQUIRE(writer);
+  REQUIRE(writer->getStreamCount() == 3);
+  REQUIRE(writer->getStreamChannelCount(2) == 3);
+  REQUIRE_FALSE(MultiplexedSamplesRing::open(reader->getToken() + 1));
+}
+
+TEST_CASE("multiplexed samples ring frames complete once every stream has written them") {
+  auto reader = MultiplexedSamplesRing::create({2, 1}, 16);
+  REQUIRE(reader);
+  auto writerA = MultiplexedSamplesRing::open(reader->getToken());
+  auto writerB = MultiplexedSamplesRing::open(reader->getToken());
+  REQUIRE(writerA);
+  REQUIRE(writerB);
+
+  std::vector<float> a0{1.f, 2.f, 3.f}, a1{4.f, 5.f, 6.f}, b0{7.f, 8.f};
+  const float* streamA[] = {a0.data(), a1.data()};
+  const float* streamB[] = {b0.data()};
+
+  REQUIRE(writerA->writeFrames(0, streamA, 2, 3, 0));
+  REQUIRE(reader->readableFrames() == 0);
+  REQUIRE(writerB->writeFrames(1, streamB, 1, 2, 0));
+  REQUIRE(reader->readableFrames() == 2);
+
+  auto frame = reader->currentFrame();
+  REQUIRE(frame[0] == 1.f);
+  REQUIRE(frame[1] == 4.f);
+  REQUIRE(frame[2] == 7.f);
+  REQUIRE(frame[3] == 2.f);
+  REQUIRE(frame[4] == 5.f);
+  REQUIRE(frame[5] == 8.f);
+  reader->advanceFrames(2);
+  REQUIRE(reader->readableFrames() == 0);
+
+  // B ending leaves A's third frame incomplete for good
+  REQUIRE_FALSE(reader->endOfStream());
+  writerB->markEndOfStream(1);
+  REQUIRE(reader->endOfStream());
+  REQUIRE_FALSE(reader->waitForFrame(1000));
+}
+
+TEST_CASE("multiplexed samples ring streams wait on the slowest stream") {
+  auto reader = MultiplexedSamplesRing::create({1, 2}, 16);
+  REQUIRE(reader);
+  const uint32_t totalFrames = reader->getCapacityFrames() * 3 + 11;
+
+  std::atomic<bool> written{true};
+  auto produce = [&written, token = reader->getToken(), totalFrames](uint32_t stream, uint32_t channels) {
+    auto writer = MultiplexedSamplesRing::open(token);
+    std::vector<float> ramp(700);
+    std::vector<const float*> pointers(channels, ramp.data());
+    for (uint32_t start = 0; start < totalFrames; start += 700) {
+      auto count = std::min<uint32_t>(700, totalFrames - start);
+      for (uint32_t i = 0; i < count; ++i) {
+        ramp[i] = static_cast<float>(start + i);
+      }
+      if (!writer->writeFrames(stream, pointers.data(), channels, count, 1000)) {
+        written = false;
+      }
+    }
+    writer->markEndOfStream(stream);
+  };
+  std::thread producerA(produce, 0, 1);
+  std::thread producerB(produce, 1, 2);
+
+  bool inOrder = true;
+  uint32_t frame = 0;
+  while (reader->waitForFrame(1000)) {
+    auto run = reader->contiguousReadableFrames();
+    auto samples = reader->currentFrame();
+    for (uint32_t i = 0; i < run; ++i, ++frame) {
+      for (uint32_t c = 0; c < 3; ++c) {
+        inOrder &= samples[i * 3 + c] == static_cast<float>(frame);
+      }
+    }
+    reader->advanceFrames(run);
+  }
+  producerA.join();
+  producerB.join();
+  REQUIRE(written);
+  REQUIRE(inOrder);
+  REQUIRE(frame == totalFrames);
+  REQUIRE(reader->endOfStream());
+}
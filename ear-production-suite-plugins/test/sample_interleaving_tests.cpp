@@ -0,0 +1,80 @@
+#include <catch2/catch_all.hpp>
+#include "helper/sample_interleaving.hpp"
+#include <vector>
+
+namespace {
+std::vector<std::vector<float>> makeChannels(uint32_t numChannels,
+                                             uint32_t numFrames) {
+  std::vector<std::vector<float>> channels(numChannels);
+  for (uint32_t c = 0; c < numChannels; ++c) {
+    for (uint32_t f = 0; f < numFrames; ++f) {
+      channels[c].push_back(static_cast<float>(c * 1000 + f));
+    }
+  }
+  return channels;
+}
+}  // namespace
+
+TEST_CASE("interleaveBlock transposes planar channels") {
+  // Odd sizes exercise both the vectorised and remainder paths
+  for (uint32_t numChannels : {1u, 3u, 4u, 7u, 64u}) {
+    for (uint32_t numFrames : {0u, 1u, 5u, 512u}) {
+      auto channels = makeChannels(numChannels, numFrames);
+      std::vector<const float*> pointers;
+      for (auto const& channel : channels) pointers.push_back(channel.data());
+
+      std::vector<float> dest(numChannels * numFrames, -1.f);
+      interleaveBlock(pointers.data(), numChannels, 0, numFrames, dest.data(),
+                      numChannels);
+
+      bool matches = true;
+      for (uint32_t f = 0; f < numFrames; ++f) {
+        for (uint32_t c = 0; c < numChannels; ++c) {
+          matches &= dest[f * numChannels + c] == channels[c][f];
+        }
+      }
+      CAPTURE(numChannels, numFrames);
+      REQUIRE(matches);
+    }
+  }
+}
+
+TEST_CASE("interleaveBlock honours offset, stride and silent channels") {
+  auto channels = makeChannels(6, 20);
+  std::vector<const float*> pointers;
+  for (auto const& channel : channels) pointers.push_back(channel.data());
+  pointers[2] = nullptr;
+
+  const uint32_t stride = 8;
+  std::vector<float> dest(stride * 10, -1.f);
+  interleaveBlock(pointers.data(), 6, 7, 10, dest.data(), stride);
+
+  for (uint32_t f = 0; f < 10; ++f) {
+    for (uint32_t c = 0; c < stride; ++c) {
+      float expected = (c < 6 && c != 2) ? channels[c][f + 7] : 0.f;
+      CHECK(dest[f * stride + c] == expected);
+    }
+  }
+}
+
+TEST_CASE("interleaveBlock leaves samples beyond width untouched") {
+  auto channels = makeChannels(5, 12);
+  std::vector<const float*> pointers;
+  for (auto const& channel : channels) pointers.push_back(channel.data());
+
+  // Writes slots 2-7 of 10-sample frames, the last as silence
+  const uint32_t stride = 10;
+  const uint32_t width = 6;
+  std::vector<float> dest(stride * 12, -1.f);
+  interleaveBlock(pointers.data(), 5, 0, 12, dest.data() + 2, stride, width);
+
+  for (uint32_t f = 0; f < 12; ++f) {
+    for (uint32_t c = 0; c < stride; ++c) {
+      float expected = -1.f;
+      if (c >= 2 && c < 2 + width) {
+        expected = (c - 2 < 5) ? channels[c - 2][f] : 0.f;
+      }
+      CHECK(dest[f * stride + c] == expected);
+    }
+  }
+}
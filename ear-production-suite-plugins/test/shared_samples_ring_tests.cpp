@@ -0,0 +1,185 @@
+#include <catch2/catch_all.hpp>
+#include "helper/shared_samples_ring.h"
+#include <array>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+// Well clear of the ports the samples sockets pick from NNG_PORT_START
+constexpr int TEST_PORT = 60123;
+}  // namespace
+
+TEST_CASE("shared samples ring is found by port") {
+  auto writer = SharedSamplesRing::create(TEST_PORT, 4, 512);
+  REQUIRE(writer);
+  REQUIRE(writer->getCapacityFrames() ==
+          512 * SharedSamplesRing::BLOCKS_OF_HEADROOM);
+
+  auto reader = SharedSamplesRing::open(TEST_PORT);
+  REQUIRE(reader);
+  REQUIRE(reader->getChannelCount() == 4);
+  REQUIRE_FALSE(SharedSamplesRing::open(TEST_PORT + 1));
+
+  REQUIRE_FALSE(writer->readerAttached());
+  reader->setReaderAttached(true);
+  REQUIRE(writer->readerAttached());
+  reader.reset();
+  REQUIRE_FALSE(writer->readerAttached());
+}
+
+TEST_CASE("shared samples ring interleaves and zero fills") {
+  auto writer = SharedSamplesRing::create(TEST_PORT, 4, 16);
+  auto reader = SharedSamplesRing::open(TEST_PORT);
+  REQUIRE(reader);
+
+  std::array<float, 2> left{1.f, 2.f};
+  std::array<float, 2> right{-1.f, -2.f};
+  const float* channels[] = {left.data(), right.data()};
+  REQUIRE(writer->writeFrames(channels, 2, 2, 0));
+  REQUIRE(reader->readableFrames() == 2);
+
+  for (int frame = 0; frame < 2; ++frame) {
+    auto samples = reader->currentFrame();
+    CHECK(samples[0] == left[frame]);
+    CHECK(samples[1] == right[frame]);
+    CHECK(samples[2] == 0.f);
+    CHECK(samples[3] == 0.f);
+    reader->advanceFrame();
+  }
+  REQUIRE(reader->readableFrames() == 0);
+  REQUIRE_FALSE(reader->waitForFrame(10));
+}
+
+TEST_CASE("shared samples ring frames only hold the exported channels") {
+  auto writer = SharedSamplesRing::create(TEST_PORT, 64, 16);
+  auto reader = SharedSamplesRing::open(TEST_PORT);
+  REQUIRE(reader);
+
+  writer->reset(3);
+  REQUIRE(reader->getFrameChannels() == 3);
+  std::array<float, 2> a{1.f, 2.f};
+  std::array<float, 2> b{3.f, 4.f};
+  std::array<float, 2> c{5.f, 6.f};
+  const float* channels[] = {a.data(), b.data(), c.data()};
+  REQUIRE(writer->writeFrames(channels, 3, 2, 0));
+
+  reader->advanceFrame();
+  auto samples = reader->currentFrame();
+  CHECK(samples[0] == 2.f);
+  CHECK(samples[1] == 4.f);
+  CHECK(samples[2] == 6.f);
+}
+
+TEST_CASE("shared samples ring writer waits for space") {
+  auto writer = SharedSamplesRing::create(TEST_PORT, 2, 16);
+  auto reader = SharedSamplesRing::open(TEST_PORT);
+  REQUIRE(reader);
+
+  // Several times the capacity, so the writer must wrap and wait on the reader
+  const uint32_t totalFrames = writer->getCapacityFrames() * 3 + 7;
+  bool written = true;
+  std::thread producer([&writer, &written, totalFrames]() {
+    std::vector<float> ramp(1000);
+    const float* channels[] = {ramp.data(), ramp.data()};
+    for (uint32_t start = 0; start < totalFrames; start += 1000) {
+      auto count = std::min<uint32_t>(1000, totalFrames - start);
+      for (uint32_t i = 0; i < count; ++i) {
+        ramp[i] = static_cast<float>(start + i);
+      }
+      written &= writer->writeFrames(channels, 2, count, 1000);
+    }
+  });
+
+  bool inOrder = true;
+  for (uint32_t frame = 0; frame < totalFrames; ++frame) {
+    if (reader->readableFrames() == 0 && !reader->waitForFrame(1000)) {
+      inOrder = false;
+      break;
+    }
+    inOrder &= reader->currentFrame()[1] == static_cast<float>(frame);
+    reader->advanceFrame();
+  }
+  producer.join();
+  REQUIRE(written);
+  REQUIRE(inOrder);
+}
+
+TEST_CASE("shared samples ring signals end of stream after the last frame") {
+  auto writer = SharedSamplesRing::create(TEST_PORT, 1, 16);
+  auto reader = SharedSamplesRing::open(TEST_PORT);
+  REQUIRE(reader);
+
+  float sample = 1.f;
+  const float* channels[] = {&sample};
+  REQUIRE(writer->writeFrames(channels, 1, 1, 0));
+  writer->markEndOfStream();
+
+  REQUIRE_FALSE(reader->endOfStream());
+  REQUIRE(reader->waitForFrame(0));
+  reader->advanceFrame();
+  REQUIRE(reader->endOfStream());
+
+  // Returns straight away rather than waiting out the timeout
+  auto start = std::chrono::steady_clock::now();
+  REQUIRE_FALSE(reader->waitForFrame(5000));
+  REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+
+  writer->reset(1);
+  REQUIRE_FALSE(reader->endOfStream());
+}
+
+TEST_CASE("shared samples ring contiguous runs stop at the wrap") {
+  auto writer = SharedSamplesRing::create(TEST_PORT, 1, 16);
+  auto reader = SharedSamplesRing::open(TEST_PORT);
+  REQUIRE(reader);
+
+  const uint32_t capacity = writer->getCapacityFrames();
+  std::vector<float> samples(capacity - 10);
+  const float* channels[] = {samples.data()};
+  REQUIRE(writer->writeFrames(channels, 1,
+                              static_cast<uint32_t>(samples.size()), 0));
+  reader->advanceFrames(capacity - 20);
+  REQUIRE(reader->contiguousReadableFrames() == 10);
+
+  // 10 frames up to the end of the ring, 15 more from its start
+  std::vector<float> more(15, 2.f);
+  channels[0] = more.data();
+  REQUIRE(writer->writeFrames(channels, 1, 15, 0));
+  REQUIRE(reader->readableFrames() == 25);
+  REQUIRE(reader->contiguousReadableFrames() == 20);
+  reader->advanceFrames(20);
+  REQUIRE(reader->contiguousReadableFrames() == 5);
+  REQUIRE(reader->currentFrame()[0] == 2.f);
+}
+
+TEST_CASE("shared samples ring write times out when full") {
+  auto writer = SharedSamplesRing::create(TEST_PORT, 1, 16);
+  std::vector<float> samples(writer->getCapacityFrames() + 1);
+  const float* channels[] = {samples.data()};
+  REQUIRE_FALSE(writer->writeFrames(channels, 1,
+                                    static_cast<uint32_t>(samples.size()), 10));
+}
+
+TEST_CASE("shared samples ring reports space and dropped frames") {
+  auto writer = SharedSamplesRing::create(TEST_PORT, 1, 16);
+  auto reader = SharedSamplesRing::open(TEST_PORT);
+  REQUIRE(reader);
+
+  const uint32_t capacity = writer->getCapacityFrames();
+  REQUIRE(writer->writableFrames() == capacity);
+  std::vector<float> samples(capacity - 4);
+  const float* channels[] = {samples.data()};
+  REQUIRE(writer->writeFrames(channels, 1,
+                              static_cast<uint32_t>(samples.size()), 0));
+  REQUIRE(writer->writableFrames() == 4);
+  reader->advanceFrames(6);
+  REQUIRE(writer->writableFrames() == 10);
+
+  REQUIRE(reader->droppedFrames() == 0);
+  writer->countDroppedFrames(16);
+  writer->countDroppedFrames(16);
+  REQUIRE(reader->droppedFrames() == 32);
+  writer->reset(1);
+  REQUIRE(reader->droppedFrames() == 0);
+}
@@ -11,7 +11,6 @@ AdmStemPluginAudioProcessor::AdmStemPluginAudioProcessor()
 #endif
 {
     CRT_SET
-    sendSamples = false;
 
     // ORDERING OF addParameter IS IMPORTANT! IT SETS THE PARAMETER INDEX, WHICH IS USED DIRECTLY BY reaper_adm
     // DO NOT CHANGE THE CALL ORDER FOR EXISTING PARAMETERS. ONLY APPEND NEW PARAMETERS TO THE END.
@@ -98,6 +97,16 @@ AdmStemPluginAudioProcessor::~AdmStemPluginAudioProcessor()
 
 
 void AdmStemPluginAudioProcessor::incomingMessage(std::shared_ptr<NngMsg> msg) {
+    uint8_t firstByte = 0;
+    if (msg->getSize() > 0) memcpy(&firstByte, msg->getBufferPointer(), sizeof(uint8_t));
+
+    if (firstByte == commandSocket->Command::SetMultiplexedStream && msg->getSize() > sizeof(uint8_t)) {
+        uint32_t token, stream;
+        bool joined = commandSocket->decodeMultiplexedStreamMessage(msg, token, stream) && joinMultiplexedStream(token, stream);
+        commandSocket->sendResp(joined? commandSocket->Command::SetMultiplexedStreamResp : commandSocket->Command::SetMultiplexedStream);
+        return;
+    }
+
     if (msg->getSize() == sizeof(uint8_t)) {
         uint8_t cmd;
         memcpy(&cmd, msg->getBufferPointer(), sizeof(uint8_t));
@@ -114,7 +123,8 @@ void AdmStemPluginAudioProcessor::incomingMessage(std::shared_ptr<NngMsg> msg) {
         }
         uint8_t numChannels = numChnsParam->get();
         uint32_t sampleRate = sampleRateParam->get();
-        commandSocket->sendInfo(numChannels, sampleRate, (uint16_t)admTypeDefinitionParam->get(), (uint16_t)admPackFormatParam->get(), (uint16_t)admChannelFormatParam->get());
+        commandSocket->sendInfo(numChannels, sampleRate, (uint16_t)admTypeDefinitionParam->get(), (uint16_t)admPackFormatParam->get(), (uint16_t)admChannelFormatParam->get(),
+                                commandSocket->CAPABILITY_MULTIPLEXED_SAMPLES, (uint32_t)maxBlockSize);
     }
 
 }
@@ -277,14 +287,44 @@ void AdmStemPluginAudioProcessor::updateAdmParameters(bool force)
     }
 }
 
+bool AdmStemPluginAudioProcessor::joinMultiplexedStream(uint32_t token, uint32_t stream) {
+    if(samplesStream.isStreaming()) return false;
+    multiplexedRing.reset();
+    if(token == 0) return true;
+    multiplexedRing = MultiplexedSamplesRing::open(token);
+    if(multiplexedRing && stream < multiplexedRing->getStreamCount() &&
+       multiplexedRing->getStreamChannelCount(stream) == (uint32_t)numChnsParam->get()) {
+        multiplexedStream = stream;
+        return true;
+    }
+    multiplexedRing.reset();
+    return false;
+}
+
 void AdmStemPluginAudioProcessor::renderIsStarting() {
     OutputDebugString("\n[Render START]");
-    sendSamples = includeInAdmRender->get();
+    if(includeInAdmRender->get()) {
+        if(!multiplexedRing) samplesMsgPool.start();
+        samplesStream.start();
+    }
 }
 
 void AdmStemPluginAudioProcessor::renderHasFinished() {
     OutputDebugString("\n[Render FINISH]");
-    sendSamples = false;
+    bool wasStreaming = samplesStream.isStreaming();
+    samplesStream.stop();
+    samplesMsgPool.stop();
+    if(wasStreaming) {
+        // Must follow the last block, which may still be in flight on the audio thread
+        samplesStream.waitForBlockInProgress();
+        if(multiplexedRing) {
+            multiplexedRing->markEndOfStream(multiplexedStream);
+        } else {
+            samplesSocket->sendEndOfStream();
+        }
+    }
+    // The extension creates a new ring for each render
+    multiplexedRing.reset();
 }
 
 
@@ -297,6 +337,8 @@ void AdmStemPluginAudioProcessor::prepareToPlay (double vstSampleRate, int sampl
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
     sampleRateParam->internalSetIntAndNotifyHost(vstSampleRate);
+    maxBlockSize = samplesPerBlock;
+    samplesMsgPool.prepare(samplesPerBlock * 64 * sizeof(float));
 }
 
 void AdmStemPluginAudioProcessor::releaseResources()
@@ -344,39 +386,45 @@ void AdmStemPluginAudioProcessor::processBlock (AudioBuffer<float>& buffer, Midi
     // This is the place where you'd normally do the guts of your plugin's
     // audio processing...
 
-    if (sendSamples) {
-        size_t sampleSize = sizeof(float);
-        uint8_t numChannels = numChnsParam->get();
-        size_t msg_size = buffer.getNumSamples() * numChannels * sampleSize; // Samples
-        auto msg = std::make_shared<NngMsg>(msg_size);
-
-        char* msgPosPtr = (char*)msg->getBufferPointer();
-        int msgPosOffset = 0;
-        float curSample = 0.0;
-
-        int bufferChannels = buffer.getNumChannels();
-        int bufferSamplesPerChannel = buffer.getNumSamples();
-
-        for(int sample = 0; sample < bufferSamplesPerChannel; ++sample)
-        {
-            for (int channel = 0; channel < numChannels; ++channel)
-            {
-                curSample = (channel < totalNumInputChannels)? buffer.getSample(channel, sample) : 0.0;
-                assert(msgPosOffset + sampleSize <= msg_size);
-                memcpy(msgPosPtr + msgPosOffset, &curSample, sampleSize);
-                msgPosOffset += sampleSize;
-            }
-        }
-
-        auto resSend = samplesSocket->sendBlock(msg, 0);
-        assert(resSend == 0);
-        if (resSend != 0) {
+    if (samplesStream.beginBlock()) {
+        if (!sendSamples(buffer, totalNumInputChannels)) {
             // TODO: Log this error somewhere - this means we can't send our samples
-            sendSamples = false;
-            return;
+            samplesStream.stop();
+            samplesMsgPool.stop();
+            // Otherwise the extension would wait on this stream until it times out.
+            // Done before endBlock(), as renderHasFinished() releases the ring once no block is in progress.
+            if (multiplexedRing) multiplexedRing->markEndOfStream(multiplexedStream);
         }
+        samplesStream.endBlock();
+    }
+
+}
+
+bool AdmStemPluginAudioProcessor::sendSamples(const AudioBuffer<float>& buffer, int totalNumInputChannels)
+{
+    uint32_t numChannels = numChnsParam->get();
+    uint32_t numSamples = buffer.getNumSamples();
+
+    // Channels beyond the input bus are sent as silence
+    const float* channelPointers[64];
+    for (uint32_t channel = 0; channel < numChannels; ++channel) {
+        channelPointers[channel] = (channel < (uint32_t)totalNumInputChannels)? buffer.getReadPointer(channel) : nullptr;
+    }
+
+    if (multiplexedRing) {
+        // Space is freed once every export source has written a frame, so only waits
+        // if this one gets a long way ahead of the rest
+        return multiplexedRing->writeFrames(multiplexedStream, channelPointers, numChannels, numSamples, 1000);
     }
 
+    auto msg = samplesMsgPool.acquire(numSamples * numChannels * sizeof(float));
+    if (!msg) return false;
+
+    interleaveBlock(channelPointers, numChannels, 0, numSamples, (float*)nng_msg_body(msg), numChannels);
+
+    auto resSend = samplesSocket->sendBlock(msg, 0);
+    assert(resSend == 0);
+    return resSend == 0;
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
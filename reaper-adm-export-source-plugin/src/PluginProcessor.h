@@ -11,6 +11,7 @@
 #pragma once
 
 #include "helper/nng_wrappers.h"
+#include "helper/multiplexed_samples_ring.h"
 #include "JuceHeader_Wrapper.h"
 #include "helper/common_definition_helper.h"
 #include "PluginProcessorUtils.h"
@@ -93,7 +94,15 @@ private:
     int desiredPackFormat{ PACKFORMAT_UNSET_ID };
     int desiredChannelFormat{ CHANNELFORMAT_ALLCHANNELS_ID };
 
-    bool sendSamples;
+    SamplesStreamState samplesStream;
+    bool sendSamples(const AudioBuffer<float>& buffer, int totalNumInputChannels);
+    bool joinMultiplexedStream(uint32_t token, uint32_t stream);
+
+    // Set by the extension before StartRender when all export sources share one ring.
+    // Only changed whilst not streaming.
+    std::unique_ptr<MultiplexedSamplesRing> multiplexedRing;
+    uint32_t multiplexedStream{ 0 };
+    int maxBlockSize{ 0 };
 
     void renderIsStarting();
     void renderHasFinished();
@@ -113,6 +122,7 @@ private:
 
     CommandReceiver *commandSocket;
     SamplesSender *samplesSocket;
+    SamplesMsgPool samplesMsgPool;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AdmStemPluginAudioProcessor)
 };
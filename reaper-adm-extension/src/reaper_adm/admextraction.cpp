@@ -1,5 +1,7 @@
 #include "coordinate_conversion/coord_conv.hpp"
 #include "admextraction.h"
+#include <cmath>
+#include <limits>
 
 using namespace admplug::detail;
 
@@ -64,27 +66,74 @@ void RoomCartesianToSphericalSpeaker::calculate() {
     }
 }
 
-std::vector<admplug::AutomationPoint> admplug::detail::simplify(const std::vector<admplug::AutomationPoint> &points)
+void admplug::detail::simplify(std::vector<AutomationPoint>& points, bool wrapping, double tolerance)
 {
-    std::vector<AutomationPoint> filtered;
-    if(!points.empty()) {
-        filtered.push_back(points.front());
-        bool previousCopied{true};
-        for(auto currentPos = points.cbegin() + 1, end = points.cend(); currentPos != end; ++currentPos) {
-            auto const& current = *currentPos;
-            auto const& previous = *(currentPos - 1);
-            if(current.value() != previous.value()) {
-                if(!previousCopied) {
-                    filtered.push_back(previous);
-                }
-                filtered.push_back(current);
-                previousCopied = true;
-            } else {
-                previousCopied = false;
-            }
+    // Single pass, compacting in place. Alongside the last kept point (the anchor) we keep the range of slopes
+    // for lines from it which pass within tolerance of every point dropped since. A point can be dropped when the
+    // line from the anchor to the point after it is in that range, so no dropped point ends up further than
+    // tolerance from the envelope, without having to revisit them.
+    if(points.size() < 2) return;
+
+    auto const unbounded = std::numeric_limits<double>::infinity();
+    auto wraps = [wrapping](double from, double to) {
+        // WrappingEnvelope takes the shortest path, which for values over half the range apart is across the wrap
+        return wrapping && std::abs(to - from) > 0.5;
+    };
+    auto nsBetween = [](AutomationPoint const& from, AutomationPoint const& to) {
+        return static_cast<double>((to.effectiveTimeNs() - from.effectiveTimeNs()).count());
+    };
+
+    std::size_t anchor{0};
+    double minSlope{-unbounded};
+    double maxSlope{unbounded};
+    double previousValue{points.front().value()};
+
+    for(std::size_t i = 1; i + 1 < points.size(); ++i) {
+        auto const& from = points[anchor];
+        auto const& current = points[i];
+        auto const& next = points[i + 1];
+
+        auto lower = minSlope;
+        auto upper = maxSlope;
+        auto currentTime = nsBetween(from, current);
+        if(currentTime > 0.0) {
+            lower = std::max(lower, (current.value() - tolerance - from.value()) / currentTime);
+            upper = std::min(upper, (current.value() + tolerance - from.value()) / currentTime);
+        } else if(std::abs(current.value() - from.value()) > tolerance) {
+            lower = unbounded; // A jump at the anchor's time has to stay
+        }
+
+        bool onLine{false};
+        auto nextTime = nsBetween(from, next);
+        if(nextTime > 0.0) {
+            auto slope = (next.value() - from.value()) / nextTime;
+            onLine = lower <= slope && slope <= upper;
+        } else {
+            onLine = lower <= upper && std::abs(next.value() - from.value()) <= tolerance;
         }
+
+        bool crossesWrap = wraps(previousValue, current.value()) ||
+                           wraps(current.value(), next.value()) ||
+                           wraps(from.value(), next.value());
+        previousValue = current.value();
+
+        if(onLine && !crossesWrap) {
+            minSlope = lower;
+            maxSlope = upper;
+        } else {
+            points[++anchor] = current;
+            minSlope = -unbounded;
+            maxSlope = unbounded;
+        }
+    }
+
+    // The envelope holds its last value, so a final point which doesn't change it is redundant
+    auto const& last = points.back();
+    bool flat = minSlope <= 0.0 && 0.0 <= maxSlope && std::abs(last.value() - points[anchor].value()) <= tolerance;
+    if(!flat) {
+        points[++anchor] = last;
     }
-    return filtered;
+    points.erase(points.begin() + static_cast<std::ptrdiff_t>(anchor) + 1, points.end());
 }
 
 void admplug::detail::fixEffectiveTimeOverlaps(std::vector<AutomationPoint> &points)
@@ -4,6 +4,7 @@
 #include <adm/elements.hpp>
 #include "automationpoint.h"
 #include "automationenvelope.h"
+#include "envelopecreator.h"
 #include "parameter.h"
 
 namespace {
@@ -261,7 +262,12 @@ std::optional<AutomationPoint> getSphericalPoint(Parameter const& param, adm::Au
     }
 }
 
-std::vector<AutomationPoint> simplify(std::vector<AutomationPoint> const& points);
+// Normalised parameter values within this of the line between their neighbours are redundant
+constexpr double SIMPLIFY_TOLERANCE = 0.00001;
+// Removes points which are equal to, or in line with, their neighbours, in place and in linear time.
+// For wrapping parameters, points are kept wherever dropping them would change a WrappingEnvelope's path across the wrap.
+// Points must be ordered by time.
+void simplify(std::vector<AutomationPoint>& points, bool wrapping = false, double tolerance = SIMPLIFY_TOLERANCE);
 void fixEffectiveTimeOverlaps(std::vector<AutomationPoint> &points);
 
 template<typename ParameterT, typename AutomatableT>
@@ -273,7 +279,7 @@ void applyAutomation(std::vector<AutomationPoint> points,
     if(!points.empty()) {
         std::sort(points.begin(), points.end(), pointsTimeSorter); // fixEffectiveTimeOverlaps and simplify assumes the points are ordered by time, so do it
         fixEffectiveTimeOverlaps(points);
-        points = simplify(points);
+        simplify(points, DefaultEnvelopeCreator::isWrappedParam(parameter.admParameter()));
 
         parameter.set(automatable, points.front().value());
 
@@ -21,6 +21,7 @@
 #include "progress/importlistener.h"
 #include <WDL/swell/swell.h>
 #include <exception>
+#include <unordered_set>
 #include <helper/container_helpers.hpp>
 
 using namespace admplug;
@@ -118,22 +119,20 @@ namespace {
 
   template <typename ExistingT, typename NewT>
   std::vector<std::shared_ptr<NewT const>> getElementsIfNo(std::shared_ptr<adm::Document const> doc) {
-      auto possibleParents = doc->getElements<ExistingT>();
-      auto possibleElements = doc->getElements<NewT>();
-      std::vector<std::shared_ptr<NewT const>> orphanedElements(possibleElements.size());
-
-      auto it = std::copy_if(possibleElements.begin(), possibleElements.end(), orphanedElements.begin(),
-                  [&possibleParents](auto e) {
-                      for(auto const& p : possibleParents) {
-                          auto children = p->template getReferences<NewT>();
-                          for(auto const& c : children) {
-                              if(c == e) return false;
-                          }
-                      }
-                      return true;
-                  });
-      orphanedElements.resize(std::distance(orphanedElements.begin(), it));
+      // Gather every reference from every possible parent once, so each candidate is a single lookup
+      std::unordered_set<std::shared_ptr<NewT const>> referencedElements;
+      for(auto const& parent : doc->getElements<ExistingT>()) {
+          for(auto const& child : parent->template getReferences<NewT>()) {
+              referencedElements.insert(child);
+          }
+      }
 
+      std::vector<std::shared_ptr<NewT const>> orphanedElements;
+      for(auto const& element : doc->getElements<NewT>()) {
+          if(!contains(referencedElements, element)) {
+              orphanedElements.push_back(element);
+          }
+      }
       return orphanedElements;
   }
 
@@ -157,6 +156,16 @@ namespace {
       return static_cast<int>(flag);
   }
 
+  std::unique_ptr<PCMReader> createPCMReader(std::string const& fileName)
+  {
+      try {
+          return std::make_unique<MappedBw64PCMReader>(fileName);
+      } catch (std::runtime_error const&) {
+          // e.g. not enough address space to map the file - the stream reader will report anything actually wrong with it
+          return std::make_unique<Bw64PCMReader>(fileName);
+      }
+  }
+
   void checkMetadataPresent(IADMMetaData const& admData)
   {
       if (!admData.chna()) {
@@ -175,15 +184,17 @@ ADMImporter::~ADMImporter() = default;
 ADMImporter::ADMImporter(MediaItem* fromMediaItem,
                          std::string fileName,
                          ImportContext context,
-                         std::string importPath) :
+                         std::string importPath,
+                         ImportMode mode) :
     originalMediaItem{ fromMediaItem },
     importPath{importPath},
+    mode{mode},
     context{std::move(context)},
     fileName{fileName}
 {
 }
 
-void ADMImporter::parse() {
+bool ADMImporter::parse() {
     auto& broadcast = *context.broadcast;
     broadcast.setStatus(ImportStatus::PARSING_METADATA);
     try {
@@ -194,20 +205,26 @@ void ADMImporter::parse() {
         contents = getElementsIfNo<adm::AudioProgramme, adm::AudioContent>(admDoc);
         auto objectsWithNoParentContent = getElementsIfNo<adm::AudioContent, adm::AudioObject>(admDoc);
         auto objectsWithNoParentObject = getElementsIfNo<adm::AudioObject, adm::AudioObject>(admDoc);
+        std::unordered_set<std::shared_ptr<adm::AudioObject const>> topLevelObjects(objectsWithNoParentObject.begin(), objectsWithNoParentObject.end());
         objects.clear();
         for(auto object : objectsWithNoParentContent) {
-            if(contains(objectsWithNoParentObject, object)) {
+            if(contains(topLevelObjects, object)) {
                 objects.push_back(object);
             }
         }
         // TODO - We don't do anything with this at the moment. Intention was to import in to session anyway but without an AudioObject plugin.
         //uids = getElementsIfNo<adm::AudioObject, adm::AudioTrackUid>(admDoc);
         auto tracer = adm::detail::GenericRouteTracer<adm::Route, FullDepthViaUIDStrategy>();
-        sourceCreator = std::make_shared<PCMSourceCreator>(std::make_unique<PCMGroupRegistry>(),
-                                                           std::make_unique<Bw64PCMReader>(fileName),
-                                                           std::make_unique<RoutingWriterFactory>(),
-                                                           *metadata);
-        project = std::make_unique<ProjectTree>(std::make_unique<NodeCreator>(sourceCreator, originalMediaItem),
+        if(mode == ImportMode::REFERENCE_ORIGINAL) {
+            sourceCreator = std::make_shared<PCMSourceCreator>(std::make_unique<PCMGroupRegistry>(),
+                                                               *metadata);
+        } else {
+            sourceCreator = std::make_shared<PCMSourceCreator>(std::make_unique<PCMGroupRegistry>(),
+                                                               createPCMReader(fileName),
+                                                               std::make_unique<RoutingWriterFactory>(),
+                                                               *metadata);
+        }
+        project = std::make_unique<ProjectTree>(std::make_unique<NodeCreator>(sourceCreator, originalMediaItem, metadata),
                                                 sourceCreator,
                                                 std::make_unique<ProjectNode>(std::make_unique<ImportElement>(originalMediaItem)),
                                                 this->context.broadcast);
@@ -215,35 +232,38 @@ void ADMImporter::parse() {
         applyRoutes(contents, tracer, *project);
         applyRoutes(objects, tracer, *project);
         //applyRoutes(uids, tracer, *project);
-    } catch (std::runtime_error const& e) {
+    } catch (std::exception const& e) {
         broadcast.error(e);
     }
     auto& import = *context.import;
     auto status = import.status();
     if(status == ImportStatus::CANCELLED) {
         broadcast.setStatus(ImportStatus::COMPLETE);
-    } else if (status != ImportStatus::ERROR_OCCURRED) {
-        extractAudio();
+        return false;
     }
+    return status != ImportStatus::ERROR_OCCURRED;
 }
 
 void ADMImporter::extractAudio() {
-    auto& import = *context.import;
     auto& broadcast = *context.broadcast;
     try {
       broadcast.setStatus(ImportStatus::EXTRACTING_AUDIO);
       sourceCreator->extractSources(importPath, context);
-      auto status = import.status();
-      if(status == ImportStatus::CANCELLED) {
-          broadcast.setStatus(ImportStatus::COMPLETE);
-      } else {
-          broadcast.setStatus(ImportStatus::AUDIO_READY);
-      }
-    } catch (std::runtime_error const& e) {
+    } catch (std::exception const& e) {
         broadcast.error(e);
     }
 }
 
+void ADMImporter::finishExtraction() {
+    auto& broadcast = *context.broadcast;
+    auto status = context.import->status();
+    if(status == ImportStatus::CANCELLED) {
+        broadcast.setStatus(ImportStatus::COMPLETE);
+    } else if(status != ImportStatus::ERROR_OCCURRED) {
+        broadcast.setStatus(ImportStatus::AUDIO_READY);
+    }
+}
+
 void ADMImporter::buildProject() {
     auto const& api = context.api;
     auto currentProject = api.getCurrentProject();
@@ -269,7 +289,7 @@ void ADMImporter::buildProject() {
         context.pluginSuite->onProjectBuildComplete(api);
         api.Undo_EndBlock2(currentProject, "ADM Import", undoFlags);
         context.broadcast->setStatus(ImportStatus::COMPLETE);
-    } catch (std::runtime_error const& error) {
+    } catch (std::exception const& error) {
         api.Undo_EndBlock2(currentProject, "ADM Import", undoFlags);
         context.broadcast->error(error);
         context.broadcast->setStatus(ImportStatus::ERROR_OCCURRED);
@@ -277,3 +297,12 @@ void ADMImporter::buildProject() {
     }
 
 }
+
+void ADMImporter::reportError(std::exception const& e) {
+    context.broadcast->error(e);
+    context.broadcast->setStatus(ImportStatus::ERROR_OCCURRED);
+}
+
+void ADMImporter::cancel() {
+    context.broadcast->setStatus(ImportStatus::CANCELLED);
+}
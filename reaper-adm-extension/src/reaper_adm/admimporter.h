@@ -1,4 +1,5 @@
 #pragma once
+#include <exception>
 #include <string>
 #include <vector>
 #include <memory>
@@ -15,6 +16,11 @@ class PluginSuite;
 class ImportListener;
 class ImportReporter;
 
+enum class ImportMode {
+    EXTRACT_STEMS, // Write each take's channels to its own file
+    REFERENCE_ORIGINAL // Play takes from the original file in place
+};
+
 struct ImportContext {
     std::shared_ptr<ImportListener> broadcast;
     std::shared_ptr<ImportReporter> import;
@@ -22,22 +28,43 @@ struct ImportContext {
     ReaperAPI const& api;
 };
 
-class ADMImporter
+// The steps of an import, in the order an ImportExecutor runs them
+class IADMImporter
+{
+public:
+    virtual ~IADMImporter() = default;
+    // False if there's nothing to extract, as parsing failed or the import was cancelled
+    virtual bool parse() = 0;
+    virtual void extractAudio() = 0;
+    // Reports the audio as ready (or the import as complete, if cancelled) once extractAudio() has returned
+    virtual void finishExtraction() = 0;
+    virtual void buildProject() = 0;
+    // Ends the import with an error that escaped one of the steps above
+    virtual void reportError(std::exception const& e) = 0;
+    // Asks parse() and extractAudio() to stop early, if running
+    virtual void cancel() = 0;
+};
+
+class ADMImporter : public IADMImporter
 {
 public:
     ADMImporter(MediaItem *fromMediaItem,
                 std::string fileName,
                 ImportContext context,
-                std::string importPath);
-    ~ADMImporter();
-    void extractAudio();
-    void buildProject();
-    void parse();
+                std::string importPath,
+                ImportMode mode = ImportMode::EXTRACT_STEMS);
+    ~ADMImporter() override;
+    bool parse() override;
+    void extractAudio() override;
+    void finishExtraction() override;
+    void buildProject() override;
+    void reportError(std::exception const& e) override;
+    void cancel() override;
 private:
     MediaItem * originalMediaItem;
     std::string importPath;
+    ImportMode mode;
     ImportContext context;
-    HANDLE thread;
     std::shared_ptr<IPCMSourceCreator> sourceCreator;
     std::shared_ptr<IADMMetaData> metadata;
     std::unique_ptr<ProjectTree> project;
@@ -1,4 +1,5 @@
 #include "admmetadata.h"
+#include "blockformatindex.h"
 #include <bw64/bw64.hpp>
 #include <adm/document.hpp>
 #include <adm/parse.hpp>
@@ -73,7 +74,11 @@ void ADMMetaData::parseMetadata()
     if (chnaChunk && axmlChunk) {
       std::stringstream xmlStream;
       axmlChunk->write(xmlStream);
-      auto parsedDocument = adm::parseXml(xmlStream, adm::xml::ParserOptions::recursive_node_search);
+      // Object blocks are left out of this parse, and added to their channel when first needed
+      blockFormats = std::make_shared<BlockFormatIndex>(xmlStream.str());
+      std::istringstream structuralStream{blockFormats->structuralXml()};
+      auto parsedDocument = adm::parseXml(structuralStream, adm::xml::ParserOptions::recursive_node_search);
+      blockFormats->releaseStructuralXml();
       document = parsedDocument->deepCopy();
     }
 }
@@ -124,3 +129,12 @@ std::string admplug::ADMMetaData::fileName() const
 {
     return name;
 }
+
+void admplug::ADMMetaData::loadBlockFormats(adm::AudioChannelFormat const& channelFormat) const
+{
+    if(!document || !blockFormats) return;
+    auto documentChannelFormat = document->lookup(channelFormat.get<adm::AudioChannelFormatId>());
+    if(documentChannelFormat) {
+        blockFormats->loadBlockFormats(*documentChannelFormat);
+    }
+}
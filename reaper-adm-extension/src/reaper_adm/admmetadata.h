@@ -4,6 +4,7 @@
 
 namespace adm {
   class Document;
+  class AudioChannelFormat;
 }
 
 namespace bw64 {
@@ -13,6 +14,8 @@ namespace bw64 {
 
 namespace admplug {
 
+class BlockFormatIndex;
+
 class IADMMetaData {
 public:
     virtual ~IADMMetaData() = default;
@@ -20,6 +23,8 @@ public:
     virtual std::shared_ptr<const bw64::AxmlChunk> axml() const = 0;
     virtual std::shared_ptr<const adm::Document> adm() const = 0;
     virtual std::string fileName() const = 0;
+    // Object audioBlockFormats may be parsed on first use, so load them before reading a channel's blocks
+    virtual void loadBlockFormats(adm::AudioChannelFormat const& channelFormat) const = 0;
 };
 
 class ADMMetaData : public IADMMetaData
@@ -30,11 +35,13 @@ public:
     std::shared_ptr<const bw64::AxmlChunk> axml() const override;
     std::shared_ptr<const adm::Document> adm() const override;
     std::string fileName() const override;
+    void loadBlockFormats(adm::AudioChannelFormat const& channelFormat) const override;
 
 private:
     std::shared_ptr<bw64::ChnaChunk> chnaChunk;
     std::shared_ptr<bw64::AxmlChunk> axmlChunk;
     std::shared_ptr<adm::Document> document;
+    std::shared_ptr<BlockFormatIndex> blockFormats;
     std::string name;
     void parseMetadata();
     void completeUidReferences();
@@ -36,12 +36,21 @@ void DefinedStartEnvelope::createPoints(double pointsOffset)
     double pointOnTimeline{ 0.0 };
     bool sortPoints{false};
 
+    std::vector<EnvelopePoint> envelopePoints;
+    envelopePoints.reserve(points.size());
     for(auto& point : points) {
         pointOnTimeline = point.effectiveTime() + pointsOffset;
         if (earliestPointOnTimeline < 0.0 || pointOnTimeline < earliestPointOnTimeline) {
             earliestPointOnTimeline = pointOnTimeline;
         }
-        api.InsertEnvelopePoint(trackEnvelope, pointOnTimeline, point.value(), 0, 0, false, &sortPoints);
+        envelopePoints.push_back({ pointOnTimeline, point.value() });
+    }
+
+    // Inserting one at a time gets slow for dense automation, so only do that if the bulk insert can't be used
+    if(!envelopePoints.empty() && !api.insertEnvelopePoints(trackEnvelope, envelopePoints)) {
+        for(auto const& point : envelopePoints) {
+            api.InsertEnvelopePoint(trackEnvelope, point.time, point.value, 0, 0, false, &sortPoints);
+        }
     }
     api.Envelope_SortPoints(trackEnvelope);
 
@@ -0,0 +1,249 @@
+#include "blockformatindex.h"
+#include <adm/document.hpp>
+#include <adm/parse.hpp>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+using namespace admplug;
+
+namespace {
+
+struct Tag {
+    std::size_t begin{0};
+    std::size_t end{0}; // one past the closing '>'
+    std::string name;
+    bool closing{false};
+    bool selfClosing{false};
+    bool markup{false}; // comment, CDATA, processing instruction or declaration
+};
+
+enum class TagResult {
+    FOUND,
+    END_OF_DOCUMENT,
+    UNSUPPORTED
+};
+
+TagResult skipTo(std::string const& xml, Tag& tag, std::size_t from, char const* terminator)
+{
+    auto end = xml.find(terminator, from);
+    if(end == std::string::npos) return TagResult::UNSUPPORTED;
+    tag.end = end + std::strlen(terminator);
+    tag.markup = true;
+    return TagResult::FOUND;
+}
+
+TagResult nextTag(std::string const& xml, std::size_t from, Tag& tag)
+{
+    tag = Tag{};
+    tag.begin = xml.find('<', from);
+    if(tag.begin == std::string::npos) return TagResult::END_OF_DOCUMENT;
+
+    if(xml.compare(tag.begin, 4, "<!--") == 0) return skipTo(xml, tag, tag.begin + 4, "-->");
+    if(xml.compare(tag.begin, 9, "<![CDATA[") == 0) return skipTo(xml, tag, tag.begin + 9, "]]>");
+    if(xml.compare(tag.begin, 2, "<?") == 0) return skipTo(xml, tag, tag.begin + 2, "?>");
+    if(xml.compare(tag.begin, 2, "<!") == 0) {
+        // A DOCTYPE internal subset can itself contain markup
+        auto end = xml.find('>', tag.begin);
+        if(end == std::string::npos || xml.find('[', tag.begin) < end) return TagResult::UNSUPPORTED;
+        return skipTo(xml, tag, tag.begin, ">");
+    }
+
+    auto position = tag.begin + 1;
+    if(position < xml.size() && xml[position] == '/') {
+        tag.closing = true;
+        ++position;
+    }
+    auto nameEnd = xml.find_first_of(" \t\r\n/>", position);
+    if(nameEnd == std::string::npos || nameEnd == position) return TagResult::UNSUPPORTED;
+    tag.name = xml.substr(position, nameEnd - position);
+
+    // Attribute values may contain '>'
+    char quote{0};
+    for(auto i = nameEnd; i != xml.size(); ++i) {
+        auto c = xml[i];
+        if(quote) {
+            if(c == quote) quote = 0;
+        } else if(c == '"' || c == '\'') {
+            quote = c;
+        } else if(c == '>') {
+            tag.end = i + 1;
+            tag.selfClosing = !tag.closing && xml[i - 1] == '/';
+            return TagResult::FOUND;
+        }
+    }
+    return TagResult::UNSUPPORTED;
+}
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string attribute(std::string const& tag, std::string const& name)
+{
+    std::size_t position{0};
+    while((position = tag.find(name, position)) != std::string::npos) {
+        auto start = position;
+        position += name.size();
+        if(start == 0 || !isSpace(tag[start - 1])) continue;
+        auto valueStart = position;
+        while(valueStart < tag.size() && isSpace(tag[valueStart])) ++valueStart;
+        if(valueStart == tag.size() || tag[valueStart] != '=') continue;
+        ++valueStart;
+        while(valueStart < tag.size() && isSpace(tag[valueStart])) ++valueStart;
+        if(valueStart == tag.size() || (tag[valueStart] != '"' && tag[valueStart] != '\'')) continue;
+        auto valueEnd = tag.find(tag[valueStart], valueStart + 1);
+        if(valueEnd == std::string::npos) return {};
+        return tag.substr(valueStart + 1, valueEnd - valueStart - 1);
+    }
+    return {};
+}
+
+bool isObjectsChannelFormat(std::string const& startTag)
+{
+    return attribute(startTag, "typeDefinition") == "Objects" || attribute(startTag, "typeLabel") == "0003";
+}
+
+}
+
+BlockFormatIndex::BlockFormatIndex(std::string xml) : xml{std::move(xml)}
+{
+    index();
+}
+
+std::string const& BlockFormatIndex::structuralXml() const
+{
+    return structure;
+}
+
+void BlockFormatIndex::releaseStructuralXml()
+{
+    std::string{}.swap(structure);
+}
+
+std::size_t BlockFormatIndex::indexedChannelCount() const
+{
+    return channels.size();
+}
+
+std::size_t BlockFormatIndex::indexedBlockCount() const
+{
+    std::size_t count{0};
+    for(auto const& channel : channels) {
+        count += channel.second.blockRanges.size();
+    }
+    return count;
+}
+
+void BlockFormatIndex::index()
+{
+    std::vector<std::string> openElements;
+    IndexedChannel* channel{nullptr};
+    std::size_t channelDepth{0};
+    auto blockStart = std::string::npos;
+    std::size_t copiedTo{0};
+
+    auto failed = [this]() {
+        channels.clear();
+        structure = std::move(xml);
+        std::string{}.swap(xml);
+    };
+    auto addBlock = [&](std::size_t begin, std::size_t end) {
+        channel->blockRanges.emplace_back(begin, end);
+        structure.append(xml, copiedTo, begin - copiedTo);
+        copiedTo = end;
+    };
+
+    Tag tag;
+    TagResult result;
+    for(std::size_t position{0}; (result = nextTag(xml, position, tag)) == TagResult::FOUND; position = tag.end) {
+        if(tag.markup) continue;
+
+        if(tag.closing) {
+            if(openElements.empty() || openElements.back() != tag.name) return failed();
+            openElements.pop_back();
+            if(channel && blockStart != std::string::npos && openElements.size() == channelDepth) {
+                addBlock(blockStart, tag.end);
+                blockStart = std::string::npos;
+            }
+            if(channel && openElements.size() < channelDepth) {
+                channel = nullptr;
+            }
+            continue;
+        }
+
+        if(channel && blockStart == std::string::npos &&
+           openElements.size() == channelDepth && tag.name == "audioBlockFormat") {
+            if(tag.selfClosing) {
+                addBlock(tag.begin, tag.end);
+            } else {
+                blockStart = tag.begin;
+            }
+        } else if(!channel && !tag.selfClosing && tag.name == "audioChannelFormat") {
+            auto startTag = xml.substr(tag.begin, tag.end - tag.begin);
+            if(isObjectsChannelFormat(startTag)) {
+                std::string id;
+                try {
+                    id = adm::formatId(adm::parseAudioChannelFormatId(attribute(startTag, "audioChannelFormatID")));
+                } catch(std::exception const&) {
+                    return failed(); // Leave it to the full parse to report
+                }
+                if(channels.count(id)) return failed();
+                channel = &channels[id];
+                channel->startTag = std::move(startTag);
+                channelDepth = openElements.size() + 1;
+            }
+        }
+        if(!tag.selfClosing) {
+            openElements.push_back(tag.name);
+        }
+    }
+    if(result == TagResult::UNSUPPORTED || !openElements.empty()) return failed();
+
+    structure.append(xml, copiedTo, std::string::npos);
+    for(auto it = channels.begin(); it != channels.end();) {
+        it = it->second.blockRanges.empty() ? channels.erase(it) : std::next(it);
+    }
+    if(channels.empty()) {
+        std::string{}.swap(xml);
+    }
+}
+
+std::string BlockFormatIndex::channelXml(IndexedChannel const& channel) const
+{
+    std::string channelDocument{"<ebuCoreMain><coreMetadata><format><audioFormatExtended>"};
+    channelDocument += channel.startTag;
+    for(auto const& range : channel.blockRanges) {
+        channelDocument.append(xml, range.first, range.second - range.first);
+    }
+    channelDocument += "</audioChannelFormat></audioFormatExtended></format></coreMetadata></ebuCoreMain>";
+    return channelDocument;
+}
+
+void BlockFormatIndex::loadBlockFormats(adm::AudioChannelFormat& channelFormat)
+{
+    std::lock_guard<std::mutex> lock{loadMutex};
+    auto id = channelFormat.get<adm::AudioChannelFormatId>();
+    auto channel = channels.find(adm::formatId(id));
+    if(channel == channels.end() || channel->second.loaded) return;
+
+    std::istringstream xmlStream{channelXml(channel->second)};
+    auto parsedDocument = adm::parseXml(xmlStream, adm::xml::ParserOptions::recursive_node_search);
+    auto parsedChannel = parsedDocument->lookup(id);
+    if(!parsedChannel) {
+        throw std::runtime_error("Could not parse the audioBlockFormats of " + channel->first);
+    }
+    for(auto const& block : parsedChannel->getElements<adm::AudioBlockFormatObjects>()) {
+        channelFormat.add(block);
+    }
+    channel->second.loaded = true;
+
+    bool allLoaded{true};
+    for(auto const& indexed : channels) {
+        allLoaded = allLoaded && indexed.second.loaded;
+    }
+    if(allLoaded) {
+        std::string{}.swap(xml);
+    }
+}
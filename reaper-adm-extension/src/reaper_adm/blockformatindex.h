@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace adm {
+  class AudioChannelFormat;
+}
+
+namespace admplug {
+
+/*
+Index of the audioBlockFormats of each Objects audioChannelFormat in an AXML document, by byte range.
+Dense object automation can run to millions of blocks, which are only needed when the envelopes for
+that channel are created. So the document is split in to the structure, without those blocks, which
+is parsed up front, and the blocks of each channel, which are parsed and added to it on first use.
+Other channel types are left in the structure, as their blocks decide how the channel is imported.
+*/
+class BlockFormatIndex
+{
+public:
+    explicit BlockFormatIndex(std::string xml);
+
+    // The document without the indexed blocks, or the whole document if it couldn't be indexed
+    std::string const& structuralXml() const;
+    void releaseStructuralXml();
+
+    std::size_t indexedChannelCount() const;
+    std::size_t indexedBlockCount() const;
+
+    // Adds the indexed blocks of the channel format with the same ID, once. Safe to call from any thread.
+    void loadBlockFormats(adm::AudioChannelFormat& channelFormat);
+
+private:
+    using ByteRange = std::pair<std::size_t, std::size_t>;
+    struct IndexedChannel {
+        std::string startTag;
+        std::vector<ByteRange> blockRanges;
+        bool loaded{false};
+    };
+
+    void index();
+    std::string channelXml(IndexedChannel const& channel) const;
+
+    std::string xml;
+    std::string structure;
+    std::map<std::string, IndexedChannel> channels;
+    std::mutex loadMutex;
+};
+
+}
@@ -1,31 +1,101 @@
 #include "channelrouter.h"
 #include "pcmreader.h"
 #include "pcmwriter.h"
+#include <algorithm>
+#include <array>
 #include <cassert>
 using namespace admplug;
 
+namespace {
+    // Frame-major de-interleave: each input frame is read once and each output frame written once.
+    // For common group widths the channel offsets are fixed at compile time so the inner loop unrolls.
+    template<std::size_t Width>
+    void gatherFixed(float const* input, std::size_t inputChannelCount,
+                     float* output, std::size_t outputChannelCount,
+                     std::size_t frames,
+                     std::size_t const* inputChannels, std::size_t const* outputChannels)
+    {
+        std::array<std::size_t, Width> from;
+        std::array<std::size_t, Width> to;
+        std::copy_n(inputChannels, Width, from.begin());
+        std::copy_n(outputChannels, Width, to.begin());
+        for(std::size_t frame = 0; frame != frames; ++frame) {
+            for(std::size_t n = 0; n != Width; ++n) {
+                output[to[n]] = input[from[n]];
+            }
+            input += inputChannelCount;
+            output += outputChannelCount;
+        }
+    }
+
+    void gather(float const* input, std::size_t inputChannelCount,
+                float* output, std::size_t outputChannelCount,
+                std::size_t frames,
+                std::vector<std::size_t> const& inputChannels, std::vector<std::size_t> const& outputChannels)
+    {
+        auto from = inputChannels.data();
+        auto to = outputChannels.data();
+        switch(inputChannels.size()) {
+        case 0: return;
+        case 1: return gatherFixed<1>(input, inputChannelCount, output, outputChannelCount, frames, from, to);
+        case 2: return gatherFixed<2>(input, inputChannelCount, output, outputChannelCount, frames, from, to);
+        case 4: return gatherFixed<4>(input, inputChannelCount, output, outputChannelCount, frames, from, to);
+        case 6: return gatherFixed<6>(input, inputChannelCount, output, outputChannelCount, frames, from, to);
+        case 8: return gatherFixed<8>(input, inputChannelCount, output, outputChannelCount, frames, from, to);
+        default: break;
+        }
+        for(std::size_t frame = 0; frame != frames; ++frame) {
+            for(std::size_t n = 0; n != inputChannels.size(); ++n) {
+                output[to[n]] = input[from[n]];
+            }
+            input += inputChannelCount;
+            output += outputChannelCount;
+        }
+    }
+}
 
 ChannelRouter::ChannelRouter(std::unique_ptr<IPCMWriter> pcmWriter, std::vector<int> channelIndices) : writer{std::move(pcmWriter)}, channelIndices{channelIndices}
-{ }
+{
+    for(std::size_t outputChannel = 0; outputChannel != channelIndices.size(); ++outputChannel) {
+        auto channelIndex = channelIndices[outputChannel];
+        if(channelIndex >= 0) {
+            inputChannels.push_back(static_cast<std::size_t>(channelIndex));
+            outputChannels.push_back(outputChannel);
+        }
+    }
+    // A run of consecutive input channels with no gaps can be copied a frame at a time
+    contiguous = !channelIndices.empty() && inputChannels.size() == channelIndices.size();
+    for(std::size_t n = 1; contiguous && n < inputChannels.size(); ++n) {
+        contiguous = inputChannels[n] == inputChannels[n - 1] + 1;
+    }
+}
 
 void ChannelRouter::write(const IPCMBlock &block)
 {
-    std::vector<float> buffer(channelIndices.size() * block.frameCount(), 0);
-    std::size_t outputChannelIndex = 0;
-    for(auto channelIndex : channelIndices) {
-        for(std::size_t frameNumber = 0;  frameNumber != block.frameCount(); ++frameNumber) {
-            auto outputPosition = frameNumber * channelIndices.size() + outputChannelIndex;
-            if(channelIndex < 0) {
-                // -1 is used for undefined tracks - they need to produce a zerod take channel
-                buffer[outputPosition] = 0.0;
-            } else {
-                auto inputPosition = frameNumber * block.channelCount() + static_cast<std::size_t>(channelIndex);
-                buffer[outputPosition] = block.data()[inputPosition];
-            }
+    auto frames = block.frameCount();
+    auto inputChannelCount = block.channelCount();
+    auto outputChannelCount = channelIndices.size();
+    auto const& input = block.data();
+    assert(std::all_of(inputChannels.begin(), inputChannels.end(), [inputChannelCount](std::size_t channel) { return channel < inputChannelCount; }));
+
+    // Positions for undefined tracks are never written, so stay zero from when the buffer grew
+    buffer.resize(outputChannelCount * frames, 0.0f);
+
+    if(contiguous && inputChannels.front() == 0 && outputChannelCount == inputChannelCount) {
+        std::copy_n(input.data(), buffer.size(), buffer.data());
+    } else if(contiguous) {
+        auto from = input.data() + inputChannels.front();
+        auto to = buffer.data();
+        for(std::size_t frame = 0; frame != frames; ++frame) {
+            std::copy_n(from, outputChannelCount, to);
+            from += inputChannelCount;
+            to += outputChannelCount;
         }
-        outputChannelIndex += 1;
+    } else {
+        gather(input.data(), inputChannelCount, buffer.data(), outputChannelCount, frames, inputChannels, outputChannels);
     }
-    PCMProcessBlock outputBlock{buffer, block, channelIndices.size()};
+
+    PCMProcessBlock outputBlock{buffer, block, outputChannelCount};
     writer->write(outputBlock);
 }
 
@@ -33,4 +103,3 @@ std::string ChannelRouter::fileName()
 {
     return writer->fileName();
 }
-
@@ -15,6 +15,12 @@ public:
 private:
     std::unique_ptr<IPCMWriter> writer;
     std::vector<int> channelIndices;
+    // Gathered (input channel, output channel) pairs - undefined tracks (-1) are left out, as their channels stay zeroed
+    std::vector<std::size_t> inputChannels;
+    std::vector<std::size_t> outputChannels;
+    bool contiguous;
+    // Reused between blocks, so each write only allocates if the block is larger than any before
+    std::vector<float> buffer;
 };
 
 }
@@ -0,0 +1,364 @@
+#include "channelselectsource.h"
+#include "reaperapi.h"
+#include <helper/mapped_file.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+using namespace admplug;
+
+namespace {
+    std::shared_ptr<ReaperAPI> registeredApi;
+
+    PCM_source* createFromType(const char* type, int priority)
+    {
+        if(registeredApi && std::strcmp(type, ChannelSelectSource::TYPE) == 0) {
+            return new ChannelSelectSource(*registeredApi);
+        }
+        return nullptr;
+    }
+
+    PCM_source* createFromFile(const char* filename, int priority)
+    {
+        return nullptr; // Only created by import, or from project state
+    }
+
+    const char* enumFileExtensions(int i, const char** descptr)
+    {
+        return nullptr;
+    }
+
+    pcmsrc_register_t sourceRegistration{ createFromType, createFromFile, enumFileExtensions };
+
+    // Of the file, whatever its channel count
+    constexpr std::size_t READ_AHEAD_BYTES{ 1 << 20 };
+
+    std::string channelList(std::vector<int> const& channels, char separator)
+    {
+        std::ostringstream op;
+        for(std::size_t i = 0; i != channels.size(); ++i) {
+            if(i != 0) op << separator;
+            op << channels[i];
+        }
+        return op.str();
+    }
+}
+
+ChannelSelectDecoder::ChannelSelectDecoder(std::string fileName, std::vector<int> channels) :
+    fileName{std::move(fileName)},
+    channels{std::move(channels)},
+    name{peaksName(this->fileName, this->channels)}
+{
+}
+
+ChannelSelectDecoder::~ChannelSelectDecoder() = default;
+
+ISimpleMediaDecoder* ChannelSelectDecoder::Duplicate()
+{
+    return new ChannelSelectDecoder(fileName, channels);
+}
+
+void ChannelSelectDecoder::Open(const char* filename, int diskreadmode, int diskreadbs, int diskreadnb)
+{
+    // filename is the name given to REAPER for peaks, not a real file - the original file is always read
+    Close(true);
+    // Only mapped whilst the headers are parsed
+    if(auto file = MappedFile::open(fileName)) {
+        try {
+            format = parseBw64SampleFormat(file->data(), file->size(), fileName);
+        } catch(std::exception const&) {
+            format.reset();
+        }
+    }
+}
+
+void ChannelSelectDecoder::Close(bool fullClose)
+{
+    format.reset();
+    readAheadStart = 0;
+    readAheadFrames = 0;
+    if(fullClose) {
+        fileWindow = {};
+        readAhead = {};
+    }
+}
+
+const char* ChannelSelectDecoder::GetFileName()
+{
+    return name.c_str();
+}
+
+const char* ChannelSelectDecoder::GetType()
+{
+    return ChannelSelectSource::TYPE;
+}
+
+void ChannelSelectDecoder::GetInfoString(char* buf, int buflen, char* title, int titlelen)
+{
+    std::ostringstream op;
+    op << "File: " << fileName << "\r\n";
+    op << "Channels (0 based, -1 silent): " << channelList(channels, ' ') << "\r\n";
+    if(format) {
+        op << "Sample rate: " << format->sampleRate << " Hz\r\n";
+        op << "Bit depth: " << format->bitDepth << (format->isFloat ? " float" : "") << "\r\n";
+    }
+    if(buf && buflen > 0) {
+        std::snprintf(buf, static_cast<std::size_t>(buflen), "%s", op.str().c_str());
+    }
+    if(title && titlelen > 0) {
+        std::snprintf(title, static_cast<std::size_t>(titlelen), "%s", "ADM Channel Source Properties");
+    }
+}
+
+bool ChannelSelectDecoder::IsOpen()
+{
+    return format.has_value();
+}
+
+int ChannelSelectDecoder::GetNumChannels()
+{
+    return static_cast<int>(channels.size());
+}
+
+int ChannelSelectDecoder::GetBitsPerSample()
+{
+    return format ? static_cast<int>(format->bitDepth) : 0;
+}
+
+double ChannelSelectDecoder::GetSampleRate()
+{
+    return format ? static_cast<double>(format->sampleRate) : 0.0;
+}
+
+INT64 ChannelSelectDecoder::GetLength()
+{
+    return format ? static_cast<INT64>(format->frames) : 0;
+}
+
+INT64 ChannelSelectDecoder::GetPosition()
+{
+    return position;
+}
+
+void ChannelSelectDecoder::SetPosition(INT64 pos)
+{
+    position = std::max<INT64>(pos, 0);
+}
+
+int ChannelSelectDecoder::ReadSamples(ReaSample* buf, int length)
+{
+    if(!format || length <= 0) return 0;
+
+    auto const outputChannelCount = static_cast<INT64>(channels.size());
+    auto framesLeft = std::min<INT64>(length, GetLength() - position);
+    int framesRead = 0;
+    while(framesLeft > 0) {
+        if(position < readAheadStart || position >= readAheadStart + readAheadFrames) {
+            if(!fillReadAhead(position)) break;
+        }
+        auto offset = position - readAheadStart;
+        auto frames = std::min(framesLeft, readAheadFrames - offset);
+        auto input = readAhead.data() + offset * outputChannelCount;
+        auto output = buf + static_cast<INT64>(framesRead) * outputChannelCount;
+        std::copy(input, input + frames * outputChannelCount, output);
+        position += frames;
+        framesRead += static_cast<int>(frames);
+        framesLeft -= frames;
+    }
+    return framesRead;
+}
+
+std::string ChannelSelectDecoder::peaksName(std::string const& fileName, std::vector<int> const& channels)
+{
+    return fileName + ".ch" + channelList(channels, '_');
+}
+
+bool ChannelSelectDecoder::fillReadAhead(INT64 from)
+{
+    auto const frameBytes = format->frameBytes();
+    auto const windowFrames = std::max<std::size_t>(READ_AHEAD_BYTES / frameBytes, 1);
+    fileWindow.resize(windowFrames * frameBytes);
+    readAhead.resize(windowFrames * channels.size());
+    readAheadStart = from;
+    readAheadFrames = 0;
+
+    // Reads whatever is there now, which is less than expected if the file has been truncated since it was opened
+    std::ifstream file{ fileName, std::ios::binary };
+    if(!file.seekg(static_cast<std::streamoff>(format->dataOffset + static_cast<uint64_t>(from) * frameBytes))) return false;
+    auto const wanted = std::min<INT64>(static_cast<INT64>(windowFrames), GetLength() - from);
+    file.read(fileWindow.data(), static_cast<std::streamsize>(wanted * static_cast<INT64>(frameBytes)));
+    auto const frames = static_cast<std::size_t>(file.gcount()) / frameBytes;
+
+    convertSelectedChannels(reinterpret_cast<unsigned char const*>(fileWindow.data()), frames, *format, channels, readAhead.data());
+    readAheadFrames = static_cast<INT64>(frames);
+    return readAheadFrames > 0;
+}
+
+ChannelSelectSource::ChannelSelectSource(ReaperAPI const& api, std::string fileName, std::vector<int> channels) :
+    api{api},
+    fileName{std::move(fileName)},
+    channels{std::move(channels)}
+{
+    createSource();
+}
+
+ChannelSelectSource::ChannelSelectSource(ReaperAPI const& api) : api{api}
+{
+}
+
+ChannelSelectSource::~ChannelSelectSource() = default;
+
+bool ChannelSelectSource::registerType(std::shared_ptr<ReaperAPI> api, reaper_plugin_info_t* rec)
+{
+    registeredApi = std::move(api);
+    return rec->Register("pcmsrc", &sourceRegistration) != 0;
+}
+
+void ChannelSelectSource::createSource()
+{
+    auto name = ChannelSelectDecoder::peaksName(fileName, channels);
+    // The REAPER source takes ownership of the decoder
+    source.reset(api.PCM_Source_CreateFromSimple(new ChannelSelectDecoder(fileName, channels), name.c_str()));
+}
+
+PCM_source* ChannelSelectSource::Duplicate()
+{
+    return new ChannelSelectSource(api, fileName, channels);
+}
+
+bool ChannelSelectSource::IsAvailable()
+{
+    return source && source->IsAvailable();
+}
+
+void ChannelSelectSource::SetAvailable(bool avail)
+{
+    if(source) source->SetAvailable(avail);
+}
+
+const char* ChannelSelectSource::GetType()
+{
+    return TYPE;
+}
+
+const char* ChannelSelectSource::GetFileName()
+{
+    return fileName.c_str();
+}
+
+bool ChannelSelectSource::SetFileName(const char* newfn)
+{
+    if(!newfn) return false;
+    fileName = newfn;
+    createSource();
+    return true;
+}
+
+int ChannelSelectSource::GetNumChannels()
+{
+    return static_cast<int>(channels.size());
+}
+
+double ChannelSelectSource::GetSampleRate()
+{
+    return source ? source->GetSampleRate() : 0.0;
+}
+
+double ChannelSelectSource::GetLength()
+{
+    return source ? source->GetLength() : 0.0;
+}
+
+int ChannelSelectSource::GetBitsPerSample()
+{
+    return source ? source->GetBitsPerSample() : 0;
+}
+
+int ChannelSelectSource::PropertiesWindow(HWND hwndParent)
+{
+    return source ? source->PropertiesWindow(hwndParent) : -1;
+}
+
+void ChannelSelectSource::GetSamples(PCM_source_transfer_t* block)
+{
+    if(source) {
+        source->GetSamples(block);
+    } else {
+        block->samples_out = 0;
+    }
+}
+
+void ChannelSelectSource::GetPeakInfo(PCM_source_peaktransfer_t* block)
+{
+    if(source) {
+        source->GetPeakInfo(block);
+    } else {
+        block->peaks_out = 0;
+    }
+}
+
+void ChannelSelectSource::SaveState(ProjectStateContext* ctx)
+{
+    ctx->AddLine("FILE \"%s\"", fileName.c_str());
+    ctx->AddLine("CHANNELS %s", channelList(channels, ' ').c_str());
+}
+
+int ChannelSelectSource::LoadState(const char* firstline, ProjectStateContext* ctx)
+{
+    std::string loadedFileName;
+    std::vector<int> loadedChannels;
+    char line[4096];
+    while(ctx->GetLine(line, sizeof(line)) == 0) {
+        char const* start = line;
+        while(*start == ' ' || *start == '\t') ++start;
+        if(*start == '>') break;
+
+        std::string text{start};
+        if(text.rfind("FILE ", 0) == 0) {
+            auto open = text.find('"');
+            auto close = text.rfind('"');
+            if(open != std::string::npos && close > open) {
+                loadedFileName = text.substr(open + 1, close - open - 1);
+            }
+        } else if(text.rfind("CHANNELS", 0) == 0) {
+            std::istringstream ip{text.substr(8)};
+            int channel;
+            while(ip >> channel) {
+                loadedChannels.push_back(channel);
+            }
+        }
+    }
+    if(loadedFileName.empty()) return -1;
+
+    fileName = loadedFileName;
+    channels = loadedChannels;
+    createSource();
+    return 0;
+}
+
+void ChannelSelectSource::Peaks_Clear(bool deleteFile)
+{
+    if(source) source->Peaks_Clear(deleteFile);
+}
+
+int ChannelSelectSource::PeaksBuild_Begin()
+{
+    return source ? source->PeaksBuild_Begin() : 0;
+}
+
+int ChannelSelectSource::PeaksBuild_Run()
+{
+    return source ? source->PeaksBuild_Run() : 0;
+}
+
+void ChannelSelectSource::PeaksBuild_Finish()
+{
+    if(source) source->PeaksBuild_Finish();
+}
+
+int ChannelSelectSource::Extended(int call, void* parm1, void* parm2, void* parm3)
+{
+    return source ? source->Extended(call, parm1, parm2, parm3) : 0;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include "reaper_plugin.h"
+#include "pcmreader.h"
+
+namespace admplug {
+
+class ReaperAPI;
+
+/*
+Decodes selected channels of a BW64 file, in the given order (-1 for a silent channel).
+Reads ahead in windows of the file, converting only the selected channels, so sequential playback converts each
+sample it plays once. The file is opened for each window rather than held open or mapped for the session, so it can
+be overwritten or truncated whilst in use - playback then stops short instead of faulting.
+*/
+class ChannelSelectDecoder : public ISimpleMediaDecoder
+{
+public:
+    ChannelSelectDecoder(std::string fileName, std::vector<int> channels);
+    ~ChannelSelectDecoder() override;
+
+    ISimpleMediaDecoder* Duplicate() override;
+    void Open(const char* filename, int diskreadmode, int diskreadbs, int diskreadnb) override;
+    void Close(bool fullClose) override;
+    const char* GetFileName() override;
+    const char* GetType() override;
+    void GetInfoString(char* buf, int buflen, char* title, int titlelen) override;
+    bool IsOpen() override;
+    int GetNumChannels() override;
+    int GetBitsPerSample() override;
+    double GetSampleRate() override;
+    INT64 GetLength() override;
+    INT64 GetPosition() override;
+    void SetPosition(INT64 pos) override;
+    int ReadSamples(ReaSample* buf, int length) override;
+
+    // Unique per file and channel selection, so each selection gets its own peaks file
+    static std::string peaksName(std::string const& fileName, std::vector<int> const& channels);
+
+private:
+    bool fillReadAhead(INT64 from);
+
+    std::string fileName;
+    std::vector<int> channels;
+    std::string name;
+    std::optional<Bw64SampleFormat> format;
+    INT64 position{ 0 };
+    std::vector<char> fileWindow;
+    std::vector<float> readAhead;
+    INT64 readAheadStart{ 0 };
+    INT64 readAheadFrames{ 0 };
+};
+
+/*
+Take source playing selected channels of the original BW64 file in place, for import without extracting stem files.
+Playback, resampling and peaks are handled by a REAPER source wrapping a ChannelSelectDecoder;
+this adds saving and restoring the file and channel selection with the project.
+*/
+class ChannelSelectSource : public PCM_source
+{
+public:
+    static constexpr char const* TYPE{ "ADM_CHANNELS" };
+
+    ChannelSelectSource(ReaperAPI const& api, std::string fileName, std::vector<int> channels);
+    explicit ChannelSelectSource(ReaperAPI const& api); // Selection to follow from LoadState()
+    ~ChannelSelectSource() override;
+
+    // Lets REAPER recreate these sources when loading projects - call once at startup
+    static bool registerType(std::shared_ptr<ReaperAPI> api, reaper_plugin_info_t* rec);
+
+    PCM_source* Duplicate() override;
+    bool IsAvailable() override;
+    void SetAvailable(bool avail) override;
+    const char* GetType() override;
+    const char* GetFileName() override;
+    bool SetFileName(const char* newfn) override;
+    int GetNumChannels() override;
+    double GetSampleRate() override;
+    double GetLength() override;
+    int GetBitsPerSample() override;
+    int PropertiesWindow(HWND hwndParent) override;
+    void GetSamples(PCM_source_transfer_t* block) override;
+    void GetPeakInfo(PCM_source_peaktransfer_t* block) override;
+    void SaveState(ProjectStateContext* ctx) override;
+    int LoadState(const char* firstline, ProjectStateContext* ctx) override;
+    void Peaks_Clear(bool deleteFile) override;
+    int PeaksBuild_Begin() override;
+    int PeaksBuild_Run() override;
+    void PeaksBuild_Finish() override;
+    int Extended(int call, void* parm1, void* parm2, void* parm3) override;
+
+private:
+    void createSource();
+
+    ReaperAPI const& api;
+    std::string fileName;
+    std::vector<int> channels;
+    std::unique_ptr<PCM_source> source;
+};
+
+}
@@ -33,17 +33,38 @@ void CommunicatorBase::endSocket() {
 
 void CommunicatorBase::setRenderingState(bool state) {
     if(renderingState == state) return;
+    if(state) {
+        prepareRender();
+        endOfStream = false;
+        latestBlockMessage.reset();
+        samplesRing.reset();
+    }
+    if(state && samplesPort > 0) {
+        // Must attach before StartRender - the plugin decides which transport to use on receipt
+        samplesRing = SharedSamplesRing::open(samplesPort);
+        if(samplesRing) samplesRing->setReaderAttached(true);
+    }
+    // On StopRender, the plugin marks the end of the stream after its last block.
+    // Frames still queued can be read until isEndOfStream().
     commandSocket.doCommand(state? commandSocket.Command::StartRender : commandSocket.Command::StopRender);
     renderingState = state;
 }
 
 bool CommunicatorBase::nextFrameAvailable() {
     if(getReportedChannelCount() == 0) return false;
+    if(samplesRing) {
+        return samplesRing->readableFrames() > 0 || samplesRing->waitForFrame(100);
+    }
     if (latestBlockMessage == nullptr || latestBlockMessage->atSeqReadEnd()) {
         // Need next block
         latestBlockMessage.reset();
+        if(endOfStream) return false;
         latestBlockMessage = samplesSocket.receiveBlock();
-        if (!latestBlockMessage->success() || latestBlockMessage->getSize() <= 0) {
+        if (latestBlockMessage->success() && latestBlockMessage->getSize() == 0) {
+            // Zero-length block marks the end of the stream
+            endOfStream = true;
+            latestBlockMessage.reset();
+        } else if (!latestBlockMessage->success() || latestBlockMessage->getSize() <= 0) {
             assert(latestBlockMessage->getResult() == NNG_EAGAIN || latestBlockMessage->getResult() == NNG_ETIMEDOUT);
             latestBlockMessage.reset();
         }
@@ -51,10 +72,25 @@ bool CommunicatorBase::nextFrameAvailable() {
     return latestBlockMessage != nullptr;
 }
 
+bool CommunicatorBase::isEndOfStream() {
+    if(samplesRing) return samplesRing->endOfStream();
+    return endOfStream && (latestBlockMessage == nullptr || latestBlockMessage->atSeqReadEnd());
+}
+
+uint64_t CommunicatorBase::getDroppedFrames() {
+    return samplesRing? samplesRing->droppedFrames() : 0;
+}
+
 bool CommunicatorBase::copyNextFrame(float* buf, bool bypassAvailabilityCheck) {
     if(!bypassAvailabilityCheck && !nextFrameAvailable()) return false;
 
     // No specific channels to extract - dump entire frame
+    if(samplesRing) {
+        auto frame = samplesRing->currentFrame();
+        std::copy(frame, frame + getReportedChannelCount(), buf);
+        samplesRing->advanceFrame();
+        return true;
+    }
     if(latestBlockMessage->seqReadAndPut(buf, getReportedChannelCount())) {
         return true;
     } else {
@@ -66,6 +102,45 @@ bool CommunicatorBase::copyNextFrame(float* buf, bool bypassAvailabilityCheck) {
     }
 }
 
+int CommunicatorBase::framesAvailable() {
+    int streamedChannels = samplesRing? (int)samplesRing->getFrameChannels() : getStreamedChannelCount();
+    if(streamedChannels == 0) return 0;
+    if(samplesRing) return (int)samplesRing->contiguousReadableFrames();
+    if(!latestBlockMessage) return 0;
+    return latestBlockMessage->getSeqReadRemaining() / streamedChannels;
+}
+
+bool CommunicatorBase::copyNextFrames(float* buf, int frameCount, int stride) {
+    int channels = getReportedChannelCount();
+    assert(frameCount <= framesAvailable());
+
+    if(samplesRing) {
+        auto frame = samplesRing->currentFrame();
+        int frameChannels = (int)samplesRing->getFrameChannels();
+        if(stride == channels && frameChannels == channels) {
+            std::copy(frame, frame + (size_t)frameCount * channels, buf);
+        } else {
+            for(int i = 0; i < frameCount; ++i) {
+                std::copy(frame, frame + channels, buf);
+                frame += frameChannels;
+                buf += stride;
+            }
+        }
+        samplesRing->advanceFrames(frameCount);
+        return true;
+    }
+
+    if(stride == channels) {
+        // Contiguous run - straight out of the message
+        return latestBlockMessage->seqReadAndPut(buf, frameCount * channels);
+    }
+    for(int i = 0; i < frameCount; ++i) {
+        if(!latestBlockMessage->seqReadAndPut(buf, channels)) return false;
+        buf += stride;
+    }
+    return true;
+}
+
 CommunicatorRegistry & CommunicatorRegistry::getInstance()
 {
     static CommunicatorRegistry instance; // Guaranteed to be destroyed, Instantiated on first use.
@@ -1,5 +1,6 @@
 #pragma once
 #include "helper/nng_wrappers.h"
+#include "helper/shared_samples_ring.h"
 
 class CommunicatorBase
 {
@@ -14,6 +15,15 @@ public:
 
     virtual bool nextFrameAvailable();
     virtual bool copyNextFrame(float* buf, bool bypassAvailabilityCheck = false);
+    // Frames which can be copied without waiting - call nextFrameAvailable() to wait for more
+    int framesAvailable();
+    // Copies `frameCount` frames (at most framesAvailable()) of getReportedChannelCount() channels
+    // to `buf`, with the start of each frame `stride` floats apart
+    virtual bool copyNextFrames(float* buf, int frameCount, int stride);
+    // True once the plugin has signalled the end of the render's stream and every frame has been read
+    bool isEndOfStream();
+    // Frames the plugin skipped because the extension fell too far behind
+    uint64_t getDroppedFrames();
 
     virtual int getReportedSampleRate() { return 0; }
     virtual int getReportedChannelCount() { return 0; }
@@ -24,6 +34,10 @@ public:
 protected:
     void startSocket();
     void endSocket();
+    // Called before StartRender is sent, to negotiate what the plugin streams
+    virtual void prepareRender() {}
+    // Channels per frame as streamed by the plugin
+    virtual int getStreamedChannelCount() { return getReportedChannelCount(); }
 
     int commandPort;
     int samplesPort;
@@ -33,6 +47,9 @@ protected:
     CommandSender commandSocket;
 
     std::shared_ptr<TypedNngMsg<float>> latestBlockMessage;
+    // Set for the duration of a render if the plugin offers a shared-memory ring
+    std::unique_ptr<SharedSamplesRing> samplesRing;
+    bool endOfStream{ false };
 };
 
 class CommunicatorRegistry
@@ -14,4 +14,13 @@ namespace admplug {
           return false;
       }
   };
+
+  // Identity of the element held, so element lists can be hashed as well as compared
+  class ElementAddress : public boost::static_visitor<void const*> {
+  public:
+      template<typename T>
+      void const* operator()(T const& element) const {
+          return element.get();
+      }
+  };
 }
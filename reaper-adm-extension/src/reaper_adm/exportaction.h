@@ -5,6 +5,7 @@
 #include <memory>
 #include "exportaction_pcmsink.h"
 #include "exportaction_dialogcontrol.h"
+#include "sampleformat.h"
 #include "helper/nng_wrappers.h"
 
 namespace admplug {
@@ -34,6 +35,12 @@ namespace admplug {
                 return (*((int *)cfg) == SINK_FOURCC);
             }
 
+            // Config follows the FOURCC with the SampleFormat as a little-endian int
+            static SampleFormat getSampleFormat(const void *cfg, int cfg_l) {
+                if (!cfg || cfg_l < 8) return SampleFormat::PCM24;
+                return toSampleFormat(REAPER_MAKELEINT(((const int *)cfg)[1]));
+            }
+
         } ExportInfo;
 
     private:
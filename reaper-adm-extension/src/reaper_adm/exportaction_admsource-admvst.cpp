@@ -1,6 +1,7 @@
 #include "exportaction_admsource-admvst.h"
 
 #include "pluginregistry.h"
+#include "exportaction_axmlchunk.h"
 #include <version/eps_version.h>
 
 #include <adm/adm.hpp>
@@ -8,6 +9,8 @@
 #include <adm/write.hpp>
 #include <adm/common_definitions.hpp>
 
+#include <algorithm>
+
 namespace {
 std::vector<adm::TypeDescriptor> getAdmTypeDefinitionsExcluding(adm::TypeDescriptor exclude) {
 	std::vector<adm::TypeDescriptor> otherTypes;
@@ -158,10 +161,15 @@ void AdmVstExportSources::updateErrorsWarningsInfo(ReaperAPI const& api)
 	if (knownSampleRate == 0) errorStrings.push_back("Unable to determine sample rate from VSTs");
 	if (!sampleRatesMatch) errorStrings.push_back("VSTs are reporting conflicting sample rates");
 
+	BlockSimplificationStats blockSimplification;
 	for (auto& candidate : candidatesForExport) {
 		for (auto& admAuthoringError : *(candidate->getAdmAuthoringErrors())) {
 			warningStrings.push_back(admAuthoringError.what());
 		}
+		blockSimplification += candidate->blockSimplification;
+	}
+	if (blockSimplification.blocksIn > 0) {
+		infoStrings.push_back(blockSimplification.summary());
 	}
 
 
@@ -187,13 +195,53 @@ int AdmVstExportSources::getTotalExportChannels()
 
 void AdmVstExportSources::setRenderInProgress(bool state)
 {
+	if (state) startMultiplexedStream();
 	for (auto& candidate : candidatesForExport) {
-		candidate->setRenderInProgressState(true);
+		candidate->setRenderInProgressState(state);
 	}
 }
 
+void AdmVstExportSources::startMultiplexedStream()
+{
+	multiplexedRing.reset();
+
+	// Streams are laid out in the same order as writeNextFrameTo fills a frame
+	std::vector<AdmVstCommunicator*> streamCommunicators;
+	std::vector<uint32_t> streamChannels;
+	uint32_t blockSize = 0;
+	for (auto& candidate : candidatesForExport) {
+		auto communicator = candidate->getCommunicator(true);
+		if (!communicator) return;
+		communicator->updateInfo();
+		// Older plugins would not reply to the join command
+		if (!communicator->supportsMultiplexedSamples()) return;
+		if (communicator->getReportedChannelCount() > 0) {
+			streamCommunicators.push_back(communicator);
+			streamChannels.push_back(communicator->getReportedChannelCount());
+			blockSize = std::max(blockSize, communicator->getReportedBlockSize());
+		}
+	}
+
+	auto ring = MultiplexedSamplesRing::create(streamChannels, blockSize);
+	if (!ring || static_cast<int>(ring->getFrameChannels()) != getTotalExportChannels()) return;
+
+	for (uint32_t stream = 0; stream < streamCommunicators.size(); ++stream) {
+		if (!streamCommunicators[stream]->joinMultiplexedStream(ring->getToken(), stream)) {
+			// Fall back to the samples sockets for all of them
+			for (uint32_t joined = 0; joined < stream; ++joined) {
+				streamCommunicators[joined]->joinMultiplexedStream(0, 0);
+			}
+			return;
+		}
+	}
+	multiplexedRing = std::move(ring);
+}
+
 bool AdmVstExportSources::isFrameAvailable()
 {
+	if (multiplexedRing) {
+		return multiplexedRing->readableFrames() > 0 || multiplexedRing->waitForFrame(100);
+	}
 	for (auto& candidate : candidatesForExport) {
 		auto communicator = candidate->getCommunicator();
 		if (!communicator || !communicator->nextFrameAvailable()) {
@@ -203,10 +251,30 @@ bool AdmVstExportSources::isFrameAvailable()
 	return true;
 }
 
+bool AdmVstExportSources::isEndOfStream()
+{
+	if (multiplexedRing) return multiplexedRing->endOfStream();
+	// Frames need data from every candidate, so once any has finished, no more will follow
+	for (auto& candidate : candidatesForExport) {
+		auto communicator = candidate->getCommunicator();
+		if (communicator && communicator->isEndOfStream()) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool AdmVstExportSources::writeNextFrameTo(float* bufferWritePointer, bool skipFrameAvailableCheck)
 {
 	if (!skipFrameAvailableCheck && !isFrameAvailable()) return false;
 
+	if (multiplexedRing) {
+		auto frame = multiplexedRing->currentFrame();
+		std::copy(frame, frame + multiplexedRing->getFrameChannels(), bufferWritePointer);
+		multiplexedRing->advanceFrames(1);
+		return true;
+	}
+
 	for (auto& candidate : candidatesForExport) {
 		auto communicator = candidate->getCommunicator();
 		if (communicator->getReportedChannelCount() > 0) {
@@ -219,14 +287,57 @@ bool AdmVstExportSources::writeNextFrameTo(float* bufferWritePointer, bool skipF
 	return true;
 }
 
-std::shared_ptr<bw64::AxmlChunk> AdmVstExportSources::getAxmlChunk()
+int AdmVstExportSources::writeNextFramesTo(float* bufferWritePointer, int maxFrames)
 {
-	std::stringstream xmlStream;
-	adm::writeXml(xmlStream, admDocument);
-	xmlStream << "<!-- Produced using the EAR Production Suite (version ";
-	xmlStream << (eps::versionInfoAvailable() ? eps::currentVersion() : "unknown");
-	xmlStream << "), from ADM Export Source plugins -->\n";
-	return std::make_shared<bw64::AxmlChunk>(bw64::AxmlChunk(xmlStream.str()));
+	int stride = getTotalExportChannels();
+	int written = 0;
+
+	if (multiplexedRing) {
+		// Frames are already laid out as the sink wants them
+		while (written < maxFrames && isFrameAvailable()) {
+			int run = static_cast<int>(std::min<uint32_t>(multiplexedRing->contiguousReadableFrames(), maxFrames - written));
+			auto frames = multiplexedRing->currentFrame();
+			std::copy(frames, frames + static_cast<size_t>(run) * stride, bufferWritePointer);
+			multiplexedRing->advanceFrames(run);
+			bufferWritePointer += static_cast<size_t>(run) * stride;
+			written += run;
+		}
+		return written;
+	}
+
+	while (written < maxFrames && isFrameAvailable()) {
+		// Each candidate fills its own channels of the frame, so only copy as many frames as all of them have ready
+		int run = maxFrames - written;
+		for (auto& candidate : candidatesForExport) {
+			auto communicator = candidate->getCommunicator();
+			if (communicator->getReportedChannelCount() > 0) {
+				run = std::min(run, communicator->framesAvailable());
+			}
+		}
+		if (run <= 0) break;
+
+		float* channelWritePointer = bufferWritePointer;
+		for (auto& candidate : candidatesForExport) {
+			auto communicator = candidate->getCommunicator();
+			if (communicator->getReportedChannelCount() > 0) {
+				if (!communicator->copyNextFrames(channelWritePointer, run, stride)) {
+					throw std::runtime_error("copyNextFrames failed");
+				}
+				channelWritePointer += communicator->getReportedChannelCount();
+			}
+		}
+		bufferWritePointer += static_cast<size_t>(run) * stride;
+		written += run;
+	}
+	return written;
+}
+
+std::shared_ptr<bw64::Chunk> AdmVstExportSources::getAxmlChunk()
+{
+	std::string trailer("<!-- Produced using the EAR Production Suite (version ");
+	trailer += (eps::versionInfoAvailable() ? eps::currentVersion() : "unknown");
+	trailer += "), from ADM Export Source plugins -->\n";
+	return std::make_shared<StreamingAxmlChunk>(admDocument, trailer);
 }
 
 std::shared_ptr<bw64::ChnaChunk> AdmVstExportSources::getChnaChunk()
@@ -635,6 +746,7 @@ void AdmVstExporter::createAndAddAudioBlocks(adm::TypeDescriptor typeDescriptor,
 template<typename AudioBlockFormatType>
 void AdmVstExporter::addBlockFormatsToChannelFormat(std::optional<std::vector<std::shared_ptr<AudioBlockFormatType>>> blocks, std::shared_ptr<AdmSubgraphElements> subgraph) {
 	assert(blocks.has_value());
+	blockSimplification += simplifyBlockFormats(*blocks);
 	blockCount = (*blocks).size();
 	for (auto& block : *blocks) {
 		subgraph->audioChannelFormat->add(*block);
@@ -733,6 +845,23 @@ void AdmVstCommunicator::infoExchange()
 	memcpy(&admTypeDefinition, (char*)resp->getBufferPointer() + 5, 2);
 	memcpy(&admPackFormatId, (char*)resp->getBufferPointer() + 7, 2);
 	memcpy(&admChannelFormatId, (char*)resp->getBufferPointer() + 9, 2);
+	// Older plugins send only the fields above
+	capabilities = 0;
+	blockSize = 0;
+	if (resp->getSize() >= 16) {
+		memcpy(&capabilities, (char*)resp->getBufferPointer() + 11, 1);
+		memcpy(&blockSize, (char*)resp->getBufferPointer() + 12, 4);
+	}
 
 	infoReceived = true;
+}
+
+bool AdmVstCommunicator::joinMultiplexedStream(uint32_t token, uint32_t stream)
+{
+	if (!supportsMultiplexedSamples()) return false;
+	auto resp = commandSocket.sendMultiplexedStream(token, stream);
+	if (!resp->success() || resp->getSize() != sizeof(uint8_t)) return false;
+	uint8_t cmd;
+	memcpy(&cmd, resp->getBufferPointer(), sizeof(uint8_t));
+	return cmd == commandSocket.Command::SetMultiplexedStreamResp;
 }
\ No newline at end of file
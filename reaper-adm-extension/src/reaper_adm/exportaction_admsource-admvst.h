@@ -5,9 +5,11 @@
 #include "communicators.h"
 #include "exportaction_issues.h"
 #include "exportaction_parameterprocessing.h"
+#include "exportaction_blocksimplification.h"
 #include "pluginsuite.h"
 #include "admvstcontrol.h"
 #include "helper/common_definition_helper.h"
+#include "helper/multiplexed_samples_ring.h"
 
 #include <memory>
 
@@ -38,6 +40,11 @@ public:
     uint16_t getReportedAdmChannelFormatId() { return admChannelFormatId; }
     uint32_t getReportedAdmChannelFormatIdComplete() { return admChannelFormatId + (admTypeDefinition << 16); }
     std::string getReportedAdmChannelFormatIdStr() { return std::string("AC_") + intToHex(getReportedAdmChannelFormatIdComplete()); }
+    bool supportsMultiplexedSamples() { return capabilities & commandSocket.CAPABILITY_MULTIPLEXED_SAMPLES; }
+    uint32_t getReportedBlockSize() { return blockSize; }
+
+    // Must be called before the render starts. Token 0 returns the plugin to its samples socket.
+    bool joinMultiplexedStream(uint32_t token, uint32_t stream);
 
 private:
     void infoExchange();
@@ -48,6 +55,8 @@ private:
     uint16_t admTypeDefinition{ 0 };
     uint16_t admPackFormatId{ 0 };
     uint16_t admChannelFormatId{ 0 };
+    uint8_t capabilities{ 0 };
+    uint32_t blockSize{ 0 };
 };
 
 // Wrapper around AdmVst to make it a suitable export source
@@ -73,6 +82,7 @@ public:
     void setRenderInProgressState(bool state);
 
     int blockCount{ 0 };
+    BlockSimplificationStats blockSimplification;
 
 private:
     void assignAdmMetadata(ReaperAPI const& api);
@@ -125,8 +135,10 @@ public:
     void setRenderInProgress(bool state);
     bool isFrameAvailable();
     bool writeNextFrameTo(float* bufferWritePointer, bool skipFrameAvailableCheck = false);
+    int writeNextFramesTo(float* bufferWritePointer, int maxFrames) override;
+    bool isEndOfStream() override;
 
-    std::shared_ptr<bw64::AxmlChunk> getAxmlChunk();
+    std::shared_ptr<bw64::Chunk> getAxmlChunk();
     std::shared_ptr<bw64::ChnaChunk> getChnaChunk();
     std::shared_ptr<adm::Document> getAdmDocument() { return admDocument; }
 
@@ -149,4 +161,9 @@ private:
     std::vector<std::string> warningStrings;
 
     void updateErrorsWarningsInfo(ReaperAPI const & api);
+
+    // Set when every candidate streams into one shared ring rather than its own samples socket.
+    // Kept after the render stops so remaining frames can be drained.
+    std::unique_ptr<MultiplexedSamplesRing> multiplexedRing;
+    void startMultiplexedStream();
 };
@@ -2,6 +2,7 @@
 
 #include "pluginregistry.h"
 #include "pluginsuite_ear.h"
+#include "exportaction_axmlchunk.h"
 #include <version/eps_version.h>
 #include <speaker_setups.hpp>
 
@@ -10,7 +11,9 @@
 #include <adm/parse.hpp>
 
 #include <algorithm>
+#include <functional>
 #include <sstream>
+#include <string_view>
 
 using namespace admplug;
 
@@ -71,7 +74,7 @@ int EarVstExportSources::getTotalExportChannels()
 void EarVstExportSources::setRenderInProgress(bool state)
 {
     if(chosenCandidateForExport){
-        chosenCandidateForExport->setRenderInProgressState(true);
+        chosenCandidateForExport->setRenderInProgressState(state);
     }
 }
 
@@ -81,6 +84,20 @@ bool EarVstExportSources::isFrameAvailable()
     return chosenCandidateForExport->getCommunicator()->nextFrameAvailable();
 }
 
+bool EarVstExportSources::isEndOfStream()
+{
+    if(!chosenCandidateForExport) return false;
+    auto communicator = chosenCandidateForExport->getCommunicator();
+    return communicator && communicator->isEndOfStream();
+}
+
+uint64_t EarVstExportSources::getDroppedFrames()
+{
+    if(!chosenCandidateForExport) return 0;
+    auto communicator = chosenCandidateForExport->getCommunicator();
+    return communicator? communicator->getDroppedFrames() : 0;
+}
+
 bool EarVstExportSources::writeNextFrameTo(float * bufferWritePointer, bool skipFrameAvailableCheck)
 {
     if(!skipFrameAvailableCheck && !isFrameAvailable()) return false;
@@ -97,6 +114,25 @@ bool EarVstExportSources::writeNextFrameTo(float * bufferWritePointer, bool skip
     return true;
 }
 
+int EarVstExportSources::writeNextFramesTo(float* bufferWritePointer, int maxFrames)
+{
+    if(!chosenCandidateForExport) return 0;
+    auto communicator = chosenCandidateForExport->getCommunicator();
+    int channels = communicator->getReportedChannelCount();
+    if(channels == 0) return 0;
+
+    int written = 0;
+    while(written < maxFrames && communicator->nextFrameAvailable()) {
+        int run = std::min(maxFrames - written, communicator->framesAvailable());
+        if(!communicator->copyNextFrames(bufferWritePointer, run, channels)) {
+            throw std::runtime_error("copyNextFrames failed");
+        }
+        bufferWritePointer += static_cast<size_t>(run) * channels;
+        written += run;
+    }
+    return written;
+}
+
 void EarVstExportSources::generateAdmAndChna(ReaperAPI const& api)
 {
     using namespace adm;
@@ -174,6 +210,7 @@ void EarVstExportSources::generateAdmAndChna(ReaperAPI const& api)
 
     std::shared_ptr<admplug::PluginSuite> pluginSuite = std::make_shared<EARPluginSuite>();
 
+    std::vector<ObjectMetadataJob> jobs;
     auto channelMappings = chosenCandidateForExport->getChannelMappings();
     for(auto const& channelMapping : channelMappings) {
         for(auto const& plugin : channelMapping.plugins) {
@@ -223,10 +260,11 @@ void EarVstExportSources::generateAdmAndChna(ReaperAPI const& api)
             }
 
             if(!(*admElements).isUsingCommonDefinition) {
-
-                auto cumulatedPointData = CumulatedPointData(start, start + duration);
-
-                // Get all values for all parameters, whether automated or not.
+                // Snapshot all values for all parameters, whether automated or not.
+                ObjectMetadataJob job{ *admElements, start, duration, true };
+                if(admElements->typeDescriptor == adm::TypeDefinition::OBJECTS) {
+                    job.useSphericalCoordinates = pluginSuite->pluginUsesSphericalCoordinates(pluginInst.get());
+                }
                 for(int admParameterIndex = 0; admParameterIndex != (int)AdmParameter::NONE; admParameterIndex++) {
                     auto admParameter = (AdmParameter)admParameterIndex;
                     auto param = pluginSuite->getParameterFor(admParameter);
@@ -235,62 +273,99 @@ void EarVstExportSources::generateAdmAndChna(ReaperAPI const& api)
                     if(getEnvelopeBypassed(env, api)) {
                         // We have an envelope, but it is bypassed
                         auto val = getValueFor(pluginSuite, pluginInst.get(), admParameter, api);
-                        auto newErrors = cumulatedPointData.useConstantValueForParameter(admParameter, *val);
-                        for(auto& newError : newErrors) {
-                            warningStrings.push_back(newError.what());
-                        }
+                        job.parameterData.push_back({ admParameter, param, {}, *val });
                     } else if(param && env) {
                         // We have an envelope for this ADM parameter
-                        auto newErrors = cumulatedPointData.useEnvelopeDataForParameter(*env, *param, admParameter, api);
-                        for(auto &newError : newErrors) {
-                            warningStrings.push_back(newError.what());
-                        }
-
+                        job.parameterData.push_back({ admParameter, param, EnvelopeSnapshot::take(*env, api), {} });
                     } else if(auto val = getValueFor(pluginSuite, pluginInst.get(), admParameter, api)) {
                         // We do not have an envelope for this ADM parameter but the plugin suite CAN provide a fixed value for it
                         // NOTE that this will include parameters NOT relevant to the current audioObject type, but these are ignored during block creation.
-                        auto newErrors = cumulatedPointData.useConstantValueForParameter(admParameter, *val);
-                        for(auto &newError : newErrors) {
-                            warningStrings.push_back(newError.what());
-                        }
+                        job.parameterData.push_back({ admParameter, param, {}, *val });
                     }
                 }
-
-                if(admElements->typeDescriptor == adm::TypeDefinition::OBJECTS) {
-                    auto blocks = cumulatedPointData.generateAudioBlockFormatObjects(pluginSuite, pluginInst.get(), api);
-                    for(auto& block : *blocks) admElements->audioChannelFormat->add(*block);
-                }
-                else if(admElements->typeDescriptor == adm::TypeDefinition::DIRECT_SPEAKERS) {
-                    //TODO
-                    warningStrings.push_back("Currently only supporting Common Defintions for non-Objects types");
-                }
-                else if(admElements->typeDescriptor == adm::TypeDefinition::HOA) {
-                    //TODO
-                    warningStrings.push_back("Currently only supporting Common Defintions for non-Objects types");
-                }
-                else if(admElements->typeDescriptor == adm::TypeDefinition::BINAURAL) {
-                    //TODO
-                    warningStrings.push_back("Currently only supporting Common Defintions for non-Objects types");
-                }
-                else if(admElements->typeDescriptor == adm::TypeDefinition::MATRIX) {
-                    //TODO
-                    warningStrings.push_back("Currently only supporting Common Defintions for non-Objects types");
-                }
+                jobs.push_back(std::move(job));
             }
         }
     }
 
-    // Create AXML Chunk
-    std::stringstream xmlStream;
-    adm::writeXml(xmlStream, admDocument);
-    xmlStream << "<!-- Produced using the EAR Production Suite (version ";
-    xmlStream << (eps::versionInfoAvailable()? eps::currentVersion() : "unknown");
-    xmlStream << "), from the EAR Scene plugin -->\n";
-    auto xmlStr = xmlStream.str();
-    axmlChunk = std::make_shared<bw64::AxmlChunk>(bw64::AxmlChunk(xmlStr));
+    // Block formats are generated in parallel - anything else needed from REAPER is fetched on this thread whilst waiting
+    MainThreadEnvelopeEvaluator evaluator(api);
+    std::vector<std::function<void()>> tasks;
+    tasks.reserve(jobs.size());
+    for(auto& job : jobs) {
+        tasks.push_back([&job, &evaluator]() { generateObjectMetadata(job, evaluator); });
+    }
+    try {
+        evaluator.runInParallel(tasks);
+    } catch(std::exception &e) {
+        std::string str = "Failed to generate ADM metadata: \"";
+        str += e.what();
+        str += "\"";
+        errorStrings.push_back(str);
+        return;
+    }
+
+    // Merge in to the document in the original order, so IDs are assigned as before
+    BlockSimplificationStats blockSimplification;
+    for(auto& job : jobs) {
+        for(auto& block : job.blocks) job.admElements.audioChannelFormat->add(*block);
+        warningStrings.insert(warningStrings.end(), job.warnings.begin(), job.warnings.end());
+        blockSimplification += job.blockSimplification;
+    }
+    if(blockSimplification.blocksIn > 0) {
+        infoStrings.push_back(blockSimplification.summary());
+    }
+
+    // Create AXML Chunk - serialised as the file is written
+    std::string trailer("<!-- Produced using the EAR Production Suite (version ");
+    trailer += (eps::versionInfoAvailable()? eps::currentVersion() : "unknown");
+    trailer += "), from the EAR Scene plugin -->\n";
+    axmlChunk = std::make_shared<StreamingAxmlChunk>(admDocument, trailer);
 
 }
 
+void EarVstExportSources::generateObjectMetadata(ObjectMetadataJob& job, EnvelopeEvaluator& evaluator)
+{
+    // Must not call REAPER - anything not in the job is fetched through `evaluator`
+    auto cumulatedPointData = CumulatedPointData(job.start, job.start + job.duration);
+
+    for(auto& parameterData : job.parameterData) {
+        std::vector<AdmAuthoringError> newErrors;
+        if(parameterData.envelope) {
+            newErrors = cumulatedPointData.useEnvelopeDataForParameter(std::move(*parameterData.envelope), *parameterData.parameter, parameterData.admParameter, evaluator);
+        } else {
+            newErrors = cumulatedPointData.useConstantValueForParameter(parameterData.admParameter, *parameterData.value);
+        }
+        for(auto& newError : newErrors) {
+            job.warnings.push_back(newError.what());
+        }
+    }
+
+    if(job.admElements.typeDescriptor == adm::TypeDefinition::OBJECTS) {
+        auto blocks = cumulatedPointData.generateAudioBlockFormatObjects(job.useSphericalCoordinates, evaluator);
+        if(blocks) {
+            job.blocks = std::move(*blocks);
+            job.blockSimplification = simplifyBlockFormats(job.blocks);
+        }
+    }
+    else if(job.admElements.typeDescriptor == adm::TypeDefinition::DIRECT_SPEAKERS) {
+        //TODO
+        job.warnings.push_back("Currently only supporting Common Defintions for non-Objects types");
+    }
+    else if(job.admElements.typeDescriptor == adm::TypeDefinition::HOA) {
+        //TODO
+        job.warnings.push_back("Currently only supporting Common Defintions for non-Objects types");
+    }
+    else if(job.admElements.typeDescriptor == adm::TypeDefinition::BINAURAL) {
+        //TODO
+        job.warnings.push_back("Currently only supporting Common Defintions for non-Objects types");
+    }
+    else if(job.admElements.typeDescriptor == adm::TypeDefinition::MATRIX) {
+        //TODO
+        job.warnings.push_back("Currently only supporting Common Defintions for non-Objects types");
+    }
+}
+
 std::optional<EarVstExportSources::AdmElements> EarVstExportSources::getAdmElementsFor(const PluginToAdmMap& plugin)
 {
     auto audioObjectId = adm::AudioObjectId(adm::AudioObjectIdValue(plugin.audioObjectIdVal));
@@ -396,14 +471,16 @@ bool EarVstExportSources::getEnvelopeBypassed(TrackEnvelope* env, ReaperAPI cons
         char chunk[1024]; // For a plugin parameter (PARMENV) the ACT flag should always be within the first couple bytes of the state chunk
         bool getRes = api.GetEnvelopeStateChunk(env, chunk, 1024, false);
         if (getRes) {
-            std::istringstream chunkSs(chunk);
-            std::string line;
-            while (std::getline(chunkSs, line)) {
-                auto activePos = line.rfind("ACT ", 0);
-                if ((activePos != std::string::npos) && (line.size() > (activePos + 4))) {
-                    envBypassed = line.at(activePos + 4) == '0';
+            std::string_view remaining(chunk);
+            while (!remaining.empty()) {
+                auto lineEnd = remaining.find('\n');
+                auto line = remaining.substr(0, lineEnd);
+                if (line.size() > 4 && line.substr(0, 4) == "ACT ") {
+                    envBypassed = line[4] == '0';
                     break;
                 }
+                if (lineEnd == std::string_view::npos) break;
+                remaining.remove_prefix(lineEnd + 1);
             }
         }
     }
@@ -688,6 +765,28 @@ bool EarVstCommunicator::copyNextFrame(float * buf, bool bypassAvailabilityCheck
 {
     if(!bypassAvailabilityCheck && !nextFrameAvailable()) return false;
 
+    if(channelMaskAccepted) {
+        // Frame already holds just the written channels, in order
+        if(samplesRing) {
+            auto frame = samplesRing->currentFrame();
+            std::copy(frame, frame + channelMappings.size(), buf);
+            samplesRing->advanceFrame();
+            return true;
+        }
+        bool successful = latestBlockMessage->seqReadAndPut(buf, static_cast<int>(channelMappings.size()));
+        assert(successful);
+        return successful;
+    }
+
+    if(samplesRing) {
+        auto frame = samplesRing->currentFrame();
+        for(auto const& channelMapping : channelMappings) {
+            buf[channelMapping.writtenChannelNumber] = frame[channelMapping.originalChannelNumber];
+        }
+        samplesRing->advanceFrame();
+        return true;
+    }
+
     // Need to pick and select data out of buffer to build frame.
     bool successful = true;
     int currentReadPosChannelNumber = 0;
@@ -723,6 +822,38 @@ bool EarVstCommunicator::copyNextFrame(float * buf, bool bypassAvailabilityCheck
     return successful;
 }
 
+bool EarVstCommunicator::copyNextFrames(float* buf, int frameCount, int stride)
+{
+    // Frames can only be copied as a run once the Scene streams just the written channels
+    if(channelMaskAccepted) {
+        return CommunicatorBase::copyNextFrames(buf, frameCount, stride);
+    }
+    for(int i = 0; i < frameCount; ++i) {
+        if(!copyNextFrame(buf, true)) return false;
+        buf += stride;
+    }
+    return true;
+}
+
+void EarVstCommunicator::prepareRender()
+{
+    uint64_t mask = 0;
+    for(auto const& channelMapping : channelMappings) {
+        assert(channelMapping.originalChannelNumber < 64);
+        mask |= uint64_t{1} << channelMapping.originalChannelNumber;
+    }
+
+    channelMaskAccepted = false;
+    if(commandSocket.isSocketOpen() && !channelMappings.empty()) {
+        auto resp = commandSocket.sendChannelMask(mask);
+        uint8_t respCode;
+        if(resp->getSize() >= 1) {
+            memcpy(&respCode, resp->getBufferPointer(), 1);
+            channelMaskAccepted = (respCode == commandSocket.Command::SetChannelMaskResp);
+        }
+    }
+}
+
 void EarVstCommunicator::sendAdm(std::string originalAdmStr, std::vector<PluginToAdmMap> pluginToAdmMaps)
 {
     if(commandSocket.isSocketOpen()) {
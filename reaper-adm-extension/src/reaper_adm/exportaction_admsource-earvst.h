@@ -6,6 +6,7 @@
 #include "parameter.h"
 #include "exportaction_issues.h"
 #include "exportaction_parameterprocessing.h"
+#include "exportaction_blocksimplification.h"
 #include "helper/nng_wrappers.h"
 
 #include <vector>
@@ -25,6 +26,7 @@ public:
 
 	// Existing is fine - bool nextFrameAvailable();
 	bool copyNextFrame(float* buf, bool bypassAvailabilityCheck = false) override;
+	bool copyNextFrames(float* buf, int frameCount, int stride) override;
 
 	struct ChannelMapping {
         uint8_t originalChannelNumber;
@@ -39,6 +41,10 @@ public:
 
 	void sendAdm(std::string originalAdmStr, std::vector<PluginToAdmMap> pluginToAdmMaps);
 
+protected:
+	void prepareRender() override;
+	int getStreamedChannelCount() override { return channelMaskAccepted? (int)channelMappings.size() : 64; }
+
 private:
 	void infoExchange();
 	void admAndMappingExchange();
@@ -48,6 +54,8 @@ private:
 
 	uint8_t channelCount{ 0 };
 	uint32_t sampleRate{ 0 };
+	// Scene streams only the mapped channels, in the order they are written
+	bool channelMaskAccepted{ false };
 };
 
 #define EARSCENEMASTER_VST_COMMANDPORTPARAM 0
@@ -156,8 +164,11 @@ public:
 	void setRenderInProgress(bool state);
 	bool isFrameAvailable();
 	bool writeNextFrameTo(float* bufferWritePointer, bool skipFrameAvailableCheck = false);
+	int writeNextFramesTo(float* bufferWritePointer, int maxFrames) override;
+	bool isEndOfStream() override;
+	uint64_t getDroppedFrames() override;
 
-	std::shared_ptr<bw64::AxmlChunk> getAxmlChunk() { return axmlChunk; }
+	std::shared_ptr<bw64::Chunk> getAxmlChunk() { return axmlChunk; }
 	std::shared_ptr<bw64::ChnaChunk> getChnaChunk() { return chnaChunk; }
 	std::shared_ptr<adm::Document> getAdmDocument() { return admDocument; }
 
@@ -183,9 +194,29 @@ private:
 	};
 	std::optional<AdmElements> getAdmElementsFor(const PluginToAdmMap& plugin);
 
+	// Everything needed to generate the block formats for one object, gathered from REAPER up front so that objects can be processed in parallel
+	struct ObjectMetadataJob {
+		struct ParameterData {
+			AdmParameter admParameter;
+			Parameter* parameter;
+			std::optional<EnvelopeSnapshot> envelope;
+			std::optional<double> value; // Used when there is no envelope
+		};
+		AdmElements admElements;
+		std::chrono::nanoseconds start;
+		std::chrono::nanoseconds duration;
+		bool useSphericalCoordinates;
+		std::vector<ParameterData> parameterData;
+		// Results
+		std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> blocks;
+		BlockSimplificationStats blockSimplification;
+		std::vector<std::string> warnings;
+	};
+	static void generateObjectMetadata(ObjectMetadataJob& job, EnvelopeEvaluator& evaluator);
+
 	std::shared_ptr<adm::Document> admDocument;
 	std::shared_ptr<bw64::ChnaChunk> chnaChunk;
-	std::shared_ptr<bw64::AxmlChunk> axmlChunk;
+	std::shared_ptr<bw64::Chunk> axmlChunk;
 	std::vector<std::shared_ptr<EarSceneMasterVst>> allEarSceneMasterVsts{};
 	std::vector<std::shared_ptr<EarSceneMasterVst>> candidatesForExport{};
 	std::shared_ptr<EarSceneMasterVst> chosenCandidateForExport{};
@@ -46,8 +46,22 @@ public:
     virtual void setRenderInProgress(bool state) = 0;
     virtual bool isFrameAvailable() = 0;
     virtual bool writeNextFrameTo(float* bufferWritePointer, bool skipFrameAvailableCheck = false) = 0;
+    // Writes up to `maxFrames` consecutive frames of getTotalExportChannels() channels, returning how many were written.
+    // Stops early when no further frame is available.
+    virtual int writeNextFramesTo(float* bufferWritePointer, int maxFrames) {
+        int channels = getTotalExportChannels();
+        int written = 0;
+        while(written < maxFrames && isFrameAvailable()) {
+            if(!writeNextFrameTo(bufferWritePointer, true)) break;
+            bufferWritePointer += channels;
+            written++;
+        }
+        return written;
+    }
+    virtual bool isEndOfStream() { return false; } // Sources have signalled no more frames will follow for this render
+    virtual uint64_t getDroppedFrames() { return 0; } // Frames sources could not queue for this render, so are missing from it
 
-    virtual std::shared_ptr<bw64::AxmlChunk> getAxmlChunk() = 0;
+    virtual std::shared_ptr<bw64::Chunk> getAxmlChunk() = 0; // Serialised from the ADM document as the file is written, so finalise the document first
     virtual std::shared_ptr<bw64::ChnaChunk> getChnaChunk() = 0;
     virtual std::shared_ptr<adm::Document> getAdmDocument() = 0; // Required access prior to stringifying so that programme name and content name can be updtaed
 
@@ -0,0 +1,60 @@
+#include "exportaction_axmlchunk.h"
+
+#include <adm/write.hpp>
+
+#include <streambuf>
+
+using namespace admplug;
+
+namespace {
+
+// Discards everything written to it, keeping only the count
+class CountingStreamBuf : public std::streambuf
+{
+public:
+    uint64_t getCount() const { return count; }
+
+protected:
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        count += static_cast<uint64_t>(n);
+        return n;
+    }
+    int_type overflow(int_type ch) override {
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) count++;
+        return traits_type::not_eof(ch);
+    }
+
+private:
+    uint64_t count{ 0 };
+};
+
+}
+
+StreamingAxmlChunk::StreamingAxmlChunk(std::shared_ptr<const adm::Document> document, std::string trailer) :
+    document{ document }, trailer{ std::move(trailer) }
+{
+}
+
+uint64_t StreamingAxmlChunk::size() const
+{
+    // Counted on first use rather than construction, so it reflects any changes made to the
+    // document up until the writer takes the chunk
+    if (!contentSize) {
+        CountingStreamBuf counter;
+        std::ostream countingStream(&counter);
+        writeContent(countingStream);
+        contentSize = counter.getCount();
+    }
+    return *contentSize;
+}
+
+void StreamingAxmlChunk::write(std::ostream& stream) const
+{
+    writeContent(stream);
+}
+
+void StreamingAxmlChunk::writeContent(std::ostream& stream) const
+{
+    if (document) adm::writeXml(stream, document);
+    stream << trailer;
+}
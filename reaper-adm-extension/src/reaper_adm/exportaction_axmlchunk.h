@@ -0,0 +1,39 @@
+#pragma once
+
+#include <bw64/bw64.hpp>
+#include <adm/document.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+
+namespace admplug {
+
+/*
+An axml chunk which serialises its ADM document straight into the file as it is written,
+rather than holding the XML in memory - for long programmes it can run to hundreds of MB.
+
+The chunk size has to be written ahead of the content, so it is found by serialising
+once without storing anything. The document must not change once the writer has the chunk.
+*/
+class StreamingAxmlChunk : public bw64::Chunk
+{
+public:
+    // `trailer` is appended after the document (e.g, a comment)
+    StreamingAxmlChunk(std::shared_ptr<const adm::Document> document, std::string trailer = std::string());
+
+    uint32_t id() const override { return bw64::utils::fourCC("axml"); }
+    uint64_t size() const override;
+    void write(std::ostream& stream) const override;
+
+private:
+    void writeContent(std::ostream& stream) const;
+
+    std::shared_ptr<const adm::Document> document;
+    std::string trailer;
+    mutable std::optional<uint64_t> contentSize;
+};
+
+}
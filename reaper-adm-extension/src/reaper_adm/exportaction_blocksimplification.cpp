@@ -0,0 +1,192 @@
+#include "exportaction_blocksimplification.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <optional>
+#include <sstream>
+#include <utility>
+
+using namespace admplug;
+
+namespace {
+    using ns = std::chrono::nanoseconds;
+
+    // Maximum deviation from the original parameter values a removed block may cause
+    constexpr double ANGLE_TOLERANCE = 0.1; // Degrees - azimuth, elevation, and width and height of polar blocks
+    constexpr double UNIT_TOLERANCE = 0.001; // Distance, X, Y, Z, depth, diffuse, linear gain, and width and height of cartesian blocks
+
+    constexpr size_t MAX_COMPONENTS = 8;
+
+    struct Vertex {
+        // Blocks are interpolated towards, so their values apply at the end of the block
+        ns endTime;
+        std::array<double, MAX_COMPONENTS> values;
+        bool cartesian;
+    };
+
+    template<typename BlockT>
+    std::pair<ns, ns> getStartAndDuration(BlockT const& block) {
+        auto start = block.template has<adm::Rtime>() ? block.template get<adm::Rtime>().get().asNanoseconds() : ns::zero();
+        auto duration = block.template has<adm::Duration>() ? block.template get<adm::Duration>().get().asNanoseconds() : ns::zero();
+        return { start, duration };
+    }
+
+    bool isJumpPositionEnabled(adm::AudioBlockFormatObjects const& block) {
+        return block.has<adm::JumpPosition>() && adm::isEnabled(block.get<adm::JumpPosition>());
+    }
+
+    Vertex toVertex(adm::AudioBlockFormatObjects const& block) {
+        auto [start, duration] = getStartAndDuration(block);
+        Vertex vertex{ start + duration, {}, block.has<adm::CartesianPosition>() };
+        if(vertex.cartesian) {
+            auto position = block.get<adm::CartesianPosition>();
+            vertex.values[0] = position.get<adm::X>().get();
+            vertex.values[1] = position.get<adm::Y>().get();
+            vertex.values[2] = position.get<adm::Z>().get();
+        } else {
+            auto position = block.get<adm::SphericalPosition>();
+            vertex.values[0] = position.get<adm::Azimuth>().get();
+            vertex.values[1] = position.get<adm::Elevation>().get();
+            vertex.values[2] = position.get<adm::Distance>().get();
+        }
+        vertex.values[3] = block.get<adm::Width>().get();
+        vertex.values[4] = block.get<adm::Height>().get();
+        vertex.values[5] = block.get<adm::Depth>().get();
+        vertex.values[6] = block.get<adm::Gain>().asLinear();
+        vertex.values[7] = block.get<adm::Diffuse>().get();
+        return vertex;
+    }
+
+    std::array<double, MAX_COMPONENTS> tolerancesFor(Vertex const& vertex) {
+        // Cartesian blocks give position, width and height in the same units
+        double angleOrUnitTolerance = vertex.cartesian ? UNIT_TOLERANCE : ANGLE_TOLERANCE;
+        return { angleOrUnitTolerance, angleOrUnitTolerance, UNIT_TOLERANCE,
+                 angleOrUnitTolerance, angleOrUnitTolerance, UNIT_TOLERANCE, UNIT_TOLERANCE, UNIT_TOLERANCE };
+    }
+
+    // Largest deviation of `mid` from the interpolation between `from` and `to`, as a multiple of its tolerance
+    double relativeDeviation(Vertex const& from, Vertex const& mid, Vertex const& to) {
+        double span = static_cast<double>((to.endTime - from.endTime).count());
+        double position = span > 0.0 ? static_cast<double>((mid.endTime - from.endTime).count()) / span : 0.0;
+        auto tolerances = tolerancesFor(mid);
+        double deviation = 0.0;
+        for(size_t n = 0; n < MAX_COMPONENTS; n++) {
+            double interpolated = from.values[n] + ((to.values[n] - from.values[n]) * position);
+            deviation = std::max(deviation, std::abs(mid.values[n] - interpolated) / tolerances[n]);
+        }
+        return deviation;
+    }
+
+    // CumulatedPointData splits azimuth changes of more than half a turn with extra blocks, to show which way around they go.
+    // Interpolating linearly between blocks further apart than that would lose the direction, or take the long way around.
+    bool crossesAzimuthWrap(Vertex const& from, Vertex const& to) {
+        return !from.cartesian && !to.cartesian && std::abs(to.values[0] - from.values[0]) > 180.0;
+    }
+
+    // Ramer-Douglas-Peucker between two kept vertices
+    void markKeptBetween(std::vector<Vertex> const& vertices, size_t first, size_t last, std::vector<bool>& keep) {
+        std::vector<std::pair<size_t, size_t>> spans{ { first, last } };
+        while(!spans.empty()) {
+            auto [from, to] = spans.back();
+            spans.pop_back();
+            if(to - from < 2) continue;
+
+            size_t furthest = from;
+            // Anything within tolerance can go, unless the span would then cross the azimuth wrap
+            double maxDeviation = crossesAzimuthWrap(vertices[from], vertices[to]) ? -1.0 : 1.0;
+            for(size_t n = from + 1; n < to; n++) {
+                double deviation = relativeDeviation(vertices[from], vertices[n], vertices[to]);
+                if(deviation > maxDeviation) {
+                    maxDeviation = deviation;
+                    furthest = n;
+                }
+            }
+            if(furthest != from) {
+                keep[furthest] = true;
+                spans.push_back({ from, furthest });
+                spans.push_back({ furthest, to });
+            }
+        }
+    }
+
+    // Removes blocks not marked to keep, extending the next kept block back over them
+    template<typename BlockT>
+    void removeUnkept(std::vector<std::shared_ptr<BlockT>>& blocks, std::vector<bool> const& keep) {
+        std::vector<std::shared_ptr<BlockT>> kept;
+        kept.reserve(blocks.size());
+        std::optional<ns> removedStart;
+        for(size_t n = 0; n < blocks.size(); n++) {
+            if(!keep[n]) {
+                if(!removedStart) removedStart = getStartAndDuration(*blocks[n]).first;
+                continue;
+            }
+            if(removedStart) {
+                auto [start, duration] = getStartAndDuration(*blocks[n]);
+                blocks[n]->set(adm::Rtime{ *removedStart });
+                blocks[n]->set(adm::Duration{ start + duration - *removedStart });
+                removedStart.reset();
+            }
+            kept.push_back(blocks[n]);
+        }
+        blocks = std::move(kept);
+    }
+}
+
+BlockSimplificationStats& BlockSimplificationStats::operator+=(BlockSimplificationStats const& other)
+{
+    blocksIn += other.blocksIn;
+    blocksOut += other.blocksOut;
+    return *this;
+}
+
+double BlockSimplificationStats::compressionRatio() const
+{
+    if(blocksOut == 0) return 1.0;
+    return static_cast<double>(blocksIn) / static_cast<double>(blocksOut);
+}
+
+std::string BlockSimplificationStats::summary() const
+{
+    std::ostringstream op;
+    op << "Simplified " << blocksIn << " audioBlockFormats to " << blocksOut;
+    op << " (" << std::fixed << std::setprecision(1) << compressionRatio() << ":1)";
+    return op.str();
+}
+
+BlockSimplificationStats admplug::simplifyBlockFormats(std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>& blocks)
+{
+    BlockSimplificationStats stats{ blocks.size(), blocks.size() };
+    if(blocks.size() < 3) return stats;
+
+    std::vector<Vertex> vertices;
+    vertices.reserve(blocks.size());
+    for(auto const& block : blocks) {
+        vertices.push_back(toVertex(*block));
+    }
+
+    // Anything which is not a plain interpolation from the previous block breaks the sequence in to spans which are simplified separately
+    std::vector<bool> keep(blocks.size(), false);
+    keep.front() = true;
+    keep.back() = true;
+    for(size_t n = 1; n < blocks.size(); n++) {
+        if(isJumpPositionEnabled(*blocks[n]) || vertices[n].cartesian != vertices[n - 1].cartesian) {
+            keep[n - 1] = true;
+            keep[n] = true;
+        }
+    }
+
+    size_t spanStart = 0;
+    for(size_t n = 1; n < blocks.size(); n++) {
+        if(keep[n]) {
+            markKeptBetween(vertices, spanStart, n, keep);
+            spanStart = n;
+        }
+    }
+
+    removeUnkept(blocks, keep);
+    stats.blocksOut = blocks.size();
+    return stats;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <adm/adm.hpp>
+
+namespace admplug {
+
+struct BlockSimplificationStats {
+    size_t blocksIn{ 0 };
+    size_t blocksOut{ 0 };
+
+    BlockSimplificationStats& operator+=(BlockSimplificationStats const& other);
+    double compressionRatio() const; // blocksIn:blocksOut
+    std::string summary() const; // For export info
+};
+
+// Post-pass over generated block formats, removing blocks which those kept either side already reproduce.
+// The block following a removed run is extended back to cover its time, so the blocks remain contiguous.
+
+// Objects blocks are interpolated towards, so a block is removed if interpolating between the kept blocks either side
+// stays within a per-parameter tolerance of all its parameters (Ramer-Douglas-Peucker over the joint parameter vector).
+// Blocks using JumpPosition, and those before them, are always kept.
+// Only the parameters the export sets are compared.
+// Spans are never left crossing the +/-180 azimuth wrap, so the blocks CumulatedPointData adds to carry a pan across it are kept.
+BlockSimplificationStats simplifyBlockFormats(std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>& blocks);
+
+}
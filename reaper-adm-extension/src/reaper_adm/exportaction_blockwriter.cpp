@@ -0,0 +1,122 @@
+#include "exportaction_blockwriter.h"
+#include "floatwriter.h"
+
+#include <cassert>
+#include <exception>
+#include <utility>
+
+using namespace admplug;
+
+AsyncBlockWriter::AsyncBlockWriter(bw64::Bw64Writer& writer, int channelCount, size_t blockFrameCount, size_t blockCount) :
+    AsyncBlockWriter([&writer](float const* frames, size_t frameCount) { writer.write(frames, frameCount); },
+                     channelCount, blockFrameCount, blockCount)
+{
+}
+
+AsyncBlockWriter::AsyncBlockWriter(FloatWriter& writer, int channelCount, size_t blockFrameCount, size_t blockCount) :
+    AsyncBlockWriter([&writer](float const* frames, size_t frameCount) { writer.write(frames, frameCount); },
+                     channelCount, blockFrameCount, blockCount)
+{
+}
+
+AsyncBlockWriter::AsyncBlockWriter(WriteFrames writeFrames, int channelCount, size_t blockFrameCount, size_t blockCount) :
+    writeFrames{ std::move(writeFrames) }, channelCount{ channelCount }, blockFrameCount{ blockFrameCount }, blocks(blockCount)
+{
+    assert(channelCount > 0 && blockFrameCount > 0 && blockCount > 0);
+    for (auto& block : blocks) {
+        block.samples.resize(blockFrameCount * channelCount, 0.f);
+    }
+    thread = std::thread(&AsyncBlockWriter::run, this);
+}
+
+AsyncBlockWriter::~AsyncBlockWriter()
+{
+    finish();
+}
+
+float* AsyncBlockWriter::acquireBlock()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    // Only blocks the render thread when the disk has fallen a whole queue behind
+    blockWritten.wait(lock, [this]() {
+        return failed || submittedCount - writtenCount < blocks.size();
+    });
+    if (failed) return nullptr;
+    return blocks[submittedCount % blocks.size()].samples.data();
+}
+
+void AsyncBlockWriter::submitBlock(size_t frameCount)
+{
+    assert(frameCount <= blockFrameCount);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        assert(submittedCount - writtenCount < blocks.size());
+        blocks[submittedCount % blocks.size()].frameCount = frameCount;
+        submittedCount++;
+    }
+    blockSubmitted.notify_one();
+}
+
+bool AsyncBlockWriter::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finishing = true;
+    }
+    blockSubmitted.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+    return !hasFailed();
+}
+
+bool AsyncBlockWriter::hasFailed()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return failed;
+}
+
+std::string AsyncBlockWriter::getError()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+void AsyncBlockWriter::run()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        blockSubmitted.wait(lock, [this]() {
+            return finishing || writtenCount < submittedCount;
+        });
+        if (writtenCount == submittedCount) {
+            // Finishing with nothing left queued
+            break;
+        }
+
+        // The producer never touches a submitted block, so it can be written unlocked
+        auto& block = blocks[writtenCount % blocks.size()];
+        lock.unlock();
+        bool writeFailed = false;
+        std::string writeError;
+        try {
+            writeFrames(block.samples.data(), block.frameCount);
+        } catch (std::exception const& e) {
+            writeFailed = true;
+            writeError = e.what();
+        } catch (...) {
+            writeFailed = true;
+            writeError = "Unknown error";
+        }
+        lock.lock();
+
+        if (writeFailed) {
+            failed = true;
+            error = writeError;
+            blockWritten.notify_all();
+            break;
+        }
+        writtenCount++;
+        blockWritten.notify_one();
+    }
+}
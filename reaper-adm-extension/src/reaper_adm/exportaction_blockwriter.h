@@ -0,0 +1,72 @@
+#pragma once
+
+#include <bw64/bw64.hpp>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace admplug {
+
+class FloatWriter;
+
+/*
+Writes blocks of interleaved float frames to a Bw64Writer or FloatWriter on a dedicated thread,
+so that sample conversion and disk I/O overlap with rendering.
+
+Blocks are preallocated and used round-robin; the producer fills the block returned
+by acquireBlock() and queues it with submitBlock(). Only one thread may produce.
+*/
+class AsyncBlockWriter
+{
+public:
+    static constexpr size_t DEFAULT_BLOCK_COUNT = 16;
+
+    AsyncBlockWriter(bw64::Bw64Writer& writer, int channelCount, size_t blockFrameCount, size_t blockCount = DEFAULT_BLOCK_COUNT);
+    AsyncBlockWriter(FloatWriter& writer, int channelCount, size_t blockFrameCount, size_t blockCount = DEFAULT_BLOCK_COUNT);
+    ~AsyncBlockWriter();
+
+    size_t getBlockFrameCount() const { return blockFrameCount; }
+
+    // Waits for a free block. Returns nullptr once a write has failed.
+    float* acquireBlock();
+    // Queues the block last returned by acquireBlock(), holding `frameCount` frames
+    void submitBlock(size_t frameCount);
+    // Writes out all queued blocks and stops the thread. Returns false if any write failed.
+    bool finish();
+
+    bool hasFailed();
+    std::string getError();
+
+private:
+    using WriteFrames = std::function<void(float const* frames, size_t frameCount)>;
+    AsyncBlockWriter(WriteFrames writeFrames, int channelCount, size_t blockFrameCount, size_t blockCount);
+    void run();
+
+    WriteFrames writeFrames;
+    int channelCount;
+    size_t blockFrameCount;
+
+    struct Block {
+        std::vector<float> samples;
+        size_t frameCount{ 0 };
+    };
+    std::vector<Block> blocks;
+
+    std::mutex mutex;
+    std::condition_variable blockSubmitted;
+    std::condition_variable blockWritten;
+    uint64_t submittedCount{ 0 };
+    uint64_t writtenCount{ 0 };
+    bool finishing{ false };
+    bool failed{ false };
+    std::string error;
+
+    std::thread thread;
+};
+
+}
@@ -135,6 +135,36 @@ HWND RenderDialogState::ShowConfig(const void *cfg, int cfg_l, HWND parent)
             (LPARAM)x);
 }
 
+void RenderDialogState::populateSampleFormatControl(HWND hwndDlg, SampleFormat selected)
+{
+    HWND hwnd = GetDlgItem(hwndDlg, IDC_SAMPLEFORMAT);
+    for(auto format : { SampleFormat::PCM16, SampleFormat::PCM24, SampleFormat::PCM32, SampleFormat::FLOAT32 }) {
+#ifdef WIN32
+        auto pos = SendMessage(hwnd, CB_ADDSTRING, 0, (LPARAM)sampleFormatName(format));
+        SendMessage(hwnd, CB_SETITEMDATA, pos, (LPARAM)format);
+        if(format == selected) SendMessage(hwnd, CB_SETCURSEL, pos, 0);
+#else
+        int pos = SWELL_CB_AddString(hwnd, 0, sampleFormatName(format));
+        SWELL_CB_SetItemData(hwnd, 0, pos, (LONG_PTR)format);
+        if(format == selected) SWELL_CB_SetCurSel(hwnd, 0, pos);
+#endif
+    }
+}
+
+SampleFormat RenderDialogState::getSelectedSampleFormat(HWND hwndDlg)
+{
+    HWND hwnd = GetDlgItem(hwndDlg, IDC_SAMPLEFORMAT);
+#ifdef WIN32
+    auto pos = SendMessage(hwnd, CB_GETCURSEL, 0, 0);
+    if(pos == CB_ERR) return SampleFormat::PCM24;
+    return toSampleFormat((int32_t)SendMessage(hwnd, CB_GETITEMDATA, pos, 0));
+#else
+    int pos = SWELL_CB_GetCurSel(hwnd, 0);
+    if(pos < 0) return SampleFormat::PCM24;
+    return toSampleFormat((int32_t)SWELL_CB_GetItemData(hwnd, 0, pos));
+#endif
+}
+
 LRESULT RenderDialogState::selectInComboBox(HWND hwnd, std::string text) {
 #ifdef WIN32
     auto lparam = text.c_str();
@@ -415,6 +445,10 @@ WDL_DLGRET RenderDialogState::wavecfgDlgProc(HWND hwndDlg, UINT uMsg, WPARAM wPa
     {
         // this is called when the dialog is initialized
         startedPrepareDialogControls = false;
+        auto cfgParams = reinterpret_cast<const void**>(lParam);
+        auto cfg = cfgParams? cfgParams[0] : nullptr;
+        int cfg_l = cfgParams? *reinterpret_cast<const int*>(cfgParams[1]) : 0;
+        populateSampleFormatControl(hwndDlg, ExportManager::ExportInfo.getSampleFormat(cfg, cfg_l));
         return 0;
     }
 
@@ -501,7 +535,7 @@ WDL_DLGRET RenderDialogState::wavecfgDlgProc(HWND hwndDlg, UINT uMsg, WPARAM wPa
         if (lParam)
         {
             ((int *)lParam)[0] = ExportManager::ExportInfo.SINK_FOURCC;
-            ((int *)(((unsigned char *)lParam) + 4))[0] = REAPER_MAKELEINT(0);
+            ((int *)(((unsigned char *)lParam) + 4))[0] = REAPER_MAKELEINT(static_cast<int>(getSelectedSampleFormat(hwndDlg)));
             ((float *)(((unsigned char *)lParam) + 4))[1] = 0.f;
 
         }
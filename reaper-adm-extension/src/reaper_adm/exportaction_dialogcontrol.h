@@ -9,6 +9,7 @@
 #include "reaperapi.h"
 #include "reaper_plugin.h"
 #include "exportaction_admsourcescontainer.h"
+#include "sampleformat.h"
 
 using namespace admplug;
 
@@ -39,6 +40,8 @@ private:
     LRESULT selectInComboBox(HWND hwnd, std::string text);
     bool getCheckboxState(HWND hwnd);
     void setCheckboxState(HWND hwnd, bool state);
+    void populateSampleFormatControl(HWND hwndDlg, SampleFormat selected);
+    SampleFormat getSelectedSampleFormat(HWND hwndDlg);
 
     std::shared_ptr<ReaperAPI> reaperApi;
     REAPER_PLUGIN_HINSTANCE reaperInst;
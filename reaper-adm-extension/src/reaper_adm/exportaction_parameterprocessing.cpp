@@ -2,8 +2,10 @@
 #include "envelopecreator.h"
 
 #include <assert.h>
-#include <sstream>
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <system_error>
 
 #define CURVE_APPROXIMATION_STEP_MS 100
 #define CURVE_APPROXIMATION_DEVIATION_THRESHOLD 0.05
@@ -15,6 +17,125 @@ namespace {
         double variance = range * (double)VALUE_TOLERANCE;
         return ((actual > (target - variance)) && (actual < (target + variance)));
     }
+
+    void appendValue(PointValues& values, double value) {
+        if(values.count == 0) values.front = value;
+        values.back = value;
+        values.count++;
+    }
+}
+
+EnvelopeSnapshot EnvelopeSnapshot::take(TrackEnvelope& envelope, ReaperAPI const& api)
+{
+    EnvelopeSnapshot snapshot;
+    snapshot.envelope = &envelope;
+    snapshot.scalingMode = api.GetEnvelopeScalingMode(&envelope);
+    snapshot.hasAutomationItems = api.CountAutomationItems(&envelope) > 0;
+    // Sorted here rather than in REAPER, as the envelope belongs to the user's project and export shouldn't modify it
+    snapshot.points = api.getEnvelopePoints(&envelope);
+    std::stable_sort(snapshot.points.begin(), snapshot.points.end(), [](EnvelopePoint const& a, EnvelopePoint const& b) {
+        return a.time < b.time;
+    });
+    if(snapshot.scalingMode != 0) {
+        for(auto& point : snapshot.points) {
+            point.value = api.ScaleFromEnvelopeMode(snapshot.scalingMode, point.value);
+        }
+    }
+    return snapshot;
+}
+
+double ReaperEnvelopeEvaluator::evaluate(TrackEnvelope* envelope, int scalingMode, double time)
+{
+    double envValAtTime;
+    api.Envelope_Evaluate(envelope, time, 0, 0, &envValAtTime, nullptr, nullptr, nullptr);
+    return api.ScaleFromEnvelopeMode(scalingMode, envValAtTime);
+}
+
+MainThreadEnvelopeEvaluator::MainThreadEnvelopeEvaluator(ReaperAPI const& api) : reaperEvaluator{ api }, mainThreadId{ std::this_thread::get_id() }
+{
+}
+
+double MainThreadEnvelopeEvaluator::evaluate(TrackEnvelope* envelope, int scalingMode, double time)
+{
+    if(std::this_thread::get_id() == mainThreadId) {
+        return reaperEvaluator.evaluate(envelope, scalingMode, time);
+    }
+
+    Request request{ envelope, scalingMode, time };
+    std::unique_lock<std::mutex> lock(mutex);
+    requests.push_back(&request);
+    requestsPending.notify_one();
+    requestsServiced.wait(lock, [&request]() { return request.complete; });
+    return request.value;
+}
+
+void MainThreadEnvelopeEvaluator::runInParallel(std::vector<std::function<void()>> const& tasks)
+{
+    assert(std::this_thread::get_id() == mainThreadId);
+    if(tasks.empty()) return;
+
+    std::atomic<size_t> nextTask{ 0 };
+    std::exception_ptr firstException;
+    auto runTasks = [this, &tasks, &nextTask, &firstException]() {
+        for(size_t taskIndex = nextTask++; taskIndex < tasks.size(); taskIndex = nextTask++) {
+            try {
+                tasks[taskIndex]();
+            } catch(...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if(!firstException) firstException = std::current_exception();
+            }
+        }
+    };
+
+    auto workerCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), tasks.size());
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for(size_t n = 0; n < workerCount; n++) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            runningWorkers++;
+        }
+        try {
+            workers.emplace_back([this, runTasks]() {
+                runTasks();
+                std::lock_guard<std::mutex> lock(mutex);
+                runningWorkers--;
+                requestsPending.notify_one();
+            });
+        } catch(std::system_error const&) {
+            // Carry on with however many workers could be started
+            std::lock_guard<std::mutex> lock(mutex);
+            runningWorkers--;
+            break;
+        }
+    }
+    if(workers.empty()) {
+        runTasks(); // Evaluations are made directly on this thread
+    }
+
+    // Service evaluations until every worker has finished
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+        requestsPending.wait(lock, [this]() { return !requests.empty() || runningWorkers == 0; });
+        if(requests.empty()) break;
+        auto servicing = std::move(requests);
+        requests.clear();
+        lock.unlock();
+        for(auto request : servicing) {
+            request->value = reaperEvaluator.evaluate(request->envelope, request->scalingMode, request->time);
+        }
+        lock.lock();
+        for(auto request : servicing) {
+            request->complete = true;
+        }
+        requestsServiced.notify_all();
+    }
+    lock.unlock();
+
+    for(auto& worker : workers) {
+        worker.join();
+    }
+    if(firstException) std::rethrow_exception(firstException);
 }
 
 CumulatedPointData::CumulatedPointData(std::chrono::nanoseconds regionStart, std::chrono::nanoseconds regionEnd) : regionStart{ regionStart }, regionEnd{ regionEnd }
@@ -24,31 +145,21 @@ CumulatedPointData::CumulatedPointData(std::chrono::nanoseconds regionStart, std
     // If we just put an entry for that time in pointData, it will get populated during finalisation if not fulfilled by usual means
     auto startPoint = fromNs(regionStart);
     auto endPoint = fromNs(regionEnd);
-    pointsData.insert({ startPoint, std::map<AdmParameter, std::vector<double>>() });
-    pointsData.insert({ endPoint, std::map<AdmParameter, std::vector<double>>() });
+    pointTimes.push_back(startPoint);
+    if(endPoint > startPoint) pointTimes.push_back(endPoint);
+    else if(endPoint < startPoint) pointTimes.insert(pointTimes.begin(), endPoint);
 }
 
 std::vector<AdmAuthoringError> CumulatedPointData::useEnvelopeDataForParameter(TrackEnvelope& envelope, Parameter& parameter, AdmParameter admParameter, ReaperAPI const & api)
 {
-    // This function reads and parses the envelope state chunks.
-    // As well as point time and value, the state chunk includes shape data.
-    // This means we can appropriately handle non-linear shapes.
-
-    // Other data of interest in the state chunk;
-    /*
-    <PARMENV 1:49 0.000000 1.000000 0.500000
-    ACT 1 -1
-    VIS 1 1 1
-    LANEHEIGHT 0 0
-    ARM 1
-    DEFSHAPE 0 -1 -1
-    PT 0 0.5 0
-    PT 0.5 1 1
-    ...
-    PT 12 0.5 0
-    >
-    */
-    int envelopeScalingMode = api.GetEnvelopeScalingMode(&envelope);
+    ReaperEnvelopeEvaluator evaluator(api);
+    return useEnvelopeDataForParameter(EnvelopeSnapshot::take(envelope, api), parameter, admParameter, evaluator);
+}
+
+std::vector<AdmAuthoringError> CumulatedPointData::useEnvelopeDataForParameter(EnvelopeSnapshot envelope, Parameter& parameter, AdmParameter admParameter, EnvelopeEvaluator& evaluator)
+{
+    // Point shapes are snapshotted along with times and values, so we can appropriately handle non-linear shapes.
+    int envelopeScalingMode = envelope.scalingMode;
     std::vector<AdmAuthoringError> errors;
 
     if(admDataSources.count(admParameter) > 0) {
@@ -56,104 +167,56 @@ std::vector<AdmAuthoringError> CumulatedPointData::useEnvelopeDataForParameter(T
         errors.push_back(AdmAuthoringError("Attempting to assign an envelope as a data source to an ADM parameter which already has a data source."));
         return errors;
     }
-    if(getSortedTimesOfValuesForParameter(admParameter).size() > 0) {
+    if(haveDataFor(admParameter)) {
         assert(false);
         errors.push_back(AdmAuthoringError("Attempting to assign an envelope as a data source to an ADM parameter which already has parameter data."));
         return errors;
     }
-    api.Envelope_SortPoints(&envelope); // Means the stored non-linear points will be presorted
 
-    // Grab values from points data in state chunk
-    char chunk[512000]; // enough for about 12000 automation points
-    bool res = api.GetEnvelopeStateChunk(&envelope, chunk, 512000, false);
-    if(!res) {
-        assert(false);
-        errors.push_back(AdmAuthoringError("Could not get data for envelope to use as ADM parameter data source."));
-        return errors;
-    }
-    std::istringstream chunkSs(chunk);
-    std::string line;
-    bool chunkComplete = false; // Set when we find the end of the chunk so we know we read it all.
-
-    std::vector<double> nonLinearPointTimes;
+    std::vector<double> nonLinearPointTimes; // Points are presorted, so these will be too
 
     std::optional<double> normValueToPreceed; // For square envelopes, we need to insert an additional point at the next point time to hold the value.
 
-    while (std::getline(chunkSs, line)) {
-        if (line.rfind("PT", 0) == 0) {
-            // starts with PT, so point data
-            std::string::size_type end = line.find(" ");
-            double pointTime;
-            double normValue; // Note, values in chunk are already correct - no need to ScaleFromEnvelopeMode
-            int shape = EnvelopeShape::Linear; // Default - linear
-            bool complete = false;
-
-            try{
-                line.erase(0, end + 1);
-                if(line.size() > 0) pointTime = std::stod(line, &end);
-
-                line.erase(0, end + 1);
-                if(line.size() > 0) normValue = std::stod(line, &end);
-
-                complete = true;
-
-                line.erase(0, end + 1);
-                if(line.size() > 0) shape = std::stoi(line, &end);
-
-            } catch(std::invalid_argument e){
-                errors.push_back(AdmAuthoringError("Could not parse data for envelope point."));
+    for(auto const& point : envelope.points) {
+        if(point.time >= 0.0) {
+            double normValue = point.value;
+            if(normValueToPreceed.has_value()) {
+                // Store a point using the previous points value - used to hold envelopes for square shapes.
+                newPointData(point.time, admParameter, parameter.reverseMap(*normValueToPreceed));
+                normValueToPreceed.reset();
             }
-
-            assert(complete);
-            if(complete){
-                // Got time and value, and maybe shape (assumed 0 or "linear" if wasn't present)
-                if(pointTime >= 0.0) {
-                    if(normValueToPreceed.has_value()) {
-                        // Store a point using the previous points value - used to hold envelopes for square shapes.
-                        newPointData(pointTime, admParameter, parameter.reverseMap(*normValueToPreceed));
-                        normValueToPreceed.reset();
-                    }
-                    // Store current point
-                    newPointData(pointTime, admParameter, parameter.reverseMap(normValue));
-                    // Behaviour dependent on current envelope shape
-                    if(shape == EnvelopeShape::Square) {
-                        normValueToPreceed = normValue;
-                    } else if(shape != EnvelopeShape::Linear || envelopeScalingMode != 0) { // if the envelopeScalingMode is NOT 0, no ranges are linear
-                        nonLinearPointTimes.push_back(pointTime);
-                    }
-                } else {
-                    errors.push_back(AdmAuthoringError("Automation point found before 0:00.000 - will ignore."));
-                }
-            } else {
-                errors.push_back(AdmAuthoringError("Could not find all required values for envelope point whilst trying to parse envelope data."));
+            // Store current point
+            newPointData(point.time, admParameter, parameter.reverseMap(normValue));
+            // Behaviour dependent on current envelope shape
+            if(point.shape == EnvelopeShape::Square) {
+                normValueToPreceed = normValue;
+            } else if(point.shape != EnvelopeShape::Linear || envelopeScalingMode != 0) { // if the envelopeScalingMode is NOT 0, no ranges are linear
+                nonLinearPointTimes.push_back(point.time);
             }
-
-        } else if(line == ">") {
-            chunkComplete = true;
+        } else {
+            errors.push_back(AdmAuthoringError("Automation point found before 0:00.000 - will ignore."));
         }
     }
 
-    assert(chunkComplete);
-    if(!chunkComplete){
-        errors.push_back(AdmAuthoringError("Envelope data larger than expected. Some parameter values may be missing."));
+    AdmDataSource admDataSource{ envelope.envelope, &parameter, {}, envelopeScalingMode };
+    // Automation items are not in the point list but do affect the envelope, so REAPER must evaluate those
+    if(envelopeScalingMode == 0 && !envelope.hasAutomationItems) {
+        admDataSource.points = std::move(envelope.points);
     }
 
     // Figure out non-linear regions
     auto allPointTimes = getSortedTimesOfValuesForParameter(admParameter);
-    std::vector<std::pair<double, double>> nonLinearRegions;
     for(auto& startTime : nonLinearPointTimes) {
-        for(auto& pointTime : allPointTimes) {
-            if(pointTime > startTime) {
-                // Region found (has both a start and end time)
-                nonLinearRegions.push_back(std::make_pair(startTime, pointTime));
-                break;
-            }
+        auto endTimeIt = std::upper_bound(allPointTimes.begin(), allPointTimes.end(), startTime);
+        if(endTimeIt != allPointTimes.end()) {
+            // Region found (has both a start and end time)
+            admDataSource.nonLinearRegions.push_back(std::make_pair(startTime, *endTimeIt));
         }
     }
     // Fill in non-linear points
     for( auto const& [admParameter, admDataSource] : admDataSources )
     {
-        approximateNonLinearCurves(admParameter, api);
+        approximateNonLinearCurves(admParameter, evaluator);
     }
 
     if(DefaultEnvelopeCreator::isWrappedParam(admParameter)) {
@@ -162,21 +225,21 @@ std::vector<AdmAuthoringError> CumulatedPointData::useEnvelopeDataForParameter(T
         int newDataPoints = 0;
         do { // Keep creating these reinforcement points until no more are required.
             newDataPoints = 0;
-            auto allPointTimes = getSortedTimesOfValuesForParameter(admParameter);
-            for(int pointTimeIndex = 0; pointTimeIndex < (allPointTimes.size() - 1); pointTimeIndex++) {
-                double startTime = allPointTimes[pointTimeIndex];
-                double endTime = allPointTimes[pointTimeIndex + 1];
-                auto startValues = getValuesForParameterAtTime(startTime, admParameter);
-                auto endValues = getValuesForParameterAtTime(endTime, admParameter);
-                double startValueNorm = parameter.forwardMap(startValues.back());
-                double endValueNorm = parameter.forwardMap(endValues.front());
+            commitPoints();
+            // Midpoints are staged, so the indexes remain valid whilst adding them
+            auto timeIndexes = getTimeIndexesOfValuesForParameter(admParameter);
+            for(size_t n = 0; n + 1 < timeIndexes.size(); n++) {
+                double startTime = pointTimes[timeIndexes[n]];
+                double endTime = pointTimes[timeIndexes[n + 1]];
+                auto startValues = getPointValues(timeIndexes[n], admParameter);
+                auto endValues = getPointValues(timeIndexes[n + 1], admParameter);
+                double startValueNorm = parameter.forwardMap(startValues->back);
+                double endValueNorm = parameter.forwardMap(endValues->front);
                 double change = std::abs((double)(startValueNorm - endValueNorm));
                 double period = endTime - startTime;
                 if(change >= 0.5 && period > 0.001) {
                     double midTime = (period / 2.0) + startTime;
-                    double envValAtTime;
-                    api.Envelope_Evaluate(&envelope, midTime, 0, 0, &envValAtTime, nullptr, nullptr, nullptr);
-                    double normValAtTime = api.ScaleFromEnvelopeMode(envelopeScalingMode, envValAtTime);
+                    double normValAtTime = evaluateEnvelope(admDataSource, midTime, evaluator);
                     newPointData(midTime, admParameter, parameter.reverseMap(normValAtTime));
                     newDataPoints++;
                 }
@@ -185,7 +248,7 @@ std::vector<AdmAuthoringError> CumulatedPointData::useEnvelopeDataForParameter(T
     }
 
     // Register it
-    admDataSources.insert(std::make_pair(admParameter, AdmDataSource{ &envelope, &parameter, nonLinearRegions }));
+    admDataSources.insert(std::make_pair(admParameter, std::move(admDataSource)));
 
     return errors;
 }
@@ -199,7 +262,7 @@ std::vector<AdmAuthoringError> CumulatedPointData::useConstantValueForParameter(
         errors.push_back(AdmAuthoringError("Attempting to assign a constant value to an ADM parameter which already has a data source."));
         return errors;
     }
-    if(getSortedTimesOfValuesForParameter(admParameter).size() > 0) {
+    if(haveDataFor(admParameter)) {
         assert(false);
         errors.push_back(AdmAuthoringError("Attempting to assign a constant value to an ADM parameter which already has parameter data."));
         return errors;
@@ -211,49 +274,98 @@ std::vector<AdmAuthoringError> CumulatedPointData::useConstantValueForParameter(
 
 void CumulatedPointData::newPointData(double time, AdmParameter admParameter, double value)
 {
-    auto pointsDataIt = pointsData.find(time);
-    if(pointsDataIt == pointsData.end()) {
-        // Nothing at this timestamp yet
-        std::map < AdmParameter, std::vector<double>> paramValuePair;
-        paramValuePair.insert(std::make_pair(admParameter, std::vector<double>{value}));
-        pointsData.insert(std::make_pair(time, paramValuePair));
+    assert(admParameter != AdmParameter::NONE);
+    auto& column = pointValues[static_cast<size_t>(admParameter)];
+    if(column.empty()) column.resize(pointTimes.size());
+
+    auto timeIndex = findPointTimeIndex(time);
+    if(timeIndex) {
+        appendValue(column[*timeIndex], value);
     } else {
-        auto& pointsDataForTime = pointsDataIt->second;
-        auto pointsDataParamIt = pointsDataForTime.find(admParameter);
-        if(pointsDataParamIt == pointsDataForTime.end()) {
-            // Nothing for this parameter at this timestamp
-            pointsDataForTime.insert(std::make_pair(admParameter, std::vector<double>{value}));
-        } else {
-            // Append parameter to existing  at this timestamp yet
-            pointsDataParamIt->second.push_back(value);
-        }
+        // New timestamp - merged in on the next commit
+        pendingPoints.push_back(PendingPoint{ time, admParameter, value });
     }
 }
 
-std::vector<double> CumulatedPointData::getSortedPointTimes()
+void CumulatedPointData::commitPoints()
 {
-    std::vector<double> times;
-    for(auto const& [time, valuesMap] : pointsData) {
-        times.push_back(time);
+    if(pendingPoints.empty()) return;
+
+    // Stable, so multiple values for a parameter at the same time keep the order they were added in
+    std::stable_sort(pendingPoints.begin(), pendingPoints.end(), [](PendingPoint const& a, PendingPoint const& b) {
+        return a.time < b.time;
+    });
+
+    std::vector<double> mergedTimes;
+    mergedTimes.reserve(pointTimes.size() + pendingPoints.size());
+    auto pendingIt = pendingPoints.begin();
+    for(auto time : pointTimes) {
+        for(; pendingIt != pendingPoints.end() && pendingIt->time < time; pendingIt++) {
+            if(mergedTimes.empty() || mergedTimes.back() != pendingIt->time) mergedTimes.push_back(pendingIt->time);
+        }
+        mergedTimes.push_back(time);
+    }
+    for(; pendingIt != pendingPoints.end(); pendingIt++) {
+        if(mergedTimes.empty() || mergedTimes.back() != pendingIt->time) mergedTimes.push_back(pendingIt->time);
+    }
+
+    // Both are sorted, so existing times map across in a single pass
+    std::vector<size_t> mergedIndexes(pointTimes.size());
+    size_t mergedIndex = 0;
+    for(size_t timeIndex = 0; timeIndex < pointTimes.size(); timeIndex++) {
+        while(mergedTimes[mergedIndex] != pointTimes[timeIndex]) mergedIndex++;
+        mergedIndexes[timeIndex] = mergedIndex;
+    }
+    for(auto& column : pointValues) {
+        if(column.empty()) continue;
+        std::vector<PointValues> mergedColumn(mergedTimes.size());
+        for(size_t timeIndex = 0; timeIndex < column.size(); timeIndex++) {
+            mergedColumn[mergedIndexes[timeIndex]] = column[timeIndex];
+        }
+        column = std::move(mergedColumn);
+    }
+
+    mergedIndex = 0;
+    for(auto const& point : pendingPoints) {
+        while(mergedTimes[mergedIndex] != point.time) mergedIndex++;
+        appendValue(pointValues[static_cast<size_t>(point.admParameter)][mergedIndex], point.value);
     }
-    return times; // Map is inherently sorted, so vector is sorted
+
+    pointTimes = std::move(mergedTimes);
+    pendingPoints.clear();
+}
+
+std::optional<size_t> CumulatedPointData::findPointTimeIndex(double time) const
+{
+    auto timeIt = std::lower_bound(pointTimes.begin(), pointTimes.end(), time);
+    if(timeIt == pointTimes.end() || *timeIt != time) return std::optional<size_t>();
+    return static_cast<size_t>(timeIt - pointTimes.begin());
 }
 
-std::map<AdmParameter, std::vector<double>>* CumulatedPointData::getParameterMapAtTime(double time)
+PointValues const* CumulatedPointData::getPointValues(size_t timeIndex, AdmParameter admParameter) const
 {
-    auto paramMapIt = pointsData.find(time);
-    if(paramMapIt == pointsData.end()) return nullptr;
-    return &(paramMapIt->second);
+    if(admParameter == AdmParameter::NONE) return nullptr;
+    auto& column = pointValues[static_cast<size_t>(admParameter)];
+    if(timeIndex >= column.size() || column[timeIndex].count == 0) return nullptr;
+    return &column[timeIndex];
+}
+
+std::vector<double> const& CumulatedPointData::getSortedPointTimes()
+{
+    commitPoints();
+    return pointTimes;
 }
 
 std::vector<AdmParameter> CumulatedPointData::getParametersAtTime(double time)
 {
+    commitPoints();
     std::vector<AdmParameter> admParameters;
-    auto pointsDataAtTime = getParameterMapAtTime(time);
-    if(!pointsDataAtTime) return admParameters;
+    auto timeIndex = findPointTimeIndex(time);
+    if(!timeIndex) return admParameters;
 
-    for(auto const& [admParameter, values] : *pointsDataAtTime) {
-        if(values.size() > 0) {
+    for(int admParameterIndex = 0; admParameterIndex != (int)AdmParameter::NONE; admParameterIndex++) {
+        auto admParameter = (AdmParameter)admParameterIndex;
+        if(getPointValues(*timeIndex, admParameter)) {
             admParameters.push_back(admParameter);
         }
     }
@@ -261,60 +373,59 @@ std::vector<AdmParameter> CumulatedPointData::getParametersAtTime(double time)
     return admParameters;
 }
 
-std::vector<double> CumulatedPointData::getValuesForParameterAtTime(double time, AdmParameter admParameter)
+PointValues const* CumulatedPointData::getValuesForParameterAtTime(double time, AdmParameter admParameter)
 {
-    std::vector<double> values;
-    auto pointsDataAtTime = getParameterMapAtTime(time);
-    if(!pointsDataAtTime) return values;
+    commitPoints();
+    auto timeIndex = findPointTimeIndex(time);
+    if(!timeIndex) return nullptr;
+    return getPointValues(*timeIndex, admParameter);
+}
 
-    auto pointsDataAtTimeIt = pointsDataAtTime->find(admParameter);
-    if(pointsDataAtTimeIt != pointsDataAtTime->end()) {
-        return pointsDataAtTimeIt->second;
+std::vector<size_t> CumulatedPointData::getTimeIndexesOfValuesForParameter(AdmParameter admParameter) const
+{
+    std::vector<size_t> timeIndexes;
+    if(admParameter == AdmParameter::NONE) return timeIndexes;
+    auto& column = pointValues[static_cast<size_t>(admParameter)];
+    for(size_t timeIndex = 0; timeIndex < column.size(); timeIndex++) {
+        if(column[timeIndex].count > 0) timeIndexes.push_back(timeIndex);
     }
-
-    return values;
+    return timeIndexes; // Times are sorted, so these are too
 }
 
 std::vector<double> CumulatedPointData::getSortedTimesOfValuesForParameter(AdmParameter admParameter)
 {
+    commitPoints();
     std::vector<double> times;
-
-    for(auto const& [time, valuesMap] : pointsData)
-    {
-        auto valuesMapIt = valuesMap.find(admParameter);
-        if(valuesMapIt != valuesMap.end() && valuesMapIt->second.size() > 0) {
-            times.push_back(time);
-        }
-
+    for(auto timeIndex : getTimeIndexesOfValuesForParameter(admParameter)) {
+        times.push_back(pointTimes[timeIndex]);
     }
-
-    return times; // Map is inherently sorted, so vector is sorted
+    return times;
 }
 
-void CumulatedPointData::finaliseSphericalPositionParameters(ReaperAPI const& api)
+void CumulatedPointData::finaliseSphericalPositionParameters(EnvelopeEvaluator& evaluator)
 {
     // Ensure we have positional parameters on all data points
-    createValuesForParameterAtAllPointTimes(AdmParameter::OBJECT_AZIMUTH, 0.0, api);
-    ensureFinalPointPresent(AdmParameter::OBJECT_AZIMUTH, api);
-    createValuesForParameterAtAllPointTimes(AdmParameter::OBJECT_ELEVATION, 0.0, api);
-    ensureFinalPointPresent(AdmParameter::OBJECT_ELEVATION, api);
-    createValuesForParameterAtAllPointTimes(AdmParameter::SPEAKER_AZIMUTH, 0.0, api);
-    ensureFinalPointPresent(AdmParameter::SPEAKER_AZIMUTH, api);
-    createValuesForParameterAtAllPointTimes(AdmParameter::SPEAKER_ELEVATION, 0.0, api);
-    ensureFinalPointPresent(AdmParameter::SPEAKER_ELEVATION, api);
+    createValuesForParameterAtAllPointTimes(AdmParameter::OBJECT_AZIMUTH, 0.0, evaluator);
+    ensureFinalPointPresent(AdmParameter::OBJECT_AZIMUTH);
+    createValuesForParameterAtAllPointTimes(AdmParameter::OBJECT_ELEVATION, 0.0, evaluator);
+    ensureFinalPointPresent(AdmParameter::OBJECT_ELEVATION);
+    createValuesForParameterAtAllPointTimes(AdmParameter::SPEAKER_AZIMUTH, 0.0, evaluator);
+    ensureFinalPointPresent(AdmParameter::SPEAKER_AZIMUTH);
+    createValuesForParameterAtAllPointTimes(AdmParameter::SPEAKER_ELEVATION, 0.0, evaluator);
+    ensureFinalPointPresent(AdmParameter::SPEAKER_ELEVATION);
 }
 
-void CumulatedPointData::finaliseCartesianPositionParameters(ReaperAPI const & api)
+void CumulatedPointData::finaliseCartesianPositionParameters(EnvelopeEvaluator& evaluator)
 {
     // Ensure we have positional parameters on all data points
-    createValuesForParameterAtAllPointTimes(AdmParameter::OBJECT_X, 0.0, api);
-    ensureFinalPointPresent(AdmParameter::OBJECT_X, api);
-    createValuesForParameterAtAllPointTimes(AdmParameter::OBJECT_Y, 0.0, api);
-    ensureFinalPointPresent(AdmParameter::OBJECT_Y, api);
+    createValuesForParameterAtAllPointTimes(AdmParameter::OBJECT_X, 0.0, evaluator);
+    ensureFinalPointPresent(AdmParameter::OBJECT_X);
+    createValuesForParameterAtAllPointTimes(AdmParameter::OBJECT_Y, 0.0, evaluator);
+    ensureFinalPointPresent(AdmParameter::OBJECT_Y);
     // Note that there are no cartesian parameters for DirectSpeakers in BS.2076-2
 }
 
-void CumulatedPointData::finaliseOtherParameters(ReaperAPI const & api)
+void CumulatedPointData::finaliseOtherParameters(EnvelopeEvaluator& evaluator)
 {
     // Iterate through existing params at all times.
     // If any parameter is evaluated to not default, we should create a value here
@@ -323,14 +434,14 @@ void CumulatedPointData::finaliseOtherParameters(ReaperAPI const & api)
         auto admParameterDefaultVal = getAdmParameterDefault(admParameter);
 
         if(admParameterDefaultVal.has_value()) {
-            createValuesForParameterAtAllPointTimes(admParameter, *admParameterDefaultVal, api, false);
+            createValuesForParameterAtAllPointTimes(admParameter, *admParameterDefaultVal, evaluator, false);
         }
 
-        ensureFinalPointPresent(admParameter, api);
+        ensureFinalPointPresent(admParameter);
     }
 }
 
-int CumulatedPointData::approximateNonLinearCurves(AdmParameter admParameter, ReaperAPI const & api)
+int CumulatedPointData::approximateNonLinearCurves(AdmParameter admParameter, EnvelopeEvaluator& evaluator)
 {
     auto admDataSourcesIt = admDataSources.find(admParameter);
     if(admDataSourcesIt == admDataSources.end()) return 0;
@@ -338,16 +449,15 @@ int CumulatedPointData::approximateNonLinearCurves(AdmParameter admParameter, Re
     int newPointTimesCount = 0;
 
     for(auto& region : admDataSource->nonLinearRegions) {
+        commitPoints();
 
         // - Firstly search for existing timestamps within the non-linear regions and fill those parameter values in - it's a free win - param data with no additional block created.
 
-        for(auto& time : getSortedPointTimes()) {
-            if(time <= region.first) continue;
-            if(time >= region.second) break;
-            double envValAtTime;
-            api.Envelope_Evaluate(admDataSource->envelope, time, 0, 0, &envValAtTime, nullptr, nullptr, nullptr);
-            int envelopeScalingMode = api.GetEnvelopeScalingMode(admDataSource->envelope);
-            double normValAtTime = api.ScaleFromEnvelopeMode(envelopeScalingMode, envValAtTime);
+        // Values at existing times are set in place, so pointTimes is unchanged by this loop
+        for(auto timeIt = std::upper_bound(pointTimes.begin(), pointTimes.end(), region.first);
+            timeIt != pointTimes.end() && *timeIt < region.second; timeIt++) {
+            double time = *timeIt;
+            double normValAtTime = evaluateEnvelope(*admDataSource, time, evaluator);
             newPointData(time, admParameter, admDataSource->parameter->reverseMap(normValAtTime));
         }
 
@@ -357,21 +467,23 @@ int CumulatedPointData::approximateNonLinearCurves(AdmParameter admParameter, Re
         // Start at next approximation step
         timeInMs = timeInMs - (timeInMs % CURVE_APPROXIMATION_STEP_MS) + CURVE_APPROXIMATION_STEP_MS;
 
+        // Check points only move forward, so the last one added is the only staged point which can affect the next
+        std::optional<std::pair<double, double>> lastNewPoint;
+
         while(true) {
             double pointTime = (timeInMs / 1000.0);
             if(pointTime > region.second) break;
 
-            double envValAtTime;
-            api.Envelope_Evaluate(admDataSource->envelope, pointTime, 0, 0, &envValAtTime, nullptr, nullptr, nullptr);
-            int envelopeScalingMode = api.GetEnvelopeScalingMode(admDataSource->envelope);
-            double realValAtTime = api.ScaleFromEnvelopeMode(envelopeScalingMode, envValAtTime);
+            double realValAtTime = evaluateEnvelope(*admDataSource, pointTime, evaluator);
 
-            auto impliedValAtTime = getAdmImpliedValueForParameterAtTime(pointTime, admParameter, admDataSource->parameter);
+            auto impliedValAtTime = getAdmImpliedValueFromPoints(pointTime, admParameter, admDataSource->parameter, lastNewPoint);
             assert(impliedValAtTime.has_value()); // This should definitely return a value - we're bound by 2 known points.
             double deviation = std::abs((double)(realValAtTime - *impliedValAtTime));
 
             if(deviation > CURVE_APPROXIMATION_DEVIATION_THRESHOLD) {
-                newPointData(pointTime, admParameter, admDataSource->parameter->reverseMap(realValAtTime));
+                auto value = admDataSource->parameter->reverseMap(realValAtTime);
+                newPointData(pointTime, admParameter, value);
+                lastNewPoint = std::make_pair(pointTime, value);
                 newPointTimesCount++;
             }
 
@@ -385,29 +497,43 @@ int CumulatedPointData::approximateNonLinearCurves(AdmParameter admParameter, Re
 
 std::optional<double> CumulatedPointData::getAdmImpliedValueForParameterAtTime(double targetTime, AdmParameter admParameter, Parameter* parameter)
 {
-    auto existingValuesAtTime = getValuesForParameterAtTime(targetTime, admParameter);
-    if(existingValuesAtTime.size() > 0) return parameter->forwardMap(existingValuesAtTime.back());
+    commitPoints();
+    return getAdmImpliedValueFromPoints(targetTime, admParameter, parameter, std::optional<std::pair<double, double>>());
+}
 
-    std::optional<double> pointBefore{};
-    for(auto pointTime : getSortedTimesOfValuesForParameter(admParameter)) {
-        if(pointTime < targetTime) {
-            if(pointBefore.has_value()) {
-                if(pointTime > *pointBefore) pointBefore = pointTime;
-            } else { // No value yet
-                pointBefore = pointTime;
-            }
-        } else if(pointTime > targetTime) {
-            // Got just past targetTime now... make sure we had a pointBefore
-            if(pointBefore.has_value()) {
-                double beforeTime = *pointBefore;
-                double afterTime = pointTime;
-                double beforeValue = parameter->forwardMap(getValuesForParameterAtTime(beforeTime, admParameter).back());
-                double afterValue = parameter->forwardMap(getValuesForParameterAtTime(afterTime, admParameter).back());
-                // Interpolate between the two values.
-                double progression = (targetTime - beforeTime) / (afterTime - beforeTime); // How far progressed targetTime is from beforeTime (0.0) towards afterTime (1.0)
-                return std::optional<double>(beforeValue + ((afterValue - beforeValue) * progression));
-            }
-            return std::optional<double>(); // We've got beyond targetTime without finding a pointBefore
+std::optional<double> CumulatedPointData::getAdmImpliedValueFromPoints(double targetTime, AdmParameter admParameter, Parameter* parameter, std::optional<std::pair<double, double>> stagedPointBefore) const
+{
+    if(admParameter == AdmParameter::NONE) return std::optional<double>();
+    auto& column = pointValues[static_cast<size_t>(admParameter)];
+    if(column.empty()) return std::optional<double>();
+
+    auto timeIt = std::lower_bound(pointTimes.begin(), pointTimes.end(), targetTime);
+    size_t timeIndex = timeIt - pointTimes.begin();
+    if(timeIt != pointTimes.end() && *timeIt == targetTime) {
+        if(column[timeIndex].count > 0) return parameter->forwardMap(column[timeIndex].back);
+        timeIndex++;
+    }
+
+    // Nearest points either side - usually adjacent, as points are filled in at all times within automated regions
+    std::optional<std::pair<double, double>> pointBefore = stagedPointBefore;
+    for(size_t beforeIndex = timeIt - pointTimes.begin(); beforeIndex-- > 0;) {
+        if(pointBefore.has_value() && pointTimes[beforeIndex] <= pointBefore->first) break;
+        if(column[beforeIndex].count > 0) {
+            pointBefore = std::make_pair(pointTimes[beforeIndex], column[beforeIndex].back);
+            break;
+        }
+    }
+    if(!pointBefore.has_value()) return std::optional<double>();
+
+    for(size_t afterIndex = timeIndex; afterIndex < pointTimes.size(); afterIndex++) {
+        if(column[afterIndex].count > 0) {
+            double beforeTime = pointBefore->first;
+            double afterTime = pointTimes[afterIndex];
+            double beforeValue = parameter->forwardMap(pointBefore->second);
+            double afterValue = parameter->forwardMap(column[afterIndex].back);
+            // Interpolate between the two values.
+            double progression = (targetTime - beforeTime) / (afterTime - beforeTime); // How far progressed targetTime is from beforeTime (0.0) towards afterTime (1.0)
+            return std::optional<double>(beforeValue + ((afterValue - beforeValue) * progression));
         }
     }
 
@@ -426,25 +552,25 @@ bool CumulatedPointData::haveEnvelopeFor(AdmParameter admParameter)
 
 bool CumulatedPointData::haveDataFor(AdmParameter admParameter)
 {
-    for(auto const& [time, valuesMap] : pointsData)
-    {
-        auto valuesMapIt = valuesMap.find(admParameter);
-        if(valuesMapIt != valuesMap.end()) {
-            if(valuesMapIt->second.size() > 0) return true;
-        }
-    }
-    return false;
+    commitPoints();
+    if(admParameter == AdmParameter::NONE) return false;
+    auto& column = pointValues[static_cast<size_t>(admParameter)];
+    return std::any_of(column.begin(), column.end(), [](PointValues const& values) { return values.count > 0; });
 }
 
 bool CumulatedPointData::multipleValuesForSingleParameterAtTime(double time)
 {
-    auto pointsDataAtTime = getParameterMapAtTime(time);
-    if(!pointsDataAtTime) return false;
+    commitPoints();
+    auto timeIndex = findPointTimeIndex(time);
+    if(!timeIndex) return false;
+    return multipleValuesForSingleParameterAtTimeIndex(*timeIndex);
+}
 
-    for(auto& [admParameter, values] : *pointsDataAtTime) {
-        if(values.size() > 1) return true;
+bool CumulatedPointData::multipleValuesForSingleParameterAtTimeIndex(size_t timeIndex) const
+{
+    for(auto& column : pointValues) {
+        if(timeIndex < column.size() && column[timeIndex].count > 1) return true;
     }
-
     return false;
 }
 
@@ -452,30 +578,37 @@ std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>> Cumula
 {
     // Use spherical if no plug-in suite/instance provided, or determine from plug-in suite
     bool useSph = !pluginSuite || !pluginInst || pluginSuite->pluginUsesSphericalCoordinates(pluginInst); // Use spherical if no plug-in suite provided, or determine from plug-in suite
+    ReaperEnvelopeEvaluator evaluator(api);
+    return generateAudioBlockFormatObjects(useSph, evaluator);
+}
 
+std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>> CumulatedPointData::generateAudioBlockFormatObjects(bool useSphericalCoordinates, EnvelopeEvaluator& evaluator)
+{
     // Fill in missing parameter values so that all blocks will have position data (mandatory)
-    if(useSph) {
-        finaliseSphericalPositionParameters(api);
+    if(useSphericalCoordinates) {
+        finaliseSphericalPositionParameters(evaluator);
     } else {
-        finaliseCartesianPositionParameters(api);
+        finaliseCartesianPositionParameters(evaluator);
     }
     // Fill in other parameters at all point times if they don't equate to the default
-    finaliseOtherParameters(api);
+    finaliseOtherParameters(evaluator);
 
     // Now create the blocks
     std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> blocks;
 
-    auto times = getSortedPointTimes();
+    auto& times = getSortedPointTimes();
     auto lastEndTime = toNs(0.0);
 
     auto audioObjectDuration = regionEnd - regionStart;
 
-    for(auto timeIt = times.begin(); timeIt != times.end(); timeIt++) {
+    for(size_t timeIndex = 0; timeIndex != times.size(); timeIndex++) {
+
+        const auto time = times[timeIndex];
+        const auto timeNs = toNs(time);
+        const bool multipleValuesAtTime = multipleValuesForSingleParameterAtTimeIndex(timeIndex);
 
-        const auto timeNs = toNs(*timeIt);
-        
-        // Use front or back of parameter values vectors
-        bool processBack = (*timeIt == 0.0); // For starting block, no point doing front and back - front would be ineffective.
+        // Use front or back of parameter values
+        bool processBack = (time == 0.0); // For starting block, no point doing front and back - front would be ineffective.
 
         while(true) {
 
@@ -493,56 +626,61 @@ std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>> Cumula
                     duration = endTime;
                 }
 
-                if(useSph) {
-                    auto azVals = getValuesForParameterAtTime(*timeIt, AdmParameter::OBJECT_AZIMUTH);
-                    auto azVal = processBack ? azVals.back() : azVals.front();
-                    auto elVals = getValuesForParameterAtTime(*timeIt, AdmParameter::OBJECT_ELEVATION);
-                    auto elVal = processBack ? elVals.back() : elVals.front();
+                auto valueAt = [this, timeIndex, processBack](AdmParameter admParameter) -> std::optional<double> {
+                    auto values = getPointValues(timeIndex, admParameter);
+                    if(!values) return std::optional<double>();
+                    return processBack ? values->back : values->front;
+                };
 
-                    auto sphPos = adm::SphericalPosition((adm::Azimuth)azVal, (adm::Elevation)elVal);
+                if(useSphericalCoordinates) {
+                    // Finalisation guarantees position values at every time
+                    auto azVal = valueAt(AdmParameter::OBJECT_AZIMUTH);
+                    auto elVal = valueAt(AdmParameter::OBJECT_ELEVATION);
+                    assert(azVal.has_value() && elVal.has_value());
 
-                    auto distVals = getValuesForParameterAtTime(*timeIt, AdmParameter::OBJECT_DISTANCE);
-                    if(distVals.size() > 0) {
-                        sphPos.set((adm::Distance)(processBack ? distVals.back() : distVals.front()));
+                    auto sphPos = adm::SphericalPosition((adm::Azimuth)azVal.value_or(0.0), (adm::Elevation)elVal.value_or(0.0));
+
+                    if(auto distVal = valueAt(AdmParameter::OBJECT_DISTANCE)) {
+                        sphPos.set((adm::Distance)*distVal);
                     }
 
                     block = std::make_shared<adm::AudioBlockFormatObjects>(sphPos);
 
                 } else {
-                    auto xVals = getValuesForParameterAtTime(*timeIt, AdmParameter::OBJECT_X);
-                    auto xVal = processBack ? xVals.back() : xVals.front();
-                    auto yVals = getValuesForParameterAtTime(*timeIt, AdmParameter::OBJECT_Y);
-                    auto yVal = processBack ? yVals.back() : yVals.front();
+                    auto xVal = valueAt(AdmParameter::OBJECT_X);
+                    auto yVal = valueAt(AdmParameter::OBJECT_Y);
+                    assert(xVal.has_value() && yVal.has_value());
 
-                    auto cartPos = adm::CartesianPosition((adm::X)xVal, (adm::Y)yVal);
+                    auto cartPos = adm::CartesianPosition((adm::X)xVal.value_or(0.0), (adm::Y)yVal.value_or(0.0));
 
-                    auto zVals = getValuesForParameterAtTime(*timeIt, AdmParameter::OBJECT_Z);
-                    if(zVals.size() > 0) {
-                        cartPos.set((adm::Z)(processBack ? zVals.back() : zVals.front()));
+                    if(auto zVal = valueAt(AdmParameter::OBJECT_Z)) {
+                        cartPos.set((adm::Z)*zVal);
                     }
 
                     block = std::make_shared<adm::AudioBlockFormatObjects>(cartPos);
                 }
 
-                for(auto const&[admParameter, values] : *getParameterMapAtTime(*timeIt)) {
+                for(auto admParameter : { AdmParameter::OBJECT_HEIGHT, AdmParameter::OBJECT_WIDTH, AdmParameter::OBJECT_DEPTH, AdmParameter::OBJECT_GAIN, AdmParameter::OBJECT_DIFFUSE }) {
+                    auto value = valueAt(admParameter);
+                    if(!value) continue;
                     switch(admParameter) {
                         case AdmParameter::OBJECT_GAIN:
-                            block->set(adm::Gain::fromLinear(processBack ? values.back() : values.front()));
+                            block->set(adm::Gain::fromLinear(*value));
                             break;
                         case AdmParameter::OBJECT_HEIGHT:
-                            block->set((adm::Height)(processBack ? values.back() : values.front()));
+                            block->set((adm::Height)*value);
                             break;
                         case AdmParameter::OBJECT_WIDTH:
-                            block->set((adm::Width)(processBack ? values.back() : values.front()));
+                            block->set((adm::Width)*value);
                             break;
                         case AdmParameter::OBJECT_DEPTH:
-                            block->set((adm::Depth)(processBack ? values.back() : values.front()));
+                            block->set((adm::Depth)*value);
                             break;
                         case AdmParameter::OBJECT_DIFFUSE:
-                            block->set((adm::Diffuse)(processBack ? values.back() : values.front()));
+                            block->set((adm::Diffuse)*value);
                             break;
 
-                            // TODO: Add any other parameters we want to support here
+                            // TODO: Add any other parameters we want to support here (and to the list above)
                     }
                 }
 
@@ -551,7 +689,7 @@ std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>> Cumula
                 block->set((adm::Duration)duration);
 
                 // Use JumpPosition for second block if multiple points at same position
-                if (multipleValuesForSingleParameterAtTime(*timeIt) && processBack) {
+                if (multipleValuesAtTime && processBack) {
                     block->set(adm::JumpPosition((adm::JumpPositionFlag)true));
                 }
 
@@ -561,7 +699,7 @@ std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>> Cumula
             lastEndTime = timeNs;
 
             // If we have already created an additional point or we don't need to create an additional point anyway, quit.
-            if(processBack || !multipleValuesForSingleParameterAtTime(*timeIt)) break;
+            if(processBack || !multipleValuesAtTime) break;
             processBack = true; // Create an additional block for this time
 
         }
@@ -570,44 +708,64 @@ std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>> Cumula
     return std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>>(blocks);
 }
 
-void CumulatedPointData::createValuesForParameterAtAllPointTimes(AdmParameter admParameter, double defaultVal, ReaperAPI const & api, bool createEvenIfAlreadyDefault)
+double CumulatedPointData::evaluateEnvelope(AdmDataSource const& admDataSource, double time, EnvelopeEvaluator& evaluator) const
+{
+    // Linear and square segments are trivial, so evaluate those here rather than going through REAPER for each value.
+    // Anything else (on points, curved shapes, other scaling modes, automation items) is left to REAPER.
+    auto& points = admDataSource.points;
+    auto nextIt = std::upper_bound(points.begin(), points.end(), time, [](double time, EnvelopePoint const& point) {
+        return time < point.time;
+    });
+    if(nextIt != points.begin() && nextIt != points.end()) {
+        auto& prev = *(nextIt - 1);
+        auto& next = *nextIt;
+        if(prev.time < time) {
+            if(prev.shape == EnvelopeShape::Square) {
+                return prev.value;
+            }
+            if(prev.shape == EnvelopeShape::Linear) {
+                return prev.value + ((next.value - prev.value) * ((time - prev.time) / (next.time - prev.time)));
+            }
+        }
+    }
+
+    return evaluator.evaluate(admDataSource.envelope, admDataSource.scalingMode, time);
+}
+
+void CumulatedPointData::createValuesForParameterAtAllPointTimes(AdmParameter admParameter, double defaultVal, EnvelopeEvaluator& evaluator, bool createEvenIfAlreadyDefault)
 {
-    auto allTimes = getSortedPointTimes();
-    int newDataPoints = 0;
+    // Only adds values at existing times, so these are unchanged throughout
+    auto& allTimes = getSortedPointTimes();
 
     auto admDataSourcesIt = admDataSources.find(admParameter);
     if(admDataSourcesIt != admDataSources.end()) {
         // We have an envelope we can refer to to get the true interpolated value
-        auto env = admDataSourcesIt->second.envelope;
-        int envelopeScalingMode = api.GetEnvelopeScalingMode(env);
         auto param = admDataSourcesIt->second.parameter;
-        for(auto& time : allTimes) {
-            if(getValuesForParameterAtTime(time, admParameter).size() == 0) {
+        for(size_t timeIndex = 0; timeIndex < allTimes.size(); timeIndex++) {
+            if(!getPointValues(timeIndex, admParameter)) {
                 // Need to create a value for this parameter at this time
-                double envValAtTime;
-                api.Envelope_Evaluate(env, time, 0, 0, &envValAtTime, nullptr, nullptr, nullptr);
-                double realValAtTime = api.ScaleFromEnvelopeMode(envelopeScalingMode, envValAtTime);
+                double realValAtTime = evaluateEnvelope(admDataSourcesIt->second, allTimes[timeIndex], evaluator);
                 auto convValAtTime = param->reverseMap(realValAtTime);
                 if(createEvenIfAlreadyDefault || !valueWithinTolerance(convValAtTime, defaultVal)) {
-                    newPointData(time, admParameter, convValAtTime);
+                    newPointData(allTimes[timeIndex], admParameter, convValAtTime);
                 }
             }
         }
         return;
     }
 
-    auto valueTimes = getSortedTimesOfValuesForParameter(admParameter);
-    if(valueTimes.size() > 0){
+    auto valueTimeIndexes = getTimeIndexesOfValuesForParameter(admParameter);
+    if(valueTimeIndexes.size() > 0){
         // No envelope, but we have a value we can use.
         // Sanity check; If it is a non-automated parameter, we should expect only one value and it should be at time 0.
-        assert(valueTimes.size() == 1);
-        assert(valueTimes[0] == 0.0);
+        assert(valueTimeIndexes.size() == 1);
+        assert(allTimes[valueTimeIndexes[0]] == 0.0);
 
-        double val = getValuesForParameterAtTime(valueTimes[0], admParameter).back();
+        double val = getPointValues(valueTimeIndexes[0], admParameter)->back;
         if(createEvenIfAlreadyDefault || !valueWithinTolerance(val, defaultVal)) {
-            for(auto& time : allTimes) {
-                if(getValuesForParameterAtTime(time, admParameter).size() == 0) {
-                    newPointData(time, admParameter, val);
+            for(size_t timeIndex = 0; timeIndex < allTimes.size(); timeIndex++) {
+                if(!getPointValues(timeIndex, admParameter)) {
+                    newPointData(allTimes[timeIndex], admParameter, val);
                 }
             }
         }
@@ -618,10 +776,10 @@ void CumulatedPointData::createValuesForParameterAtAllPointTimes(AdmParameter ad
     // This would be unusual (because we should at least have set one by getting the FX param value if there was no envelope), but we need to fall back to a default value.
     // It could occur if the plugin suite did not say it supported this parameter (but it should have done if it's a mandatory parameter such as coordinate!)
     if(createEvenIfAlreadyDefault) {
-        for(auto& time : allTimes) {
+        for(size_t timeIndex = 0; timeIndex < allTimes.size(); timeIndex++) {
             // Need to put the default value in at all times
-            if(getValuesForParameterAtTime(time, admParameter).size() == 0) {
-                newPointData(time, admParameter, defaultVal);
+            if(!getPointValues(timeIndex, admParameter)) {
+                newPointData(allTimes[timeIndex], admParameter, defaultVal);
             }
         }
     }
@@ -629,23 +787,22 @@ void CumulatedPointData::createValuesForParameterAtAllPointTimes(AdmParameter ad
     return;
 }
 
-void CumulatedPointData::ensureFinalPointPresent(AdmParameter admParameter, ReaperAPI const & api)
+void CumulatedPointData::ensureFinalPointPresent(AdmParameter admParameter)
 {
     // We have to do this due to REAPER's "hold" behaviour after a last envelope point
     // Conversely, ADM would return to default values
     // - so we need ensure we have an AudioBlock to cover the full duration by ensuring we have a "final" point
 
-    auto pointTimes = getSortedTimesOfValuesForParameter(admParameter);
-    if(pointTimes.size() == 0) return; // No points ever created - we're not using this parameter
+    commitPoints();
+    auto pointTimeIndexes = getTimeIndexesOfValuesForParameter(admParameter);
+    if(pointTimeIndexes.size() == 0) return; // No points ever created - we're not using this parameter
 
-    auto allTimes = getSortedPointTimes();
-    if(allTimes.size() == 0) return; // Should never happen, but safe-guard
-    auto reqFinalPointTime = allTimes.back();
+    if(pointTimes.size() == 0) return; // Should never happen, but safe-guard
+    auto reqFinalPointTime = pointTimes.back();
 
-    if(pointTimes.back() == reqFinalPointTime) return; // Already have parameter value at this time
+    if(pointTimeIndexes.back() == pointTimes.size() - 1) return; // Already have parameter value at this time
 
-    auto lastValues = getValuesForParameterAtTime(pointTimes.back(), admParameter);
-    if(lastValues.size() == 0) return; // Should never happen, but safe-guard
-    auto lastValue = lastValues.back();
-    newPointData(reqFinalPointTime, admParameter, lastValue);
+    auto lastValues = getPointValues(pointTimeIndexes.back(), admParameter);
+    if(!lastValues) return; // Should never happen, but safe-guard
+    newPointData(reqFinalPointTime, admParameter, lastValues->back);
 }
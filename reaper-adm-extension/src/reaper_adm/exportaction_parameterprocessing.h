@@ -1,6 +1,11 @@
 #pragma once
 
+#include <array>
+#include <condition_variable>
+#include <functional>
 #include <map>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <optional>
 #include <adm/adm.hpp>
@@ -22,6 +27,72 @@ inline double fromNs(std::chrono::nanoseconds ns) {
 
 using namespace admplug;
 
+// Values for one parameter at one point time. A parameter can take more than one value at the same time
+// (e.g, to jump from one value to another), but only the first and last are ever needed.
+struct PointValues {
+    double front{ 0.0 };
+    double back{ 0.0 };
+    uint32_t count{ 0 }; // Zero if the parameter has no value at this time
+};
+
+// Everything needed from REAPER to use an envelope as a data source, so that it can be processed away from the main thread
+struct EnvelopeSnapshot {
+    TrackEnvelope* envelope{ nullptr };
+    int scalingMode{ 0 };
+    bool hasAutomationItems{ false };
+    std::vector<EnvelopePoint> points; // Sorted by time, with values scaled from the envelope mode
+
+    static EnvelopeSnapshot take(TrackEnvelope& envelope, ReaperAPI const& api);
+};
+
+// Provides envelope values which can not be worked out from a snapshot alone
+class EnvelopeEvaluator
+{
+public:
+    virtual ~EnvelopeEvaluator() = default;
+    // Value at `time`, scaled from the envelope mode
+    virtual double evaluate(TrackEnvelope* envelope, int scalingMode, double time) = 0;
+};
+
+class ReaperEnvelopeEvaluator : public EnvelopeEvaluator
+{
+public:
+    explicit ReaperEnvelopeEvaluator(ReaperAPI const& api) : api{ api } {}
+    double evaluate(TrackEnvelope* envelope, int scalingMode, double time) override;
+
+private:
+    ReaperAPI const& api;
+};
+
+// REAPER may only be called from the main thread. Whilst runInParallel() waits for its tasks,
+// the main thread services the evaluations those tasks request.
+class MainThreadEnvelopeEvaluator : public EnvelopeEvaluator
+{
+public:
+    explicit MainThreadEnvelopeEvaluator(ReaperAPI const& api);
+    double evaluate(TrackEnvelope* envelope, int scalingMode, double time) override; // Blocks until serviced
+
+    // Must be called from the main thread. Returns once every task has run, rethrowing the first exception thrown by any of them.
+    void runInParallel(std::vector<std::function<void()>> const& tasks);
+
+private:
+    struct Request {
+        TrackEnvelope* envelope;
+        int scalingMode;
+        double time;
+        double value{ 0.0 };
+        bool complete{ false };
+    };
+
+    ReaperEnvelopeEvaluator reaperEvaluator;
+    std::thread::id mainThreadId;
+    std::mutex mutex;
+    std::condition_variable requestsPending; // Main thread waits on this
+    std::condition_variable requestsServiced; // Workers wait on this
+    std::vector<Request*> requests;
+    size_t runningWorkers{ 0 };
+};
+
 class CumulatedPointData
 {
 public:
@@ -29,22 +100,23 @@ public:
     ~CumulatedPointData() {};
 
     std::vector<AdmAuthoringError> useEnvelopeDataForParameter(TrackEnvelope& envelope, Parameter& parameter, AdmParameter admParameter, ReaperAPI const& api);
+    std::vector<AdmAuthoringError> useEnvelopeDataForParameter(EnvelopeSnapshot envelope, Parameter& parameter, AdmParameter admParameter, EnvelopeEvaluator& evaluator);
     std::vector<AdmAuthoringError> useConstantValueForParameter(AdmParameter admParameter, double value);
 
-    std::vector<double> getSortedPointTimes();
-    std::map<AdmParameter, std::vector<double>>* getParameterMapAtTime(double time);
+    std::vector<double> const& getSortedPointTimes();
     std::vector<AdmParameter> getParametersAtTime(double time);
-    std::vector<double> getValuesForParameterAtTime(double time, AdmParameter admParameter);
+    PointValues const* getValuesForParameterAtTime(double time, AdmParameter admParameter); // nullptr if none
     std::vector<double> getSortedTimesOfValuesForParameter(AdmParameter admParameter);
-    void finaliseSphericalPositionParameters(ReaperAPI const& api);
-    void finaliseCartesianPositionParameters(ReaperAPI const& api);
-    void finaliseOtherParameters(ReaperAPI const& api);
+    void finaliseSphericalPositionParameters(EnvelopeEvaluator& evaluator);
+    void finaliseCartesianPositionParameters(EnvelopeEvaluator& evaluator);
+    void finaliseOtherParameters(EnvelopeEvaluator& evaluator);
     std::optional<double> getAdmImpliedValueForParameterAtTime(double time, AdmParameter admParameter, Parameter* parameter);
     bool haveEnvelopeFor(AdmParameter admParameter);
     bool haveDataFor(AdmParameter admParameter);
     bool multipleValuesForSingleParameterAtTime(double time);
 
     std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>> generateAudioBlockFormatObjects(std::shared_ptr<admplug::PluginSuite> pluginSuite, PluginInstance* pluginInst, ReaperAPI const& api);
+    std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>>> generateAudioBlockFormatObjects(bool useSphericalCoordinates, EnvelopeEvaluator& evaluator);
     std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatDirectSpeakers>>> generateAudioBlockFormatDirectSpeakers(std::shared_ptr<admplug::PluginSuite> pluginSuite, PluginInstance* pluginInst, ReaperAPI const& api);
     std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatBinaural>>> generateAudioBlockFormatBinaural(std::shared_ptr<admplug::PluginSuite> pluginSuite, PluginInstance* pluginInst, ReaperAPI const& api);
     std::optional<std::vector<std::shared_ptr<adm::AudioBlockFormatMatrix>>> generateAudioBlockFormatMatrix(std::shared_ptr<admplug::PluginSuite> pluginSuite, PluginInstance* pluginInst, ReaperAPI const& api);
@@ -55,15 +127,40 @@ private:
         TrackEnvelope* envelope;
         Parameter* parameter;
         std::vector<std::pair<double, double>> nonLinearRegions;
+        int scalingMode;
+        std::vector<EnvelopePoint> points; // As EnvelopeSnapshot. Only held if they can be evaluated locally (see evaluateEnvelope)
     };
 
     std::map<AdmParameter, AdmDataSource> admDataSources;
-    std::map<double, std::map<AdmParameter, std::vector<double>>> pointsData;
+
+    // Point data is held column-wise; `pointTimes` is sorted and unique, and every parameter with data
+    // has a column of values parallel to it (empty if it has none).
+    // Values at times not yet in `pointTimes` are staged in `pendingPoints` until commitPoints(),
+    // so that adding many points does not shift the columns each time.
+    struct PendingPoint {
+        double time;
+        AdmParameter admParameter;
+        double value;
+    };
+    std::vector<double> pointTimes;
+    std::array<std::vector<PointValues>, static_cast<size_t>(AdmParameter::NONE)> pointValues;
+    std::vector<PendingPoint> pendingPoints;
 
     void newPointData(double time, AdmParameter admParameter, double value);
-    void createValuesForParameterAtAllPointTimes(AdmParameter admParameter, double defaultVal, ReaperAPI const& api, bool createEvenIfAlreadyDefault = true);
-    void ensureFinalPointPresent(AdmParameter admParameter, ReaperAPI const& api);
-    int approximateNonLinearCurves(AdmParameter admParameter, ReaperAPI const& api);
+    void commitPoints();
+    // These only see committed points
+    std::optional<size_t> findPointTimeIndex(double time) const;
+    PointValues const* getPointValues(size_t timeIndex, AdmParameter admParameter) const;
+    bool multipleValuesForSingleParameterAtTimeIndex(size_t timeIndex) const;
+    std::vector<size_t> getTimeIndexesOfValuesForParameter(AdmParameter admParameter) const;
+    // `stagedPointBefore` is a (time, value) point not yet committed, which precedes `targetTime`
+    std::optional<double> getAdmImpliedValueFromPoints(double targetTime, AdmParameter admParameter, Parameter* parameter,
+                                                       std::optional<std::pair<double, double>> stagedPointBefore) const;
+    // Normalised value of the data source's envelope at `time`
+    double evaluateEnvelope(AdmDataSource const& admDataSource, double time, EnvelopeEvaluator& evaluator) const;
+    void createValuesForParameterAtAllPointTimes(AdmParameter admParameter, double defaultVal, EnvelopeEvaluator& evaluator, bool createEvenIfAlreadyDefault = true);
+    void ensureFinalPointPresent(AdmParameter admParameter);
+    int approximateNonLinearCurves(AdmParameter admParameter, EnvelopeEvaluator& evaluator);
 
     std::chrono::nanoseconds regionStart;
     std::chrono::nanoseconds regionEnd;
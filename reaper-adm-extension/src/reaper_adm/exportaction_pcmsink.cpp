@@ -1,13 +1,14 @@
 #include "exportaction_pcmsink.h"
+#include "exportaction.h"
 
 #include "adm/adm.hpp"
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/write.hpp"
 
+#include <chrono>
+
 #ifdef _WIN32
 #include <Windows.h>
-#else
-#define Sleep(ms) sleep((double)ms / 1000.0)
 #endif
 
 #ifdef _MSC_VER
@@ -102,10 +103,16 @@ PCM_sink_adm::PCM_sink_adm(std::shared_ptr<ReaperAPI> api, const char *fn, void
         }
     }
 
-    // Start writing
-    auto chna = admExportSources->getChnaChunk();
-    auto axml = admExportSources->getAxmlChunk();
-    writer = bw64::writeFile(admFilename, totalChannels, sRate, 24, chna, axml);
+    // Start writing - the AXML is serialised straight into the file here, so the document must be final
+    std::vector<std::shared_ptr<bw64::Chunk>> chunks;
+    if (auto chna = admExportSources->getChnaChunk()) chunks.push_back(chna);
+    if (auto axml = admExportSources->getAxmlChunk()) chunks.push_back(axml);
+    auto sampleFormat = ExportManager::ExportInfo.getSampleFormat(cfgdata, cfgdata_l);
+    if (isFloat(sampleFormat)) {
+        floatWriter = std::make_unique<FloatWriter>(admFilename, totalChannels, sRate, chunks);
+    } else {
+        writer = std::make_unique<bw64::Bw64Writer>(admFilename, totalChannels, sRate, bitDepth(sampleFormat), chunks);
+    }
 
     // Start Renders
     admExportSources->setRenderInProgress(true);
@@ -113,41 +120,63 @@ PCM_sink_adm::PCM_sink_adm(std::shared_ptr<ReaperAPI> api, const char *fn, void
 
 PCM_sink_adm::~PCM_sink_adm()
 {
-    if (writer) {
-        // Flush out data remaining in socket queues
-
-        int loopCounter = 0;
-        int loopLimit = 40; // 40*50ms = 2s - if they've not got through the queue by then, they're probably not coming!
-        while (actualFramesWritten < expectedFramesWritten && loopCounter < loopLimit) {
-
-            while(int frameCount = processNextFrames(expectedFramesWritten) > 0) {
-                actualFramesWritten += frameCount;
-            }
-            if(actualFramesWritten == expectedFramesWritten) break;
+    auto admExportSources = admExportHandler->getAdmExportSources();
 
-            Sleep(50); // Give NNG I/O thread chance to work it's queue
-            loopCounter++;
+    // Stop Renders - sources then mark the end of their streams after their last block,
+    // so we can tell exactly when everything queued has been received
+    if (admExportSources) admExportSources->setRenderInProgress(false);
+
+    if (hasWriter()) {
+        // Flush out data remaining in the queues.
+        // Waits are driven by frame arrival; the deadline only covers sources which never signal end-of-stream.
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (actualFramesWritten < expectedFramesWritten &&
+               !admExportSources->isEndOfStream() &&
+               !(blockWriter && blockWriter->hasFailed()) &&
+               std::chrono::steady_clock::now() < deadline) {
+            processNextFrames(expectedFramesWritten);
         }
 
+        finishWriting();
+
         if (actualFramesWritten < expectedFramesWritten) {
             // Warn user - didn't receive all the frames we expected
             auto msg = std::string("Warning:\r\n");
             msg += "Received ";
             msg += std::to_string(actualFramesWritten);
             msg += " frames from export source \"";
-            msg += admExportHandler->getAdmExportSources()->getExportSourcesName();
+            msg += admExportSources->getExportSourcesName();
             msg += "\".\r\n";
             msg += "Expected ";
             msg += std::to_string(expectedFramesWritten);
             msg += " frames.";
+            if (!admExportSources->isEndOfStream()) {
+                msg += "\r\nThe export source did not signal the end of its stream.";
+            }
+            if (auto dropped = admExportSources->getDroppedFrames()) {
+                msg += "\r\nThe export source dropped ";
+                msg += std::to_string(dropped);
+                msg += " frames as the render got too far ahead of the export.";
+            }
             api->ShowMessageBox(msg.c_str(), "Render", 0);
         }
 
         writer.reset();
+        floatWriter.reset();
     }
+}
 
-    // Stop Renders
-    admExportHandler->getAdmExportSources()->setRenderInProgress(false);
+void PCM_sink_adm::finishWriting() {
+    if (!blockWriter) return;
+    if (!blockWriter->finish()) {
+        auto msg = std::string("Error writing \"");
+        msg += admFilenameStr;
+        msg += "\":\r\n";
+        msg += blockWriter->getError();
+        msg += "\r\nThe rendered file is incomplete.";
+        api->ShowMessageBox(msg.c_str(), "Render", 0);
+    }
+    blockWriter.reset();
 }
 
 void PCM_sink_adm::abortRender() {
@@ -171,7 +200,7 @@ INT64 PCM_sink_adm::GetFileSize()
 
 void PCM_sink_adm::GetOutputInfoString(char *buf, int buflen)
 {
-    if (writer) {
+    if (hasWriter()) {
         strncpy(buf, "Rendering ADM tracks...", buflen);
     }
     else {
@@ -182,15 +211,13 @@ void PCM_sink_adm::GetOutputInfoString(char *buf, int buflen)
 
 void PCM_sink_adm::WriteDoubles(double **samples, int len, int nch, int offset, int spacing)
 {
-    if (!writer) return;
-
-    // First call sets up aggregatedBlockBuffer (because we need to know the default block size, which should be len)
-    if (aggregatedBlockBufferStart == nullptr){
-        aggregatedBlockBufferFrameCount = len;
-        aggregatedBlockBufferSize = aggregatedBlockBufferFrameCount * totalChannels;
-        assert(aggregatedBlockBufferSize > 0);
-        aggregatedBlockBuffer = std::vector<float>(aggregatedBlockBufferSize, 0.0);
-        aggregatedBlockBufferStart = &aggregatedBlockBuffer.front();
+    if (!hasWriter()) return;
+
+    // First call sets up blockWriter (because we need to know the default block size, which should be len)
+    if (!blockWriter){
+        assert(len > 0);
+        blockWriter = writer ? std::make_unique<AsyncBlockWriter>(*writer, totalChannels, len)
+                             : std::make_unique<AsyncBlockWriter>(*floatWriter, totalChannels, len);
     }
 
     expectedFramesWritten += len;
@@ -201,24 +228,23 @@ void PCM_sink_adm::WriteDoubles(double **samples, int len, int nch, int offset,
 
 int PCM_sink_adm::processNextFrames(uint64_t toMaxFrame){
 
-    float *bufferWritePos = aggregatedBlockBufferStart;
-    size_t sampleSize = sizeof(float);
-    int framesWrittenToBlockBuffer = 0;
-    int frameWriteLimit = (int)aggregatedBlockBufferSize;
+    if (!blockWriter) return 0;
+
+    int frameWriteLimit = (int)blockWriter->getBlockFrameCount();
 
     if (toMaxFrame > 0) {
-        frameWriteLimit = (int)min(frameWriteLimit, toMaxFrame - actualFramesWritten); // Shouldn't ever be negative, but the loop below would catch that anyway.
+        frameWriteLimit = (int)min((uint64_t)frameWriteLimit, toMaxFrame - actualFramesWritten); // Shouldn't ever be negative, but writeNextFramesTo would catch that anyway.
     }
+    if (frameWriteLimit <= 0) return 0;
 
-    while (framesWrittenToBlockBuffer < frameWriteLimit && nextFrameReady()) {
-        auto writeSuccess = admExportHandler->getAdmExportSources()->writeNextFrameTo(bufferWritePos, true); // true = skip frame availability check - we've already done it
-        assert(writeSuccess);
-        bufferWritePos += totalChannels;
-        framesWrittenToBlockBuffer++;
-    }
+    // Conversion and disk I/O happen on the writer thread - we only wait here if it has fallen a full queue behind
+    float* block = blockWriter->acquireBlock();
+    if (!block) return 0; // A write has failed - reported when the render finishes
+
+    int framesWrittenToBlockBuffer = admExportHandler->getAdmExportSources()->writeNextFramesTo(block, frameWriteLimit);
 
     if (framesWrittenToBlockBuffer > 0) {
-        writer->write(aggregatedBlockBufferStart, framesWrittenToBlockBuffer);
+        blockWriter->submitBlock(framesWrittenToBlockBuffer);
         actualFramesWritten += framesWrittenToBlockBuffer;
     }
 
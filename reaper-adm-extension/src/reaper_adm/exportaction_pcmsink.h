@@ -5,6 +5,8 @@
 #include "reaperapi.h"
 #include "reaper_plugin.h"
 #include "exportaction_admsourcescontainer.h"
+#include "exportaction_blockwriter.h"
+#include "floatwriter.h"
 
 using namespace admplug;
 
@@ -32,6 +34,7 @@ private:
     const char* admFilename;
     std::string admFilenameStr;
     std::unique_ptr<bw64::Bw64Writer> writer;
+    std::unique_ptr<FloatWriter> floatWriter; // Instead of writer, for float formats
     int sRate;
     int totalChannels;
 
@@ -40,15 +43,13 @@ private:
     uint64_t expectedFramesWritten{ 0 };
     uint64_t actualFramesWritten{ 0 };
 
+    bool hasWriter() const { return writer || floatWriter; }
     void abortRender();
     int processNextFrames(uint64_t toMaxFrame);
     bool nextFrameReady();
 
-    std::vector<float> aggregatedBlockBuffer; // predefined to prevent reserving memory on every call to process a block
-    float *aggregatedBlockBufferStart{ nullptr }; // Faster than calling begin() everytime.
-    float *aggregatedBlockBufferEnd{ nullptr }; // Faster than calling end() everytime.
-    float *aggregatedBlockBufferPos{ nullptr }; // Current write position
-    size_t aggregatedBlockBufferSize{ 0 };
-    size_t aggregatedBlockBufferFrameCount{ 0 };
+    void finishWriting();
+
+    std::unique_ptr<AsyncBlockWriter> blockWriter; // Blocks are preallocated, so no memory is reserved on every call to process a block
 };
 
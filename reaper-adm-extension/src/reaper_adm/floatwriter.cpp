@@ -0,0 +1,104 @@
+#include "floatwriter.h"
+#include <bw64/bw64.hpp>
+#include <limits>
+#include <stdexcept>
+
+using namespace admplug;
+
+namespace {
+  constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT{0x0003};
+  constexpr uint32_t FLOAT_BYTES{sizeof(float)};
+  constexpr uint64_t MAX_SIZE{std::numeric_limits<uint32_t>::max()};
+  // RIFF header, ds64-sized JUNK and 18 byte fmt chunk, up to the fact chunk's sample count
+  constexpr uint64_t FACT_LENGTH_POSITION{12 + 8 + 28 + 8 + 18 + 8};
+
+  void writeLittleEndian(std::ostream& file, uint64_t value, int bytes) {
+      for(int i = 0; i != bytes; ++i) {
+          file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+      }
+  }
+}
+
+FloatWriter::FloatWriter(std::string const& fileName,
+                         std::size_t channelCount,
+                         std::size_t sampleRate,
+                         std::vector<std::shared_ptr<bw64::Chunk>> const& chunks) :
+    file{fileName, std::ios::binary | std::ios::trunc},
+    channels{static_cast<uint16_t>(channelCount)}
+{
+    if(!file) {
+        throw std::runtime_error("Could not open " + fileName + " for writing");
+    }
+    file.write("RIFF", 4);
+    writeLittleEndian(file, 0, 4);
+    file.write("WAVE", 4);
+    file.write("JUNK", 4);
+    writeLittleEndian(file, 28, 4);
+    writeLittleEndian(file, 0, 28);
+    file.write("fmt ", 4);
+    writeLittleEndian(file, 18, 4);
+    writeLittleEndian(file, WAVE_FORMAT_IEEE_FLOAT, 2);
+    writeLittleEndian(file, channels, 2);
+    writeLittleEndian(file, sampleRate, 4);
+    writeLittleEndian(file, sampleRate * channels * FLOAT_BYTES, 4);
+    writeLittleEndian(file, channels * FLOAT_BYTES, 2);
+    writeLittleEndian(file, FLOAT_BYTES * 8, 2);
+    writeLittleEndian(file, 0, 2);
+    file.write("fact", 4);
+    writeLittleEndian(file, 4, 4);
+    writeLittleEndian(file, 0, 4);
+    for(auto const& chunk : chunks) {
+        auto size = chunk->size();
+        if(size > MAX_SIZE) {
+            // Would need a ds64 table entry, which the reserved space doesn't allow for
+            throw std::runtime_error("Chunk too large to write to " + fileName);
+        }
+        writeLittleEndian(file, chunk->id(), 4);
+        writeLittleEndian(file, size, 4);
+        chunk->write(file);
+        if(size % 2) file.put(0);
+    }
+    file.write("data", 4);
+    writeLittleEndian(file, 0, 4);
+    dataStart = static_cast<uint64_t>(file.tellp());
+    if(!file) {
+        throw std::runtime_error("Could not write header of " + fileName);
+    }
+}
+
+FloatWriter::~FloatWriter() {
+    auto const dataSize = frames * channels * FLOAT_BYTES;
+    auto const riffSize = dataStart - 8 + dataSize;
+    if(riffSize < MAX_SIZE) {
+        file.seekp(4);
+        writeLittleEndian(file, riffSize, 4);
+        file.seekp(FACT_LENGTH_POSITION);
+        writeLittleEndian(file, frames, 4);
+        file.seekp(dataStart - 4);
+        writeLittleEndian(file, dataSize, 4);
+    } else {
+        file.seekp(0);
+        file.write("RF64", 4);
+        writeLittleEndian(file, MAX_SIZE, 4);
+        file.seekp(12);
+        file.write("ds64", 4);
+        writeLittleEndian(file, 28, 4);
+        writeLittleEndian(file, riffSize, 8);
+        writeLittleEndian(file, dataSize, 8);
+        writeLittleEndian(file, frames, 8);
+        writeLittleEndian(file, 0, 4);
+        file.seekp(FACT_LENGTH_POSITION);
+        writeLittleEndian(file, MAX_SIZE, 4);
+        file.seekp(dataStart - 4);
+        writeLittleEndian(file, MAX_SIZE, 4);
+    }
+}
+
+void FloatWriter::write(float const* frameData, uint64_t frameCount) {
+    file.write(reinterpret_cast<char const*>(frameData),
+               static_cast<std::streamsize>(frameCount * channels * FLOAT_BYTES));
+    if(!file) {
+        throw std::runtime_error("Could not write audio");
+    }
+    frames += frameCount;
+}
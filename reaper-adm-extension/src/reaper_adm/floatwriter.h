@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bw64 {
+    class Chunk;
+}
+
+namespace admplug {
+
+/*
+Writes 32 bit IEEE float files, which libbw64 can't - its writer only produces integer PCM,
+which clips anything above full scale.
+Used for stems of float sources, and for float export. The samples are already in that format
+(on the little-endian hosts REAPER runs on), so they go straight to the file.
+Any chunks given (e.g, chna and axml) are written ahead of the audio, as bw64::Bw64Writer does.
+A JUNK chunk reserves space for a ds64 chunk, which replaces it (along with the RIFF ID
+becoming RF64) if the file passes 4GB.
+*/
+class FloatWriter {
+public:
+    FloatWriter(std::string const& fileName,
+                std::size_t channelCount,
+                std::size_t sampleRate,
+                std::vector<std::shared_ptr<bw64::Chunk>> const& chunks = {});
+    // Completes the header, once the length is known
+    ~FloatWriter();
+    // Interleaved frames
+    void write(float const* frames, uint64_t frameCount);
+
+private:
+    std::ofstream file;
+    uint16_t channels;
+    uint64_t frames{0};
+    uint64_t dataStart{0};
+};
+
+}
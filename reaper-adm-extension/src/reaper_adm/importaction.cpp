@@ -9,8 +9,9 @@
 
 using namespace admplug;
 
-ImportAction::ImportAction(REAPER_PLUGIN_HINSTANCE hInstance, HWND main, std::shared_ptr<PluginSuite> suite) :
+ImportAction::ImportAction(REAPER_PLUGIN_HINSTANCE hInstance, HWND main, std::shared_ptr<PluginSuite> suite, ImportMode mode) :
     pluginSuite{suite},
+    mode{mode},
     hInstance{ hInstance }, main{main}
 {
 }
@@ -43,7 +44,8 @@ void ImportAction::performImport(MediaItem* fromMediaItem, std::string fileName,
     auto importer = std::make_unique<ADMImporter>(fromMediaItem,
                                                   fileName,
                                                   ImportContext{broadcast, progress, pluginSuite, api},
-                                                  projectPath);
+                                                  projectPath,
+                                                  mode);
     auto importExecutor = std::make_shared<ThreadedImport>(std::move(importer));
     // construction is for side effects - cleans up after itself when window closed
     new ReaperDialogBox(main, hInstance, progress, importExecutor);
@@ -15,7 +15,7 @@ namespace admplug {
 class ImportAction
 {
 public:
-    ImportAction(REAPER_PLUGIN_HINSTANCE hInstance, HWND main, std::shared_ptr<PluginSuite> suite);
+    ImportAction(REAPER_PLUGIN_HINSTANCE hInstance, HWND main, std::shared_ptr<PluginSuite> suite, ImportMode mode = ImportMode::EXTRACT_STEMS);
     void import(std::string importFile, const ReaperAPI& api);
     void import(MediaItem* source, const ReaperAPI& api);
 
@@ -24,6 +24,7 @@ public:
 
 private:
     std::shared_ptr<PluginSuite> pluginSuite;
+    ImportMode mode;
     REAPER_PLUGIN_HINSTANCE hInstance;
     static PCM_source* getSourceFromMediaItem(MediaItem* mediaItem, const ReaperAPI& api);
     static std::string getFilenameFromMediaItem(MediaItem* mediaItem, const ReaperAPI& api);
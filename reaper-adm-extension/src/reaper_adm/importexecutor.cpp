@@ -1,19 +1,21 @@
 #include "importexecutor.h"
 #include "importaction.h"
-
-#ifdef _WIN32
-#include <process.h>
-#endif
+#include <stdexcept>
+#include <utility>
 
 using namespace admplug;
 
-unsigned WINAPI importThreadFn(void* importer_ptr) {
-    auto executor = reinterpret_cast<ImportExecutor*>(importer_ptr);
-    executor->parse();
-    return 0;
+namespace {
+void runSteps(IADMImporter& action)
+{
+    if(action.parse()) {
+        action.extractAudio();
+        action.finishExtraction();
+    }
+}
 }
 
-SerialImport::SerialImport(std::shared_ptr<ADMImporter> action) : action{std::move(action)}
+SerialImport::SerialImport(std::shared_ptr<IADMImporter> action) : action{std::move(action)}
 {
 
 }
@@ -23,9 +25,14 @@ void SerialImport::start()
     parseAndExtract();
 }
 
+void SerialImport::parse()
+{
+    action->parse();
+}
+
 void SerialImport::parseAndExtract()
 {
-    action->extractAudio();
+    runSteps(*action);
 }
 
 void SerialImport::buildProject()
@@ -33,18 +40,38 @@ void SerialImport::buildProject()
     action->buildProject();
 }
 
-ThreadedImport::ThreadedImport(std::shared_ptr<ADMImporter> action) : action{std::move(action)}
+ThreadedImport::ThreadedImport(std::shared_ptr<IADMImporter> action) :
+    finished{std::make_shared<std::atomic<bool>>(false)},
+    action{std::move(action)}
 {
 }
 
 ThreadedImport::~ThreadedImport()
 {
-    closeThread();
+    if(!thread.joinable()) return;
+    if(!*finished) {
+        action->cancel();
+    }
+    if(*finished && thread.get_id() != std::this_thread::get_id()) {
+        thread.join();
+    } else {
+        thread.detach();
+    }
 }
 
 void ThreadedImport::start()
 {
-    thread = reinterpret_cast<HANDLE>(_beginthreadex(NULL, 0, &importThreadFn, this, 0, NULL));
+    if(thread.joinable()) return;
+    thread = std::thread{[action = action, finished = finished]() {
+        try {
+            runSteps(*action);
+        } catch(std::exception const& e) {
+            action->reportError(e);
+        } catch(...) {
+            action->reportError(std::runtime_error("Import failed with an unknown error"));
+        }
+        *finished = true;
+    }};
 }
 
 void ThreadedImport::parse()
@@ -54,19 +81,13 @@ void ThreadedImport::parse()
 
 void ThreadedImport::parseAndExtract()
 {
-    action->extractAudio();
+    runSteps(*action);
 }
 
 void ThreadedImport::buildProject() {
-    closeThread();
-    action->buildProject();
-}
-
-void ThreadedImport::closeThread()
-{
-    if(thread) {
-        CloseHandle(thread);
-        thread = nullptr;
+    // The audio is only ready once the worker's last step has run, so this doesn't wait on parsing or extraction
+    if(thread.joinable() && thread.get_id() != std::this_thread::get_id()) {
+        thread.join();
     }
-
+    action->buildProject();
 }
@@ -1,6 +1,7 @@
 #pragma once
+#include <atomic>
 #include <memory>
-#include "reaper_plugin.h"
+#include <thread>
 
 namespace admplug {
 class ImportExecutor {
@@ -12,30 +13,37 @@ public:
     virtual void buildProject() = 0;
 };
 
-class ADMImporter;
+class IADMImporter;
 
 class SerialImport : public ImportExecutor {
 public:
-    SerialImport(std::shared_ptr<ADMImporter> action);
+    SerialImport(std::shared_ptr<IADMImporter> action);
     void start();
+    void parse();
     void parseAndExtract();
     void buildProject();
 private:
-    std::shared_ptr<ADMImporter> action;
+    std::shared_ptr<IADMImporter> action;
 };
 
+/*
+Parses and extracts on a worker thread, leaving the main thread free to run the progress dialog.
+Anything the worker throws is reported through the importer, ending the import with an error.
+The worker shares ownership of the importer, so if this is destroyed part way through (e.g. the dialog
+was closed) the import is cancelled and the worker left to wind down on its own, rather than waited for.
+*/
 class ThreadedImport : public ImportExecutor {
 public:
-    ThreadedImport(std::shared_ptr<ADMImporter> action);
+    ThreadedImport(std::shared_ptr<IADMImporter> action);
     ~ThreadedImport();
     void start();
     void parse();
     void parseAndExtract();
     void buildProject();
 private:
-    void closeThread();
-    HANDLE thread{nullptr};
-    std::shared_ptr<ADMImporter> action;
+    std::thread thread;
+    std::shared_ptr<std::atomic<bool>> finished;
+    std::shared_ptr<IADMImporter> action;
 };
 
 }
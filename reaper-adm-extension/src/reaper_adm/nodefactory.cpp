@@ -10,9 +10,10 @@
 
 using namespace admplug;
 
-NodeCreator::NodeCreator(std::shared_ptr<IPCMSourceCreator> pcmCreator, MediaItem* fromMediaItem) :
+NodeCreator::NodeCreator(std::shared_ptr<IPCMSourceCreator> pcmCreator, MediaItem* fromMediaItem, std::shared_ptr<IADMMetaData const> metadata) :
     pcmCreator{std::move(pcmCreator)},
-    originalMediaItem{ fromMediaItem }
+    originalMediaItem{ fromMediaItem },
+    metadata{std::move(metadata)}
 {
 }
 
@@ -69,7 +70,7 @@ std::shared_ptr<ProjectNode> admplug::NodeCreator::createAutomationNode(ADMChann
         }
     }
 
-    // if no blocks default to object track
-    return std::make_shared<ProjectNode>(std::make_unique<ObjectAutomationElement>(channel, parentTrack, parentTake));
+    // if no blocks default to object track - object blocks may not have been parsed yet
+    return std::make_shared<ProjectNode>(std::make_unique<ObjectAutomationElement>(channel, parentTrack, parentTake, metadata));
 
 }
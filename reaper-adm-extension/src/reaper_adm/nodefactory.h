@@ -16,6 +16,7 @@ class ObjectAutomation;
 class MediaTrackElement;
 
 class IPCMSourceCreator;
+class IADMMetaData;
 
 class NodeFactory
 {
@@ -53,7 +54,8 @@ public:
 
 class NodeCreator : public NodeFactory {
 public:
-    NodeCreator(std::shared_ptr<IPCMSourceCreator> pcmCreator, MediaItem* fromMediaItem = nullptr);
+    NodeCreator(std::shared_ptr<IPCMSourceCreator> pcmCreator, MediaItem* fromMediaItem = nullptr,
+                std::shared_ptr<IADMMetaData const> metadata = nullptr);
     NodeCreator(NodeFactory const& other) = delete;
     NodeCreator& operator=(NodeFactory const& other) = delete;
     std::shared_ptr<ProjectNode> createObjectTrackNode(std::shared_ptr<const adm::AudioObject> representedAudioObject, std::shared_ptr<const adm::AudioTrackUid> representedAudioTrackUid, std::vector<adm::ElementConstVariant> elements, std::shared_ptr<TrackElement> parentGroupTrack) override;
@@ -69,6 +71,7 @@ public:
 private:
     std::shared_ptr<IPCMSourceCreator> pcmCreator;
     MediaItem* originalMediaItem;
+    std::shared_ptr<IADMMetaData const> metadata;
     int currentGroup{0};
 
 };
@@ -6,6 +6,7 @@
 #include "reaperapi.h"
 #include "parameter.h"
 #include "plugin.h"
+#include "admmetadata.h"
 
 #include "admextraction.h"
 //#include "automation.h"
@@ -60,8 +61,10 @@ std::optional<AutomationPoint> getPoint(Parameter const& param, adm::AudioBlockF
 
 ObjectAutomationElement::ObjectAutomationElement(ADMChannel admChannel,
                                                 std::shared_ptr<TrackElement> track,
-                                                std::shared_ptr<TakeElement> take) :
-    admChannel{std::move(admChannel)}
+                                                std::shared_ptr<TakeElement> take,
+                                                std::shared_ptr<IADMMetaData const> metadata) :
+    admChannel{std::move(admChannel)},
+    metadata{std::move(metadata)}
 {
     parentTake_ = take;
     parentTrack_ = track;
@@ -75,6 +78,7 @@ void ObjectAutomationElement::createProjectElements(PluginSuite &pluginSuite, co
 adm::BlockFormatsConstRange<adm::AudioBlockFormatObjects> ObjectAutomationElement::blocks() const
 {
     if(!admChannel.channelFormat()) return adm::BlockFormatsConstRange<adm::AudioBlockFormatObjects>();
+    loadBlockFormats();
     return admChannel.channelFormat()->getElements<adm::AudioBlockFormatObjects>();
 }
 
@@ -103,6 +107,13 @@ ADMChannel ObjectAutomationElement::channel() const
     return admChannel;
 }
 
+void ObjectAutomationElement::loadBlockFormats() const
+{
+    if(metadata && admChannel.channelFormat()) {
+        metadata->loadBlockFormats(*admChannel.channelFormat());
+    }
+}
+
 std::vector<adm::ElementConstVariant> admplug::ObjectAutomationElement::getAdmElements() const
 {
     if(!admChannel.channelFormat()) return std::vector<adm::ElementConstVariant>();
@@ -161,6 +172,7 @@ namespace {
 std::vector<AutomationPoint> ObjectAutomationElement::pointsFor(Parameter const& parameter) const {
     std::vector<AutomationPoint> parameterPoints;
     if(admChannel.channelFormat()) {
+        loadBlockFormats();
         for(auto& block : admChannel.channelFormat()->getElements<adm::AudioBlockFormatObjects>()) {
             auto interpolationLength = getInterpolationLength(block);
             auto duration = getValueOrZero<adm::Duration>(block);
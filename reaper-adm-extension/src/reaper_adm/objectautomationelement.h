@@ -10,10 +10,12 @@ class Parameter;
 class PluginParameter;
 class TrackParameter;
 class Track;
+class IADMMetaData;
 
 class ObjectAutomationElement : public ObjectAutomation {
 public:
-    ObjectAutomationElement(ADMChannel channel, std::shared_ptr<TrackElement> parentTrack, std::shared_ptr<TakeElement> parentTake = nullptr);
+    ObjectAutomationElement(ADMChannel channel, std::shared_ptr<TrackElement> parentTrack, std::shared_ptr<TakeElement> parentTake = nullptr,
+                            std::shared_ptr<IADMMetaData const> metadata = nullptr);
     void createProjectElements(PluginSuite &pluginSuite, const ReaperAPI &api) override;
     adm::BlockFormatsConstRange<adm::AudioBlockFormatObjects> blocks() const override;
     double startTime() const override;
@@ -24,6 +26,8 @@ public:
 private:
     std::vector<adm::ElementConstVariant> getAdmElements() const override;
     std::vector<AutomationPoint> pointsFor(const Parameter &parameter) const;
+    void loadBlockFormats() const;
     ADMChannel admChannel;
+    std::shared_ptr<IADMMetaData const> metadata;
 };
 }
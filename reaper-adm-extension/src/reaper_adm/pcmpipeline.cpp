@@ -0,0 +1,178 @@
+#include "pcmpipeline.h"
+#include "pcmreader.h"
+#include "pcmwriter.h"
+#include <algorithm>
+
+using namespace admplug;
+
+PCMPipeline::PCMPipeline(PCMReader& reader,
+                         std::vector<std::unique_ptr<IPCMWriter>> const& writers,
+                         std::size_t writerThreadCount,
+                         std::size_t ringBlocks) :
+    ring(std::max<std::size_t>(ringBlocks, 1))
+{
+    if(writerThreadCount == 0) {
+        auto cores = std::thread::hardware_concurrency();
+        writerThreadCount = cores > 1 ? cores - 1 : 1;
+    }
+    writerThreadCount = std::min(writerThreadCount, writers.size());
+
+    for(std::size_t i = 0; i != writerThreadCount; ++i) {
+        writerThreads.push_back(std::make_unique<WriterThread>());
+    }
+    for(std::size_t i = 0; i != writers.size(); ++i) {
+        writerThreads[i % writerThreadCount]->writers.push_back(writers[i].get());
+    }
+
+    try {
+        for(auto& writerThread : writerThreads) {
+            auto& state = *writerThread;
+            state.thread = std::thread([this, &state]() { writeBlocks(state); });
+        }
+        readerThread = std::thread([this, &reader]() { readBlocks(reader); });
+    } catch(...) {
+        cancel();
+        joinAll();
+        throw;
+    }
+}
+
+PCMPipeline::~PCMPipeline()
+{
+    cancel();
+    joinAll();
+}
+
+std::size_t PCMPipeline::framesWritten() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(writerThreads.empty()) {
+        return framesRead;
+    }
+    auto slowest = std::min_element(writerThreads.begin(), writerThreads.end(), [](auto const& a, auto const& b) {
+        return a->framesWritten < b->framesWritten;
+    });
+    return (*slowest)->framesWritten;
+}
+
+bool PCMPipeline::waitUntilFinished(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    return progressed.wait_for(lock, timeout, [this]() { return stopped || allWritten(); });
+}
+
+void PCMPipeline::cancel()
+{
+    stopWith(nullptr);
+}
+
+void PCMPipeline::finish()
+{
+    joinAll();
+    std::exception_ptr exception;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        exception = firstException;
+        std::fill(ring.begin(), ring.end(), nullptr);
+    }
+    if(exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+void PCMPipeline::readBlocks(PCMReader& reader)
+{
+    try {
+        while(true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                spaceAvailable.wait(lock, [this]() { return stopped || blocksRead - slowestBlocksWritten() < ring.size(); });
+                if(stopped) return;
+            }
+
+            auto block = reader.read();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if(block->frameCount() == 0) {
+                readingComplete = true;
+            } else {
+                framesRead += block->frameCount();
+                ring[blocksRead % ring.size()] = std::move(block);
+                ++blocksRead;
+            }
+            blockAvailable.notify_all();
+            progressed.notify_all();
+            if(readingComplete) return;
+        }
+    } catch(...) {
+        stopWith(std::current_exception());
+    }
+}
+
+void PCMPipeline::writeBlocks(WriterThread& writerThread)
+{
+    try {
+        while(true) {
+            std::shared_ptr<IPCMBlock> block;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                blockAvailable.wait(lock, [this, &writerThread]() {
+                    return stopped || readingComplete || writerThread.blocksWritten < blocksRead;
+                });
+                if(stopped || writerThread.blocksWritten == blocksRead) return;
+                block = ring[writerThread.blocksWritten % ring.size()];
+            }
+
+            for(auto writer : writerThread.writers) {
+                writer->write(*block);
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ++writerThread.blocksWritten;
+            writerThread.framesWritten += block->frameCount();
+            spaceAvailable.notify_one();
+            progressed.notify_all();
+        }
+    } catch(...) {
+        stopWith(std::current_exception());
+    }
+}
+
+void PCMPipeline::stopWith(std::exception_ptr exception)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(exception && !firstException) {
+        firstException = exception;
+    }
+    stopped = true;
+    blockAvailable.notify_all();
+    spaceAvailable.notify_all();
+    progressed.notify_all();
+}
+
+void PCMPipeline::joinAll()
+{
+    if(readerThread.joinable()) {
+        readerThread.join();
+    }
+    for(auto& writerThread : writerThreads) {
+        if(writerThread->thread.joinable()) {
+            writerThread->thread.join();
+        }
+    }
+}
+
+bool PCMPipeline::allWritten() const
+{
+    if(!readingComplete) return false;
+    return slowestBlocksWritten() == blocksRead;
+}
+
+std::size_t PCMPipeline::slowestBlocksWritten() const
+{
+    std::size_t slowest = blocksRead;
+    for(auto const& writerThread : writerThreads) {
+        slowest = std::min(slowest, writerThread->blocksWritten);
+    }
+    return slowest;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace admplug {
+
+class IPCMBlock;
+class IPCMWriter;
+class PCMReader;
+
+/*
+Feeds every block from a reader to every writer, as a pipeline:
+a reader thread prefetches blocks in to a ring, and writer threads - each owning a subset of the writers -
+work through the ring in order. The slowest writer thread holds back the reader once the ring is full.
+
+Starts on construction. The reader and writers must outlive the pipeline, and must not be used elsewhere until finish().
+*/
+class PCMPipeline
+{
+public:
+    static constexpr std::size_t DEFAULT_RING_BLOCKS{ 16 };
+
+    // A `writerThreadCount` of 0 uses one per core (leaving one for the reader), up to one per writer
+    PCMPipeline(PCMReader& reader,
+                std::vector<std::unique_ptr<IPCMWriter>> const& writers,
+                std::size_t writerThreadCount = 0,
+                std::size_t ringBlocks = DEFAULT_RING_BLOCKS);
+    ~PCMPipeline();
+
+    PCMPipeline(PCMPipeline const&) = delete;
+    PCMPipeline& operator=(PCMPipeline const&) = delete;
+
+    // Frames which every writer has written
+    std::size_t framesWritten() const;
+    // Returns true once all blocks have been written (or the pipeline has stopped), or false on timeout
+    bool waitUntilFinished(std::chrono::milliseconds timeout);
+    // Stops reading and writing after the blocks in progress
+    void cancel();
+    // Waits for the threads, then rethrows the first exception any of them threw
+    void finish();
+
+private:
+    struct WriterThread {
+        std::vector<IPCMWriter*> writers;
+        std::size_t blocksWritten{ 0 };
+        std::size_t framesWritten{ 0 };
+        std::thread thread;
+    };
+
+    void readBlocks(PCMReader& reader);
+    void writeBlocks(WriterThread& writerThread);
+    void stopWith(std::exception_ptr exception);
+    void joinAll();
+    bool allWritten() const; // Caller must hold the mutex
+    std::size_t slowestBlocksWritten() const; // Caller must hold the mutex
+
+    std::vector<std::shared_ptr<IPCMBlock>> ring;
+    std::size_t blocksRead{ 0 };
+    std::size_t framesRead{ 0 };
+    bool readingComplete{ false };
+    bool stopped{ false };
+    std::exception_ptr firstException;
+
+    mutable std::mutex mutex;
+    std::condition_variable blockAvailable;
+    std::condition_variable spaceAvailable;
+    std::condition_variable progressed;
+
+    std::vector<std::unique_ptr<WriterThread>> writerThreads;
+    std::thread readerThread;
+};
+
+}
@@ -1,5 +1,10 @@
 #include "pcmreader.h"
 #include <bw64/bw64.hpp>
+#include <helper/mapped_file.h>
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
 
 using namespace admplug;
 
@@ -9,15 +14,113 @@ namespace {
   public:
       explicit PCMBlock_(std::size_t blockSize,
                          std::size_t channelCount,
-                         std::size_t sampleRate) :
+                         std::size_t sampleRate,
+                         std::size_t bitDepth,
+                         bool isFloat) :
           PCMBlock{blockSize,
                    channelCount,
-                   sampleRate} {}
+                   sampleRate,
+                   bitDepth,
+                   isFloat} {}
   };
 
   constexpr std::size_t DEFAULT_BLOCK_SIZE{4096};
+
+  // For MappedBw64PCMReader blocks sized from the channel count
+  constexpr std::size_t TARGET_BLOCK_SAMPLES{1 << 16};
+  constexpr std::size_t MIN_BLOCK_SIZE{1024};
+  constexpr std::size_t MAX_BLOCK_SIZE{16384};
+
+  constexpr uint16_t WAVE_FORMAT_PCM{0x0001};
+  constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT{0x0003};
+  constexpr uint16_t WAVE_FORMAT_EXTENSIBLE{0xFFFE};
+
+  uint16_t readU16(unsigned char const* p) {
+      return static_cast<uint16_t>(p[0] | (p[1] << 8));
+  }
+
+  uint32_t readU32(unsigned char const* p) {
+      return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+             (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  uint64_t readU64(unsigned char const* p) {
+      return static_cast<uint64_t>(readU32(p)) | (static_cast<uint64_t>(readU32(p + 4)) << 32);
+  }
+
+  bool hasId(unsigned char const* p, char const* id) {
+      return std::memcmp(p, id, 4) == 0;
+  }
+
+  // Sample values match those bw64::Bw64Reader gives
+  void convertSamples(unsigned char const* in, float* out, std::size_t count, std::size_t bitDepth, bool isFloat) {
+      if(isFloat && bitDepth == 32) {
+          std::memcpy(out, in, count * sizeof(float));
+      } else if(isFloat) {
+          for(std::size_t i = 0; i != count; ++i, in += 8) {
+              double value;
+              std::memcpy(&value, in, sizeof(double));
+              out[i] = static_cast<float>(value);
+          }
+      } else if(bitDepth == 8) {
+          for(std::size_t i = 0; i != count; ++i, ++in) {
+              out[i] = static_cast<float>(static_cast<int>(in[0]) - 128) / 128.f;
+          }
+      } else if(bitDepth == 16) {
+          for(std::size_t i = 0; i != count; ++i, in += 2) {
+              out[i] = static_cast<float>(static_cast<int16_t>(readU16(in))) / 32768.f;
+          }
+      } else if(bitDepth == 24) {
+          for(std::size_t i = 0; i != count; ++i, in += 3) {
+              auto value = static_cast<int32_t>(static_cast<uint32_t>(in[0] << 8) | (static_cast<uint32_t>(in[1]) << 16) | (static_cast<uint32_t>(in[2]) << 24)) >> 8;
+              out[i] = static_cast<float>(value) / 8388608.f;
+          }
+      } else {
+          for(std::size_t i = 0; i != count; ++i, in += 4) {
+              out[i] = static_cast<float>(static_cast<int32_t>(readU32(in))) / 2147483648.f;
+          }
+      }
+  }
 }
 
+class MappedBw64PCMReader::BlockPool : public std::enable_shared_from_this<BlockPool> {
+public:
+    BlockPool(std::size_t blockSize, std::size_t channelCount, std::size_t sampleRate, std::size_t bitDepth, bool isFloat) :
+        blockSize{blockSize}, channelCount{channelCount}, sampleRate{sampleRate}, bitDepth{bitDepth}, isFloat{isFloat} {}
+
+    // Returned to the pool, rather than deleted, when released
+    std::shared_ptr<PCMBlock> acquire() {
+        std::unique_ptr<PCMBlock> block;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!freeBlocks.empty()) {
+                block = std::move(freeBlocks.back());
+                freeBlocks.pop_back();
+            }
+        }
+        if(!block) {
+            block = std::make_unique<PCMBlock_>(blockSize, channelCount, sampleRate, bitDepth, isFloat);
+        }
+        return std::shared_ptr<PCMBlock>(block.release(), [pool = shared_from_this()](PCMBlock* released) {
+            pool->release(released);
+        });
+    }
+
+private:
+    void release(PCMBlock* block) {
+        std::lock_guard<std::mutex> lock(mutex);
+        freeBlocks.emplace_back(block);
+    }
+
+    std::size_t blockSize;
+    std::size_t channelCount;
+    std::size_t sampleRate;
+    std::size_t bitDepth;
+    bool isFloat;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<PCMBlock>> freeBlocks;
+};
+
 Bw64PCMReader::Bw64PCMReader(std::string fileName) : blockSize{DEFAULT_BLOCK_SIZE}
 {
     reader = bw64::readFile(fileName);
@@ -27,7 +130,8 @@ Bw64PCMReader::~Bw64PCMReader() = default;
 
 std::shared_ptr<IPCMBlock> Bw64PCMReader::read()
 {
-    auto block = std::make_shared<PCMBlock_>(blockSize, reader->channels(), reader->sampleRate());
+    // bw64::Bw64Reader only reads integer PCM
+    auto block = std::make_shared<PCMBlock_>(blockSize, reader->channels(), reader->sampleRate(), reader->bitDepth(), false);
     if(!reader->eof()) {
       block->frames = reader->read(&(block->blockData[0]), DEFAULT_BLOCK_SIZE);
     } else {
@@ -41,11 +145,126 @@ std::size_t admplug::Bw64PCMReader::totalFrames()
     return reader->numberOfFrames();
 }
 
+Bw64SampleFormat admplug::parseBw64SampleFormat(unsigned char const* begin, std::size_t size, std::string const& fileName)
+{
+    if(size < 12 || !(hasId(begin, "RIFF") || hasId(begin, "RF64") || hasId(begin, "BW64")) || !hasId(begin + 8, "WAVE")) {
+        throw std::runtime_error("Not a RIFF, RF64 or BW64 WAVE file: " + fileName);
+    }
+
+    Bw64SampleFormat format;
+    uint64_t ds64DataSize{0};
+    uint16_t formatTag{0};
+    std::size_t blockAlign{0};
+    bool foundData{false};
+    uint64_t dataSize{0};
+    std::size_t offset{12};
+    while(offset + 8 <= size && !(foundData && formatTag)) {
+        auto const header = begin + offset;
+        auto const body = offset + 8;
+        uint64_t chunkSize = readU32(header + 4);
+        if(hasId(header, "ds64") && chunkSize >= 24 && body + 24 <= size) {
+            ds64DataSize = readU64(begin + body + 8);
+        } else if(hasId(header, "fmt ") && chunkSize >= 16 && body + 16 <= size) {
+            formatTag = readU16(begin + body);
+            format.channels = readU16(begin + body + 2);
+            format.sampleRate = readU32(begin + body + 4);
+            blockAlign = readU16(begin + body + 12);
+            format.bitDepth = readU16(begin + body + 14);
+            if(formatTag == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 26 && body + 26 <= size) {
+                formatTag = readU16(begin + body + 24); // First two bytes of the SubFormat GUID
+            }
+        } else if(hasId(header, "data")) {
+            if(chunkSize == 0xFFFFFFFF) {
+                chunkSize = ds64DataSize;
+            }
+            foundData = true;
+            format.dataOffset = body;
+            dataSize = std::min<uint64_t>(chunkSize, size - body); // Allow for truncated files
+        }
+        offset = body + static_cast<std::size_t>(std::min<uint64_t>(chunkSize + (chunkSize & 1), size - body));
+    }
+
+    if(!foundData || !formatTag) {
+        throw std::runtime_error("Missing fmt or data chunk in " + fileName);
+    }
+    format.isFloat = formatTag == WAVE_FORMAT_IEEE_FLOAT;
+    auto const bits = format.bitDepth;
+    bool supported = (formatTag == WAVE_FORMAT_PCM && (bits == 8 || bits == 16 || bits == 24 || bits == 32)) ||
+                     (format.isFloat && (bits == 32 || bits == 64));
+    if(!supported || format.channels == 0 || blockAlign != format.frameBytes()) {
+        throw std::runtime_error("Unsupported sample format in " + fileName);
+    }
+    format.frames = static_cast<std::size_t>(dataSize / blockAlign);
+    return format;
+}
+
+void admplug::convertSelectedChannels(unsigned char const* frames, std::size_t frameCount, Bw64SampleFormat const& format,
+                                      std::vector<int> const& channels, float* out)
+{
+    auto const sampleBytes = format.bitDepth / 8;
+    auto const frameBytes = format.frameBytes();
+    auto const outputChannels = channels.size();
+    for(std::size_t output = 0; output != outputChannels; ++output) {
+        auto const channel = channels[output];
+        auto dest = out + output;
+        if(channel < 0 || static_cast<std::size_t>(channel) >= format.channels) {
+            for(std::size_t frame = 0; frame != frameCount; ++frame, dest += outputChannels) {
+                *dest = 0.f;
+            }
+            continue;
+        }
+        auto in = frames + static_cast<std::size_t>(channel) * sampleBytes;
+        for(std::size_t frame = 0; frame != frameCount; ++frame, in += frameBytes, dest += outputChannels) {
+            convertSamples(in, dest, 1, format.bitDepth, format.isFloat);
+        }
+    }
+}
+
+MappedBw64PCMReader::MappedBw64PCMReader(std::string fileName, std::size_t blockSize) : blockSize{blockSize}
+{
+    file = MappedFile::open(fileName);
+    if(!file) {
+        throw std::runtime_error("Could not map file " + fileName);
+    }
+    format = parseBw64SampleFormat(file->data(), file->size(), fileName);
+    samples = file->data() + format.dataOffset;
+    if(this->blockSize == 0) {
+        this->blockSize = std::clamp(TARGET_BLOCK_SAMPLES / format.channels, MIN_BLOCK_SIZE, MAX_BLOCK_SIZE);
+    }
+    pool = std::make_shared<BlockPool>(this->blockSize, format.channels, format.sampleRate, format.bitDepth, format.isFloat);
+}
+
+MappedBw64PCMReader::~MappedBw64PCMReader() = default;
+
+std::shared_ptr<IPCMBlock> MappedBw64PCMReader::read()
+{
+    auto block = pool->acquire();
+    auto blockFrames = std::min(blockSize, format.frames - position);
+    convertSamples(samples + position * format.frameBytes(), block->blockData.data(), blockFrames * format.channels, format.bitDepth, format.isFloat);
+    block->frames = blockFrames;
+    position += blockFrames;
+    return block;
+}
+
+std::size_t MappedBw64PCMReader::totalFrames()
+{
+    return format.frames;
+}
+
+std::size_t MappedBw64PCMReader::blockFrames() const
+{
+    return blockSize;
+}
+
 PCMBlock::PCMBlock(std::size_t blockSize,
                    std::size_t channelCount,
-                   std::size_t sampleRate) : blockData(blockSize * channelCount, 0),
-                                             channels{channelCount},
-                                             rate{sampleRate}
+                   std::size_t sampleRate,
+                   std::size_t bitDepth,
+                   bool isFloat) : blockData(blockSize * channelCount, 0),
+                                   channels{channelCount},
+                                   rate{sampleRate},
+                                   bits{bitDepth},
+                                   floatingPoint{isFloat}
 {}
 
 std::size_t PCMBlock::frameCount() const
@@ -63,17 +282,29 @@ std::size_t PCMBlock::sampleRate() const
     return rate;
 }
 
+std::size_t PCMBlock::bitDepth() const
+{
+    return bits;
+}
+
+bool PCMBlock::isFloat() const
+{
+    return floatingPoint;
+}
+
 const std::vector<float> &PCMBlock::data() const
 {
     return blockData;
 }
 
-PCMProcessBlock::PCMProcessBlock(std::vector<float> data,
+PCMProcessBlock::PCMProcessBlock(std::vector<float> const& data,
                                  IPCMBlock const& inputBlock,
                                  std::size_t channelCount) :  blockData{data},
                                                               frames{inputBlock.frameCount()},
                                                               channels{channelCount},
-                                                              rate{inputBlock.sampleRate()}
+                                                              rate{inputBlock.sampleRate()},
+                                                              bits{inputBlock.bitDepth()},
+                                                              floatingPoint{inputBlock.isFloat()}
 {  }
 
 std::size_t PCMProcessBlock::frameCount() const
@@ -91,6 +322,16 @@ std::size_t PCMProcessBlock::sampleRate() const
     return rate;
 }
 
+std::size_t PCMProcessBlock::bitDepth() const
+{
+    return bits;
+}
+
+bool PCMProcessBlock::isFloat() const
+{
+    return floatingPoint;
+}
+
 const std::vector<float> &PCMProcessBlock::data() const
 {
     return blockData;
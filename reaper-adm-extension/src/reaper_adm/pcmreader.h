@@ -1,8 +1,11 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <memory>
 #include <vector>
 
+class MappedFile;
+
 namespace bw64 {
   class Bw64Reader;
 }
@@ -30,11 +33,56 @@ private:
     std::size_t blockSize;
 };
 
+// Where, and in what format, a RIFF, RF64 or BW64 file holds its samples
+struct Bw64SampleFormat {
+    std::size_t channels{ 0 };
+    std::size_t sampleRate{ 0 };
+    std::size_t bitDepth{ 0 };
+    bool isFloat{ false };
+    uint64_t dataOffset{ 0 }; // From the start of the file
+    std::size_t frames{ 0 }; // Limited to those present, should the file be truncated
+    std::size_t frameBytes() const { return channels * (bitDepth / 8); }
+};
+
+// Parses the headers of the `size` byte file at `file`. Throws std::runtime_error if the samples can't be read.
+Bw64SampleFormat parseBw64SampleFormat(unsigned char const* file, std::size_t size, std::string const& fileName);
+
+// Converts `frameCount` frames of `format` to float, keeping only the channels listed, in the order listed.
+// Channels the file doesn't have (such as -1) are silent.
+void convertSelectedChannels(unsigned char const* frames, std::size_t frameCount, Bw64SampleFormat const& format,
+                             std::vector<int> const& channels, float* out);
+
+// Reads the data chunk through a memory mapping of the whole file, converting in to blocks which are
+// recycled once released, so reading doesn't allocate after the first few blocks.
+// Handles RIFF, RF64 and BW64 files of PCM (8 to 32 bit) or float (32 or 64 bit) samples.
+class MappedBw64PCMReader : public PCMReader
+{
+public:
+    // A blockSize of 0 sizes blocks from the channel count, so each holds a similar number of samples
+    explicit MappedBw64PCMReader(std::string fileName, std::size_t blockSize = 0);
+    ~MappedBw64PCMReader();
+    std::shared_ptr<IPCMBlock> read() override;
+    std::size_t totalFrames() override;
+    std::size_t blockFrames() const;
+private:
+    class BlockPool;
+    std::unique_ptr<MappedFile> file;
+    Bw64SampleFormat format;
+    unsigned char const* samples{ nullptr };
+    std::size_t position{ 0 };
+    std::size_t blockSize;
+    std::shared_ptr<BlockPool> pool;
+};
+
 class IPCMBlock {
 public:
     virtual std::size_t frameCount() const = 0;
     virtual std::size_t channelCount() const = 0;
     virtual std::size_t sampleRate() const = 0;
+    // Bit depth of the source samples, 0 if unknown
+    virtual std::size_t bitDepth() const = 0;
+    // True for IEEE float sources, whose samples may exceed full scale
+    virtual bool isFloat() const = 0;
     virtual std::vector<float> const& data() const = 0;
     virtual ~IPCMBlock() = default;
 protected:
@@ -49,35 +97,47 @@ public:
     std::size_t frameCount() const override;
     std::size_t channelCount() const override;
     std::size_t sampleRate() const override;
+    std::size_t bitDepth() const override;
+    bool isFloat() const override;
     std::vector<float> const& data() const override;
     friend class Bw64PCMReader;
+    friend class MappedBw64PCMReader;
 protected:
     explicit PCMBlock(std::size_t blockSize,
                       std::size_t channelCount,
-                      std::size_t sampleRate);
+                      std::size_t sampleRate,
+                      std::size_t bitDepth,
+                      bool isFloat);
 private:
     std::vector<float> blockData;
     std::size_t frames;
     std::size_t channels;
     std::size_t rate;
+    std::size_t bits;
+    bool floatingPoint;
 };
 
+// Refers to, rather than copies, its data, which must outlive the block
 class PCMProcessBlock : public IPCMBlock
 {
 public:
-    PCMProcessBlock(std::vector<float> data,
+    PCMProcessBlock(std::vector<float> const& data,
                     const IPCMBlock &inputBlock,
                     std::size_t channelCount);
     std::size_t frameCount() const override;
     std::size_t channelCount() const override;
     std::size_t sampleRate() const override;
+    std::size_t bitDepth() const override;
+    bool isFloat() const override;
     std::vector<float> const& data() const override;
     friend class Bw64PCMReader;
 private:
-    std::vector<float> blockData;
+    std::vector<float> const& blockData;
     std::size_t frames;
     std::size_t channels;
     std::size_t rate;
+    std::size_t bits;
+    bool floatingPoint;
 };
 
 }
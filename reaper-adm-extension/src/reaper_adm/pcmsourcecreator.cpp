@@ -6,8 +6,10 @@
 #include "pcmwriterfactory.h"
 #include "pcmwriter.h"
 #include "pcmreader.h"
+#include "pcmpipeline.h"
 #include "reaperapi.h"
 #include "mediatakeelement.h"
+#include "channelselectsource.h"
 
 using namespace admplug;
 
@@ -28,6 +30,12 @@ PCMSourceCreator::PCMSourceCreator(std::unique_ptr<IPCMGroupRegistry> registry,
     inputFileShort = (dotPos == noPath.npos ? noPath : noPath.substr(0, dotPos));
 }
 
+PCMSourceCreator::PCMSourceCreator(std::unique_ptr<IPCMGroupRegistry> registry,
+                                   IADMMetaData const& metadata) :
+    PCMSourceCreator(std::move(registry), nullptr, nullptr, metadata)
+{
+}
+
 PCMSourceCreator::~PCMSourceCreator() = default;
 
 void PCMSourceCreator::addTake(std::shared_ptr<TakeElement> take)
@@ -37,6 +45,13 @@ void PCMSourceCreator::addTake(std::shared_ptr<TakeElement> take)
 
 
 void PCMSourceCreator::linkSources(const ReaperAPI& api) {
+    if(!reader) {
+        for(auto group : registry->allGroups()) {
+            registry->setTakeSourceFor(*group, new ChannelSelectSource(api, inputFile, group->trackIndices()));
+        }
+        return;
+    }
+
     for(std::size_t i = 0; i != fileNames.size(); ++i) {
         auto fileName = fileNames[i];
         auto pcmSource = api.PCM_Source_CreateFromFile(fileName.c_str());
@@ -51,7 +66,9 @@ void PCMSourceCreator::extractSources(std::string outputDir, const ImportContext
         registry->add(take, PCMGroup{take->channelsOfOriginal()});
     }
 
-    fileNames = createSourceFiles(outputDir, *context.broadcast, *context.import);
+    if(reader) {
+        fileNames = createSourceFiles(outputDir, *context.broadcast, *context.import);
+    }
 }
 
 int admplug::PCMSourceCreator::channelForTrackUid(std::shared_ptr<const adm::AudioTrackUid> trackUid)
@@ -73,24 +90,15 @@ std::vector<std::string> PCMSourceCreator::createSourceFiles(std::string outputD
 
     std::size_t totalFrames = reader->totalFrames();
     broadcast.totalFrames(totalFrames);
-    std::size_t currentFrame{0};
-    std::size_t currentBlock{0};
-    auto readBlock = reader->read();
-    while(readBlock->frameCount() > 0) {
-        if(currentBlock % 20 == 0) {
-            broadcast.framesWritten(currentFrame);
-            if(import.status() == ImportStatus::CANCELLED) {
-                break;
-            }
-        }
 
-        for(auto& writer : writers) {
-            writer->write(*readBlock);
+    PCMPipeline pipeline(*reader, writers);
+    while(!pipeline.waitUntilFinished(std::chrono::milliseconds(100))) {
+        broadcast.framesWritten(pipeline.framesWritten());
+        if(import.status() == ImportStatus::CANCELLED) {
+            pipeline.cancel();
         }
-        currentFrame += readBlock->frameCount();
-        currentBlock++;
-        readBlock = reader->read();
     }
+    pipeline.finish();
     return fileNames;
 }
 
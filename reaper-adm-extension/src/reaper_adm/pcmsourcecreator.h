@@ -36,6 +36,9 @@ public:
                      std::unique_ptr<PCMReader> pcmReader,
                      std::unique_ptr<PCMWriterFactory> pcmWriterFactory,
                      IADMMetaData const& metaData);
+    // Links takes to the channels of the original file in place, rather than extracting stem files
+    PCMSourceCreator(std::unique_ptr<IPCMGroupRegistry> registry,
+                     IADMMetaData const& metaData);
     ~PCMSourceCreator() override;
     virtual void addTake(std::shared_ptr<TakeElement> take) override;
     void linkSources(ReaperAPI const&) override;
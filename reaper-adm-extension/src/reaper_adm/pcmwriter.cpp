@@ -1,6 +1,8 @@
 #include "pcmwriter.h"
 #include "pcmreader.h"
 #include "bw64/bw64.hpp"
+#include "sampleformat.h"
+#include "floatwriter.h"
 
 using namespace admplug;
 
@@ -13,11 +15,22 @@ PCMWriter::~PCMWriter() = default;
 
 void PCMWriter::write(const IPCMBlock &block)
 {
-    if(!writer) {
-        writer = bw64::writeFile(fileName().c_str(), block.channelCount(), block.sampleRate(), 24);
-        writer->useRf64Id(true); // REAPER currently doesn't recognise BW64 chunk ID when we pull on to track
+    if(!writer && !floatWriter) {
+        if(block.isFloat()) {
+            // Written as float, so samples above full scale aren't clipped
+            floatWriter = std::make_unique<FloatWriter>(fileName(), block.channelCount(), block.sampleRate());
+        } else {
+            // Keep the source bit depth, so stems aren't requantised
+            auto bits = isWritableBitDepth(block.bitDepth())? static_cast<uint16_t>(block.bitDepth()) : DEFAULT_BIT_DEPTH;
+            writer = bw64::writeFile(fileName().c_str(), block.channelCount(), block.sampleRate(), bits);
+            writer->useRf64Id(true); // REAPER currently doesn't recognise BW64 chunk ID when we pull on to track
+        }
+    }
+    if(floatWriter) {
+        floatWriter->write(block.data().data(), block.frameCount());
+    } else {
+        auto framesWritten = writer->write(&block.data()[0], block.frameCount());
     }
-    auto framesWritten = writer->write(&block.data()[0], block.frameCount());
 }
 
 std::string PCMWriter::fileName()
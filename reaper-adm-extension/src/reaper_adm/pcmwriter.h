@@ -9,6 +9,7 @@ namespace bw64 {
 namespace admplug {
 
 class IPCMBlock;
+class FloatWriter;
 
 class IPCMWriter {
 public:
@@ -27,6 +28,7 @@ public:
 private:
     std::string name;
     std::unique_ptr<bw64::Bw64Writer> writer;
+    std::unique_ptr<FloatWriter> floatWriter;
 };
 
 }
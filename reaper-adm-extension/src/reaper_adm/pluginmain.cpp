@@ -8,6 +8,7 @@
 #include "menu.h"
 #include "admmetadata.h"
 #include "importaction.h"
+#include "channelselectsource.h"
 #include "exportaction.h"
 #include "pluginsuite.h"
 #include "pluginregistry.h"
@@ -88,6 +89,7 @@ extern "C" {
     rec->Register("API_registerPluginLoad", reinterpret_cast<void*>(&registerPluginLoad));
 
     auto api = reaper->api();
+    ChannelSelectSource::registerType(api, rec);
 
 #ifndef __linux__
     // Linux requires libcurl even when using juce::URL
@@ -374,6 +376,43 @@ extern "C" {
         admInsertMenu->insert(std::move(explodeItem), std::make_shared<EndOffset>(0));
     }
 
+    // Takes play the original file's channels in place, rather than extracted stem files
+    for (auto& pluginSuite : *pluginRegistry->getPluginSuites()) {
+        std::string actionName("Import using ");
+        actionName += pluginSuite.first;
+        actionName += " (reference original file)";
+        std::string actionSID("ADM_IMPORT_REFERENCE_");
+        actionSID += std::to_string(actionCounter++);
+
+        auto explodeAction = std::make_shared<StatefulAction<ImportAction>> (
+            actionName.c_str(),
+            actionSID.c_str(),
+            std::make_unique<ImportAction>(hInstance, rec->hwnd_main, pluginSuite.second, ImportMode::REFERENCE_ORIGINAL),
+            [pluginSuite](ReaperAPI& api, ImportAction& importer) {
+
+            char filename[4096];
+            api.GetProjectPath(filename, 4096);
+            auto filenameStr = std::string(filename);
+            filenameStr += "/.wav";
+            memcpy(filename, filenameStr.data(), filenameStr.length() + 1);
+            if (api.GetUserFileNameForRead(filename, "ADM BW64 File to Import", "wav")) {
+                filenameStr = std::string(filename);
+                std::string errOut;
+                if(ImportAction::canMediaExplode_QuickCheck(api, filenameStr, &errOut)) {
+                    importer.import(filenameStr, api);
+                } else {
+                    std::string errMsg{ "Error: This file can not be imported.\n\nResponse: " };
+                    errMsg += errOut;
+                    api.ShowMessageBox(errMsg.c_str(), "ADM Import", 0);
+                }
+            }
+        });
+        explodeAction->setEnabled(pluginSuite.second->pluginSuiteUsable(*api));
+        auto explodeId = reaper->addAction(explodeAction);
+        auto explodeItem = std::make_unique<MenuAction>(actionName.c_str(), explodeId);
+        admInsertMenu->insert(std::move(explodeItem), std::make_shared<EndOffset>(0));
+    }
+
   auto reaperInsertMenu = reaperMainMenu->getMenuByText(
       "&Insert", "common", defaultMenuPositions.at("&Insert"), *api);
   assert(reaperInsertMenu);
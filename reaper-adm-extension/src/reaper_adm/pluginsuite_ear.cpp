@@ -256,11 +256,10 @@ EARPluginSuite::~EARPluginSuite() = default;
 
 void admplug::EARPluginSuite::onProjectBuildBegin(std::shared_ptr<IADMMetaData> metadata, const ReaperAPI&)
 {
-	// Store ADM document ready for transmitting to EAR Scene
+	// Keep ADM document ready for transmitting to EAR Scene - it's serialised once the project is built,
+	// by which point the blocks of every imported object have been loaded for its automation
 	assert(metadata);
-	std::stringstream xmlStream;
-	adm::writeXml(xmlStream, metadata->adm());
-	originalAdmDocument = xmlStream.str();
+	importMetadata = std::move(metadata);
 
     takesOnTracks.clear();
     pluginToAdmMaps.clear();
@@ -270,7 +269,11 @@ void admplug::EARPluginSuite::onProjectBuildBegin(std::shared_ptr<IADMMetaData>
 
 void admplug::EARPluginSuite::onProjectBuildComplete(const ReaperAPI & api)
 {
-	assert(originalAdmDocument.length() > 0);
+	assert(importMetadata);
+	std::stringstream xmlStream;
+	adm::writeXml(xmlStream, importMetadata->adm());
+	originalAdmDocument = xmlStream.str();
+	importMetadata.reset();
 	if (!sceneMasterAlreadyExisted) {
 		auto sceneMaster = EarSceneMasterVst(sceneMasterTrack->get(), api);
 		auto samplesPort = sceneMaster.getSamplesSocketPort();
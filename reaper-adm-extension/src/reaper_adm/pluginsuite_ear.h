@@ -110,6 +110,7 @@ private:
 
     std::vector<PluginToAdmMap> pluginToAdmMaps;
 
+	std::shared_ptr<IADMMetaData> importMetadata;
 	std::string originalAdmDocument;
 	bool sceneMasterAlreadyExisted{ false };
 
@@ -10,6 +10,7 @@
 #include "importaction.h"
 #include "pcmsourcecreator.h"
 #include "mediatakeelement.h"
+#include "elementcomparator.h"
 #include <helper/container_helpers.hpp>
 #include <helper/common_definition_helper.h>
 
@@ -181,6 +182,7 @@ ProjectTree::ProjectTree(std::unique_ptr<NodeFactory> nodeFactory,
     broadcast{ std::move(broadcast) }
 {
     resetRoot();
+    indexExistingNodes(rootNode);
 }
 
 void ProjectTree::resetRoot()
@@ -358,7 +360,8 @@ void admplug::ProjectTree::addTake(int specificAtuIndex)
 
     auto trackNode = state.currentNode;
     auto trackElement = std::dynamic_pointer_cast<TrackElement>(trackNode->getProjectElement());
-    if(!moveToCompatibleTakeNode(state.currentObject, channelsOfOriginal)) {
+    auto newTake = !moveToCompatibleTakeNode(state.currentObject, channelsOfOriginal);
+    if(newTake) {
         moveToNewTakeNode(state.currentObject);
     }
     auto takeElement = std::dynamic_pointer_cast<TakeElement>(state.currentNode->getProjectElement());
@@ -369,6 +372,9 @@ void admplug::ProjectTree::addTake(int specificAtuIndex)
     for(int i = takeElement->channelCount(); i < channelsOfOriginal.size(); i++) {
         takeElement->addChannelOfOriginal(channelsOfOriginal[i]);
     }
+    if(newTake) {
+        indexTakeNode(state.currentNode);
+    }
     state.currentNode = trackNode; // Reset pos as this is an add operation, not a move
 }
 
@@ -378,6 +384,7 @@ void ProjectTree::moveToNewObjectTrackNode(std::shared_ptr<const adm::AudioObjec
     auto trackNode = nodeFactory->createObjectTrackNode(representedAudioObject, representedAudioTrackUid, elements, parentTrack);
     broadcast->elementAdded();
     moveToNewChild(trackNode);
+    indexTrackNode(elements, trackNode);
 }
 
 void ProjectTree::moveToNewDirectTrackNode(std::shared_ptr<const adm::AudioObject> representedAudioObject, std::vector<adm::ElementConstVariant> elements)
@@ -386,6 +393,7 @@ void ProjectTree::moveToNewDirectTrackNode(std::shared_ptr<const adm::AudioObjec
     auto trackNode = nodeFactory->createDirectTrackNode(representedAudioObject, elements, parentTrack);
     broadcast->elementAdded();
     moveToNewChild(trackNode);
+    indexTrackNode(elements, trackNode);
 }
 
 void ProjectTree::moveToNewHoaTrackNode(std::shared_ptr<const adm::AudioObject> representedAudioObject, std::vector<adm::ElementConstVariant> elements)
@@ -393,6 +401,7 @@ void ProjectTree::moveToNewHoaTrackNode(std::shared_ptr<const adm::AudioObject>
     auto parentTrack = std::dynamic_pointer_cast<TrackElement>(state.currentNode->getProjectElement());
     auto trackNode = nodeFactory->createHoaTrackNode(representedAudioObject, elements, parentTrack);
     moveToNewChild(trackNode);
+    indexTrackNode(elements, trackNode);
 }
 
 void ProjectTree::moveToNewGroupNode(adm::ElementConstVariant element)
@@ -406,6 +415,7 @@ void ProjectTree::moveToNewGroupNode(std::vector<adm::ElementConstVariant> eleme
     assert(trackNode);
     broadcast->elementAdded();
     moveToNewChild(trackNode);
+    indexTrackNode(elements, trackNode);
 }
 
 void admplug::ProjectTree::addAutomation(int specificAtuAcfIndex)
@@ -433,44 +443,111 @@ std::shared_ptr<ProjectNode> ProjectTree::getChildWithElement(adm::ElementConstV
     return nullptr;
 }
 
-std::shared_ptr<ProjectNode> admplug::ProjectTree::getTrackNodeWithElements(std::vector<adm::ElementConstVariant> elements, std::shared_ptr<ProjectNode> startingNode)
+std::shared_ptr<ProjectNode> admplug::ProjectTree::getTrackNodeWithElements(std::vector<adm::ElementConstVariant> const& elements)
 {
-    if (!startingNode) {
-        startingNode = rootNode;
+    for (auto const& node : existingTrackNodes) {
+        if (nodeIsTrackWithElements(*node, elements)) {
+            return node;
+        }
     }
-    if (nodeIsTrackWithElements(*startingNode, elements)) {
-        return startingNode;
+    auto indexedNode = trackNodes.find(keyFor(elements));
+    if (indexedNode != trackNodes.end() && nodeIsTrackWithElements(*indexedNode->second, elements)) {
+        return indexedNode->second;
     }
-    auto children = startingNode->children();
-    for (auto child : children) {
-        if (std::dynamic_pointer_cast<TrackElement>(child->getProjectElement())) { // Only process child if track node (i.e, track/group)!
-            auto matchingNode = getTrackNodeWithElements(elements, child);
-            if (matchingNode) {
-                return matchingNode;
+    return nullptr;
+}
+
+std::shared_ptr<ProjectNode> admplug::ProjectTree::getCompatibleTakeNode(std::shared_ptr<const adm::AudioObject> object, std::vector<uint32_t> const& channelsOfOriginal)
+{
+    std::vector<std::shared_ptr<ProjectNode>> compatibleNodes;
+    auto addCompatible = [&](std::vector<std::shared_ptr<ProjectNode>> const& takeNodes) {
+        for (auto const& node : takeNodes) {
+            if (nodeIsTakeWithCompatibleElements(*node, channelsOfOriginal, object)) {
+                compatibleNodes.push_back(node);
             }
         }
+    };
+
+    addCompatible(takeNodesWithoutChannels);
+    if (channelsOfOriginal.empty()) {
+        // Only the channel counts in common are compared, so any take could match
+        for (auto const& takeNodes : takeNodesByFirstChannel) {
+            addCompatible(takeNodes.second);
+        }
+    } else {
+        auto takeNodes = takeNodesByFirstChannel.find(channelsOfOriginal.front());
+        if (takeNodes != takeNodesByFirstChannel.end()) {
+            addCompatible(takeNodes->second);
+        }
     }
-    return nullptr;
+
+    if (compatibleNodes.size() < 2) {
+        return compatibleNodes.empty() ? nullptr : compatibleNodes.front();
+    }
+    // The index doesn't keep tree order, so choose the take a search of the tree would find first
+    auto node = firstNodeInTree(compatibleNodes, rootNode);
+    return node ? node : compatibleNodes.front();
 }
 
-std::shared_ptr<ProjectNode> admplug::ProjectTree::getCompatibleTakeNode(std::shared_ptr<const adm::AudioObject> object, std::vector<uint32_t> const& channelsOfOriginal, std::shared_ptr<ProjectNode> startingNode)
+std::shared_ptr<ProjectNode> ProjectTree::firstNodeInTree(std::vector<std::shared_ptr<ProjectNode>> const& nodes, std::shared_ptr<ProjectNode> const& startingNode)
 {
-    if (!startingNode) {
-        startingNode = rootNode;
-    }
-    if (nodeIsTakeWithCompatibleElements(*startingNode, channelsOfOriginal, object)) {
+    if (contains(nodes, startingNode)) {
         return startingNode;
     }
-    auto children = startingNode->children();
-    for (auto child : children) {
-        auto matchingNode = getCompatibleTakeNode(object, channelsOfOriginal, child);
-        if (matchingNode) {
-            return matchingNode;
+    for (auto const& child : startingNode->children()) {
+        if (auto node = firstNodeInTree(nodes, child)) {
+            return node;
         }
     }
     return nullptr;
 }
 
+void ProjectTree::indexExistingNodes(std::shared_ptr<ProjectNode> const& node)
+{
+    auto element = node->getProjectElement();
+    if (std::dynamic_pointer_cast<MediaTakeElement>(element)) {
+        indexTakeNode(node);
+    }
+    auto isTrack = static_cast<bool>(std::dynamic_pointer_cast<TrackElement>(element));
+    if (isTrack && !contains(existingTrackNodes, node)) {
+        existingTrackNodes.push_back(node);
+    }
+    for (auto const& child : node->children()) {
+        indexExistingNodes(child);
+    }
+}
+
+void ProjectTree::indexTrackNode(std::vector<adm::ElementConstVariant> const& elements, std::shared_ptr<ProjectNode> const& node)
+{
+    if (node) {
+        trackNodes.emplace(keyFor(elements), node);
+    }
+}
+
+void ProjectTree::indexTakeNode(std::shared_ptr<ProjectNode> const& node)
+{
+    auto take = std::dynamic_pointer_cast<MediaTakeElement>(node->getProjectElement());
+    if (!take) return;
+    auto channels = take->channelsOfOriginal();
+    if (channels.empty()) {
+        takeNodesWithoutChannels.push_back(node);
+    } else {
+        takeNodesByFirstChannel[static_cast<uint32_t>(channels.front())].push_back(node);
+    }
+}
+
+ProjectTree::ElementKey ProjectTree::keyFor(std::vector<adm::ElementConstVariant> const& elements)
+{
+    ElementKey key;
+    key.reserve(elements.size());
+    ElementAddress elementAddress;
+    for (auto const& element : elements) {
+        key.push_back(boost::apply_visitor(elementAddress, element));
+    }
+    std::sort(key.begin(), key.end());
+    return key;
+}
+
 bool ProjectTree::moveToChildWithElement(adm::ElementConstVariant element) {
     auto existingChild = getChildWithElement(element);
     if(existingChild) {
@@ -1,5 +1,8 @@
 #pragma once
 #include <memory>
+#include <unordered_map>
+#include <vector>
+#include <boost/functional/hash.hpp>
 #include <boost/variant/static_visitor.hpp>
 #include <adm/element_variant.hpp>
 #include "pluginsuite.h"
@@ -70,14 +73,29 @@ private:
     bool moveToCompatibleTakeNode(std::shared_ptr<const adm::AudioObject> object, std::vector<uint32_t> const& channelsOfOriginal);
     void moveToNewChild(std::shared_ptr<ProjectNode> child);
     std::shared_ptr<ProjectNode> getChildWithElement(adm::ElementConstVariant element);
-    std::shared_ptr<ProjectNode> getTrackNodeWithElements(std::vector<adm::ElementConstVariant> elements, std::shared_ptr<ProjectNode> startingNode = nullptr);
-    std::shared_ptr<ProjectNode> getCompatibleTakeNode(std::shared_ptr<const adm::AudioObject> object, std::vector<uint32_t> const& channelsOfOriginal, std::shared_ptr<ProjectNode> startingNode = nullptr);
+    std::shared_ptr<ProjectNode> getTrackNodeWithElements(std::vector<adm::ElementConstVariant> const& elements);
+    std::shared_ptr<ProjectNode> getCompatibleTakeNode(std::shared_ptr<const adm::AudioObject> object, std::vector<uint32_t> const& channelsOfOriginal);
+    static std::shared_ptr<ProjectNode> firstNodeInTree(std::vector<std::shared_ptr<ProjectNode>> const& nodes, std::shared_ptr<ProjectNode> const& startingNode);
+    void indexExistingNodes(std::shared_ptr<ProjectNode> const& node);
+    void indexTrackNode(std::vector<adm::ElementConstVariant> const& elements, std::shared_ptr<ProjectNode> const& node);
+    void indexTakeNode(std::shared_ptr<ProjectNode> const& node);
+
+    // Element identities, in address order, so the same set of elements always gives the same key
+    using ElementKey = std::vector<void const*>;
+    static ElementKey keyFor(std::vector<adm::ElementConstVariant> const& elements);
 
     std::unique_ptr<NodeFactory> nodeFactory;
     std::shared_ptr<IPCMSourceCreator> sourceCreator;
     std::shared_ptr<ProjectNode> rootNode;
     std::shared_ptr<ImportListener> broadcast;
     TreeState state;
+
+    // Every track and take in the tree, so routes are matched to existing nodes without searching the tree.
+    // Tracks given with the root can't be keyed by their elements, so are still checked one by one.
+    std::unordered_map<ElementKey, std::shared_ptr<ProjectNode>, boost::hash<ElementKey>> trackNodes;
+    std::vector<std::shared_ptr<ProjectNode>> existingTrackNodes;
+    std::unordered_map<uint32_t, std::vector<std::shared_ptr<ProjectNode>>> takeNodesByFirstChannel;
+    std::vector<std::shared_ptr<ProjectNode>> takeNodesWithoutChannels;
 };
 
 }
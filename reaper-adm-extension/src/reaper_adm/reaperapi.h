@@ -19,12 +19,21 @@ class MediaItem;
 class MediaItem_Take;
 class ReaProject;
 class PCM_source;
+class ISimpleMediaDecoder;
 class TrackEnvelope;
 
 namespace admplug {
 
 class Track;
 
+// A point as stored on an envelope, i.e, in the envelope's scaling mode
+struct EnvelopePoint {
+    double time{ 0.0 };
+    double value{ 0.0 };
+    int shape{ EnvelopeShape::Linear };
+    double tension{ 0.0 };
+};
+
 class ReaperAPI {
    public:
        // From https://forum.cockos.com/showpost.php?p=2090533
@@ -96,6 +105,7 @@ class ReaperAPI {
     virtual double GetMediaSourceLength(PCM_source* source, bool* lengthIsQNOut) const = 0;
     virtual int GetMediaSourceNumChannels(PCM_source* source) const = 0;
     virtual PCM_source* PCM_Source_CreateFromFile(const char* filename) const = 0;
+    virtual PCM_source* PCM_Source_CreateFromSimple(ISimpleMediaDecoder* dec, const char* fn) const = 0;
     virtual int TrackFX_AddByName(MediaTrack* track, const char* fxname, bool recFX, int instantiate) const = 0;
     virtual bool TrackFX_Delete(MediaTrack* track, int fx ) const = 0;
     virtual int TrackFX_GetCount(MediaTrack* track) const = 0;
@@ -140,6 +150,7 @@ class ReaperAPI {
     virtual bool TrackFX_GetPreset(MediaTrack* track, int fx, char* presetname, int presetname_sz) const = 0;
     virtual int CountEnvelopePoints(TrackEnvelope* envelope) const = 0;
     virtual bool GetEnvelopePoint(TrackEnvelope* envelope, int ptidx, double* timeOutOptional, double* valueOutOptional, int* shapeOutOptional, double* tensionOutOptional, bool* selectedOutOptional) const = 0;
+    virtual int CountAutomationItems(TrackEnvelope* env) const = 0;
     virtual bool GetTrackUIVolPan(MediaTrack* track, double* volumeOut, double* panOut) const = 0;
     virtual int Envelope_Evaluate(TrackEnvelope* envelope, double time, double samplerate, int samplesRequested, double* valueOutOptional, double* dVdSOutOptional, double* ddVdSOutOptional, double* dddVdSOutOptional) const = 0;
     virtual bool GetEnvelopeStateChunk(TrackEnvelope* env, char* strNeedBig, int strNeedBig_sz, bool isundoOptional) const = 0;
@@ -192,6 +203,8 @@ class ReaperAPI {
     virtual void mapFxPin(MediaTrack* trk, int fxNum, int trackChannel, int fxChannel) const = 0;
     virtual bool forceAmplitudeScaling(TrackEnvelope * trackEnvelope) const = 0;
     virtual std::optional<std::pair<double, double>> getTrackAudioBounds(MediaTrack* trk, bool ignoreBeforeZero) const = 0;
+    virtual std::vector<EnvelopePoint> getEnvelopePoints(TrackEnvelope* envelope) const = 0; // In index order, which need not be time order
+    virtual bool insertEnvelopePoints(TrackEnvelope* envelope, std::vector<EnvelopePoint> const& points) const = 0; // One state chunk update - false if not applied, so insert individually instead
     virtual bool TrackFX_GetActualFXName(MediaTrack* track, int fx, std::string& name) const = 0;
     virtual std::vector<std::string> TrackFX_GetActualFXNames(MediaTrack* track) const = 0;
     virtual void CleanFXName(std::string& name) const = 0;
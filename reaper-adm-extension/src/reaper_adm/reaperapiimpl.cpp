@@ -1,10 +1,14 @@
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 #include <bitset>
 #include <string>
 #include <sstream>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <map>
+#include <optional>
 
 #include "reaperapiimpl.h"
 #include "reaperapivalues.h"
@@ -209,6 +213,11 @@ PCM_source *ReaperAPIImpl::PCM_Source_CreateFromFile(const char *filename) const
     return ::PCM_Source_CreateFromFile(filename);
 }
 
+PCM_source *ReaperAPIImpl::PCM_Source_CreateFromSimple(ISimpleMediaDecoder *dec, const char *fn) const
+{
+    return ::PCM_Source_CreateFromSimple(dec, fn);
+}
+
 int ReaperAPIImpl::TrackFX_AddByName(MediaTrack *track, const char *fxname, bool recFX, int instantiate) const
 {
     return ::TrackFX_AddByName(track, fxname, recFX, instantiate);
@@ -421,6 +430,11 @@ bool admplug::ReaperAPIImpl::GetEnvelopePoint(TrackEnvelope * envelope, int ptid
     return ::GetEnvelopePoint(envelope, ptidx, timeOutOptional, valueOutOptional, shapeOutOptional, tensionOutOptional, selectedOutOptional);
 }
 
+int admplug::ReaperAPIImpl::CountAutomationItems(TrackEnvelope * env) const
+{
+    return ::CountAutomationItems(env);
+}
+
 bool admplug::ReaperAPIImpl::GetTrackUIVolPan(MediaTrack * track, double * volumeOut, double * panOut) const
 {
     return ::GetTrackUIVolPan(track, volumeOut, panOut);
@@ -505,14 +519,14 @@ const char* admplug::ReaperAPIImpl::LocalizeString(const char* src_string, const
     return ::LocalizeString(src_string, section, flagsOptional);
 }
 
-bool admplug::ReaperAPIImpl::GetTrackStateChunk(MediaTrack* track, char* strNeedBig, int strNeedBig_sz, bool isundoOptional) const
-{
-    return ::GetTrackStateChunk(track, strNeedBig, strNeedBig_sz, isundoOptional);
+bool admplug::ReaperAPIImpl::GetTrackStateChunk(MediaTrack* track, char* strNeedBig, int strNeedBig_sz, bool isundoOptional) const
+{
+    return ::GetTrackStateChunk(track, strNeedBig, strNeedBig_sz, isundoOptional);
 }
 
-bool admplug::ReaperAPIImpl::SetTrackStateChunk(MediaTrack* track, const char* str, bool isundoOptional) const
-{
-    return ::SetTrackStateChunk(track, str, isundoOptional);
+bool admplug::ReaperAPIImpl::SetTrackStateChunk(MediaTrack* track, const char* str, bool isundoOptional) const
+{
+    return ::SetTrackStateChunk(track, str, isundoOptional);
 }
 
 void ReaperAPIImpl::UpdateArrangeForAutomation() const {
@@ -820,6 +834,120 @@ bool admplug::ReaperAPIImpl::forceAmplitudeScaling(TrackEnvelope * trackEnvelope
     return SetEnvelopeStateChunk(trackEnvelope, opChunk.c_str(), false);
 }
 
+std::vector<EnvelopePoint> admplug::ReaperAPIImpl::getEnvelopePoints(TrackEnvelope * envelope) const
+{
+    std::vector<EnvelopePoint> points;
+    int pointCount = CountEnvelopePoints(envelope);
+    if(pointCount <= 0) return points;
+    points.reserve(pointCount);
+    for(int pointIndex = 0; pointIndex < pointCount; pointIndex++) {
+        EnvelopePoint point;
+        if(GetEnvelopePoint(envelope, pointIndex, &point.time, &point.value, &point.shape, &point.tension, nullptr)) {
+            points.push_back(point);
+        }
+    }
+    return points;
+}
+
+bool admplug::ReaperAPIImpl::insertEnvelopePoints(TrackEnvelope * envelope, std::vector<EnvelopePoint> const& points) const
+{
+    if(points.empty()) return true;
+
+    // Chunk size isn't known up front, so grow the buffer until the whole chunk fits
+    const std::size_t chunkMaxLen = 1 << 26;
+    std::vector<char> chunk(4096);
+    while(true) {
+        if(!GetEnvelopeStateChunk(envelope, chunk.data(), static_cast<int>(chunk.size()), false)) return false;
+        if(strnlen(chunk.data(), chunk.size()) < chunk.size() - 1) break;
+        if(chunk.size() >= chunkMaxLen) return false;
+        chunk.resize(chunk.size() * 2);
+    }
+
+    std::string updatedChunk;
+    if(!insertPointsInEnvelopeChunk(chunk.data(), points, updatedChunk)) return false;
+    return SetEnvelopeStateChunk(envelope, updatedChunk.c_str(), false);
+}
+
+bool admplug::ReaperAPIImpl::insertPointsInEnvelopeChunk(std::string const& chunk, std::vector<EnvelopePoint> const& points, std::string& updatedChunk)
+{
+    struct PointLine {
+        double time;
+        std::string const* existingLine; // nullptr for a new point
+        EnvelopePoint const* newPoint;
+    };
+
+    for(auto const& point : points) {
+        // PT lines for tensioned points have fields we don't otherwise write
+        if(point.tension != 0.0) return false;
+    }
+
+    std::istringstream chunkSs(chunk);
+    std::string line;
+    std::vector<std::string> otherLines; // Kept in order, with all the points written where the first existing one was
+    std::vector<std::string> existingLines;
+    std::vector<double> existingTimes;
+    std::optional<std::size_t> pointsPosition;
+    int depth = 0; // Nested blocks (e.g, extension data) may have lines of their own which look like points
+    bool chunkComplete = false;
+
+    while(!chunkComplete && std::getline(chunkSs, line)) {
+        auto contentStart = std::min(line.find_first_not_of(" \t"), line.size());
+        auto content = line.c_str() + contentStart;
+        if(depth == 1 && line.compare(contentStart, 3, "PT ") == 0) {
+            if(!pointsPosition) pointsPosition = otherLines.size();
+            existingTimes.push_back(std::strtod(content + 3, nullptr));
+            existingLines.push_back(line);
+            continue;
+        }
+        if(*content == '<') {
+            ++depth;
+        } else if(*content == '>') {
+            // REAPER writes points last, so with none already there they go at the end
+            if(depth == 1 && !pointsPosition) pointsPosition = otherLines.size();
+            chunkComplete = --depth == 0;
+        }
+        otherLines.push_back(line);
+    }
+    if(!chunkComplete) return false;
+    while(std::getline(chunkSs, line)) {
+        otherLines.push_back(line);
+    }
+
+    std::vector<PointLine> pointLines;
+    pointLines.reserve(existingLines.size() + points.size());
+    for(std::size_t i = 0; i != existingLines.size(); ++i) {
+        pointLines.push_back({ existingTimes[i], &existingLines[i], nullptr });
+    }
+    for(auto const& point : points) {
+        pointLines.push_back({ point.time, nullptr, &point });
+    }
+    // Stable, so existing points stay ahead of new ones at the same time, as with individual inserts
+    std::stable_sort(pointLines.begin(), pointLines.end(), [](PointLine const& lhs, PointLine const& rhs) {
+        return lhs.time < rhs.time;
+    });
+
+    updatedChunk.clear();
+    updatedChunk.reserve(chunk.size() + points.size() * 48);
+    char pointLine[128];
+    for(std::size_t i = 0; i != otherLines.size(); ++i) {
+        if(i == *pointsPosition) {
+            for(auto const& entry : pointLines) {
+                if(entry.existingLine) {
+                    updatedChunk.append(*entry.existingLine);
+                } else {
+                    auto len = std::snprintf(pointLine, sizeof(pointLine), "PT %.12f %.12g %d", entry.newPoint->time, entry.newPoint->value, entry.newPoint->shape);
+                    if(len < 0 || len >= static_cast<int>(sizeof(pointLine))) return false;
+                    updatedChunk.append(pointLine, static_cast<std::size_t>(len));
+                }
+                updatedChunk.append("\n");
+            }
+        }
+        updatedChunk.append(otherLines[i]);
+        updatedChunk.append("\n");
+    }
+    return true;
+}
+
 std::optional<std::pair<double, double>> admplug::ReaperAPIImpl::getTrackAudioBounds(MediaTrack * trk, bool ignoreBeforeZero) const
 {
     std::optional<double> start;
@@ -849,8 +977,8 @@ std::optional<std::pair<double, double>> admplug::ReaperAPIImpl::getTrackAudioBo
     return std::optional<std::pair<double, double>>();
 }
 
-std::vector<std::pair<int, std::string>> admplug::ReaperAPIImpl::GetVSTElementsFromTrackStateChunk(const std::string& fullChunk) const
-{
+std::vector<std::pair<int, std::string>> admplug::ReaperAPIImpl::GetVSTElementsFromTrackStateChunk(const std::string& fullChunk) const
+{
     std::vector<std::pair<int, std::string>> vst3Elements;
 
     const std::vector<char> quoteMarks{ '\'', '`', '"' };
@@ -897,13 +1025,13 @@ std::vector<std::pair<int, std::string>> admplug::ReaperAPIImpl::GetVSTElementsF
                 elmStart = -1;
             }
         }
-    }
-
-    return vst3Elements;
+    }
+
+    return vst3Elements;
 }
 
-std::vector<std::string> admplug::ReaperAPIImpl::SplitVSTElement(const std::string& elm, bool stripBoundingQuotes, bool includeSeperators) const
-{
+std::vector<std::string> admplug::ReaperAPIImpl::SplitVSTElement(const std::string& elm, bool stripBoundingQuotes, bool includeSeperators) const
+{
     std::vector<std::string> sec;
 
     const std::vector<char> quoteMarks{ '\'', '`', '"' };
@@ -961,121 +1089,121 @@ std::vector<std::string> admplug::ReaperAPIImpl::SplitVSTElement(const std::stri
         }
     }
 
-    return sec;
+    return sec;
 }
 
-std::string admplug::ReaperAPIImpl::GetTrackStateChunkStr(MediaTrack* track) const
-{
-    const size_t chunkMaxLen = 65535; // Should be plenty
+std::string admplug::ReaperAPIImpl::GetTrackStateChunkStr(MediaTrack* track) const
+{
+    const size_t chunkMaxLen = 65535; // Should be plenty
     char chunk[chunkMaxLen];
-    auto res = GetTrackStateChunk(track, chunk, chunkMaxLen, false);
-    if (!res) return std::string();
-    std::string fullChunk{ chunk, strnlen(chunk, chunkMaxLen) };
-    return fullChunk;
-}
-
-bool admplug::ReaperAPIImpl::TrackFX_GetActualFXName(MediaTrack* track, int fx, std::string& name) const
-{
-    // Note that;
-    // TrackFX_GetNamedConfigParm( track, 0, "fx_name" )
-    // can get the pre-aliased name but is only supported from v6.37
-    // Also does not support FX renamed in FX selection window
-    // (although neither does this)
-
-    auto chunk = GetTrackStateChunkStr(track);
-
-    auto vst3Elements = GetVSTElementsFromTrackStateChunk(chunk);
-    if (fx >= vst3Elements.size()) {
-        return false;
-    }
-
-    const int nameSectionNum = 0;
-
-    auto vst3Sections = SplitVSTElement(vst3Elements[fx].second, true, false);
-    if (vst3Sections.size() <= nameSectionNum) {
-        return false;
-    }
-
-    name = vst3Sections[nameSectionNum];;
-    return true;
-}
-
-std::vector<std::string> admplug::ReaperAPIImpl::TrackFX_GetActualFXNames(MediaTrack* track) const
-{
-    // Only gets and parses state chunk once
-    // More efficient when you want to query every plugin on the track
-
-    std::vector<std::string> names;
-
-    auto chunk = GetTrackStateChunkStr(track);
-
-    auto vst3Elements = GetVSTElementsFromTrackStateChunk(chunk);
-
-    const int nameSectionNum = 0;
-
-    for (auto const& elmPair : vst3Elements) {
-        auto vst3Sections = SplitVSTElement(elmPair.second, true, false);
-        if (vst3Sections.size() <= nameSectionNum) {
-            names.push_back("");
-        }
-        else {
-            names.push_back(vst3Sections[nameSectionNum]);
-        }
-    }
-
-    return names;
-}
-
-void admplug::ReaperAPIImpl::CleanFXName(std::string& fxName) const
-{
-    // Purposely not removing other prefixes as we're only using this for our plug-ins which are all VST3
-    if (fxName.substr(0, 6) == "VST3: ") {
-        fxName = fxName.substr(6);
-    }
-
-    // Can be up to 2 bracketed sections - channel count and developer
-    for (int i = 0; i < 2; ++i) {
-        if (fxName[fxName.length() - 1] == ')') {
-            auto obPos = fxName.rfind(" (");
-            if (obPos == std::string::npos) {
-                break;
-            }
-            else {
-                fxName = fxName.substr(0, obPos);
-            }
-        }
-    }
-}
-
-int admplug::ReaperAPIImpl::TrackFX_PositionByActualName(MediaTrack* track, const std::string& fxName) const
-{
-    auto fxs = TrackFX_GetActualFXNames(track);
-    for (int i = 0; i < fxs.size(); ++i) {
-        if (fxs[i] == fxName) {
-            return i;
-        }
-        CleanFXName(fxs[i]);
-        if (fxs[i] == fxName) {
-            return i;
-        }
-    }
-    return -1;
-}
-
-int admplug::ReaperAPIImpl::TrackFX_AddByActualName(MediaTrack* track, const char* fxname, bool recFX, int instantiate) const
-{
-    // TrackFX_AddByName will not find matches if the plugins are renamed on the tracks - do our own search by actual name
-    if (instantiate == TrackFXAddMode::QueryPresence) {
-        return TrackFX_PositionByActualName(track, fxname);
-    }
-    if (instantiate == TrackFXAddMode::CreateIfMissing) {
-        auto existingIndex = TrackFX_PositionByActualName(track, fxname);
-        if (existingIndex >= 0) {
-            return existingIndex;
-        }
-    }
-
-    // TrackFX_AddByName will not be able to add if the name of the plugin was changed in the FX selection window, but we can only try.
-    return TrackFX_AddByName(track, fxname, recFX, TrackFXAddMode::CreateNew);
+    auto res = GetTrackStateChunk(track, chunk, chunkMaxLen, false);
+    if (!res) return std::string();
+    std::string fullChunk{ chunk, strnlen(chunk, chunkMaxLen) };
+    return fullChunk;
+}
+
+bool admplug::ReaperAPIImpl::TrackFX_GetActualFXName(MediaTrack* track, int fx, std::string& name) const
+{
+    // Note that;
+    // TrackFX_GetNamedConfigParm( track, 0, "fx_name" )
+    // can get the pre-aliased name but is only supported from v6.37
+    // Also does not support FX renamed in FX selection window
+    // (although neither does this)
+
+    auto chunk = GetTrackStateChunkStr(track);
+
+    auto vst3Elements = GetVSTElementsFromTrackStateChunk(chunk);
+    if (fx >= vst3Elements.size()) {
+        return false;
+    }
+
+    const int nameSectionNum = 0;
+
+    auto vst3Sections = SplitVSTElement(vst3Elements[fx].second, true, false);
+    if (vst3Sections.size() <= nameSectionNum) {
+        return false;
+    }
+
+    name = vst3Sections[nameSectionNum];;
+    return true;
+}
+
+std::vector<std::string> admplug::ReaperAPIImpl::TrackFX_GetActualFXNames(MediaTrack* track) const
+{
+    // Only gets and parses state chunk once
+    // More efficient when you want to query every plugin on the track
+
+    std::vector<std::string> names;
+
+    auto chunk = GetTrackStateChunkStr(track);
+
+    auto vst3Elements = GetVSTElementsFromTrackStateChunk(chunk);
+
+    const int nameSectionNum = 0;
+
+    for (auto const& elmPair : vst3Elements) {
+        auto vst3Sections = SplitVSTElement(elmPair.second, true, false);
+        if (vst3Sections.size() <= nameSectionNum) {
+            names.push_back("");
+        }
+        else {
+            names.push_back(vst3Sections[nameSectionNum]);
+        }
+    }
+
+    return names;
+}
+
+void admplug::ReaperAPIImpl::CleanFXName(std::string& fxName) const
+{
+    // Purposely not removing other prefixes as we're only using this for our plug-ins which are all VST3
+    if (fxName.substr(0, 6) == "VST3: ") {
+        fxName = fxName.substr(6);
+    }
+
+    // Can be up to 2 bracketed sections - channel count and developer
+    for (int i = 0; i < 2; ++i) {
+        if (fxName[fxName.length() - 1] == ')') {
+            auto obPos = fxName.rfind(" (");
+            if (obPos == std::string::npos) {
+                break;
+            }
+            else {
+                fxName = fxName.substr(0, obPos);
+            }
+        }
+    }
+}
+
+int admplug::ReaperAPIImpl::TrackFX_PositionByActualName(MediaTrack* track, const std::string& fxName) const
+{
+    auto fxs = TrackFX_GetActualFXNames(track);
+    for (int i = 0; i < fxs.size(); ++i) {
+        if (fxs[i] == fxName) {
+            return i;
+        }
+        CleanFXName(fxs[i]);
+        if (fxs[i] == fxName) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int admplug::ReaperAPIImpl::TrackFX_AddByActualName(MediaTrack* track, const char* fxname, bool recFX, int instantiate) const
+{
+    // TrackFX_AddByName will not find matches if the plugins are renamed on the tracks - do our own search by actual name
+    if (instantiate == TrackFXAddMode::QueryPresence) {
+        return TrackFX_PositionByActualName(track, fxname);
+    }
+    if (instantiate == TrackFXAddMode::CreateIfMissing) {
+        auto existingIndex = TrackFX_PositionByActualName(track, fxname);
+        if (existingIndex >= 0) {
+            return existingIndex;
+        }
+    }
+
+    // TrackFX_AddByName will not be able to add if the name of the plugin was changed in the FX selection window, but we can only try.
+    return TrackFX_AddByName(track, fxname, recFX, TrackFXAddMode::CreateNew);
 }
 
@@ -52,6 +52,7 @@ public:
     double GetMediaSourceLength(PCM_source* source, bool* lengthIsQNOut) const override;
     int GetMediaSourceNumChannels(PCM_source* source) const override;
     PCM_source* PCM_Source_CreateFromFile(const char* filename) const override;
+    PCM_source* PCM_Source_CreateFromSimple(ISimpleMediaDecoder* dec, const char* fn) const override;
     int TrackFX_AddByName(MediaTrack* track, const char* fxname, bool recFX, int instantiate) const override;
     bool TrackFX_Delete(MediaTrack* track, int fx ) const override;
     int TrackFX_GetCount(MediaTrack* track) const override;
@@ -96,6 +97,7 @@ public:
     bool TrackFX_GetPreset(MediaTrack* track, int fx, char* presetname, int presetname_sz) const override;
     int CountEnvelopePoints(TrackEnvelope* envelope) const override;
     bool GetEnvelopePoint(TrackEnvelope* envelope, int ptidx, double* timeOutOptional, double* valueOutOptional, int* shapeOutOptional, double* tensionOutOptional, bool* selectedOutOptional) const override;
+    int CountAutomationItems(TrackEnvelope* env) const override;
     bool GetTrackUIVolPan(MediaTrack* track, double* volumeOut, double* panOut) const override;
     int Envelope_Evaluate(TrackEnvelope* envelope, double time, double samplerate, int samplesRequested, double* valueOutOptional, double* dVdSOutOptional, double* ddVdSOutOptional, double* dddVdSOutOptional) const override;
     bool GetEnvelopeStateChunk(TrackEnvelope* env, char* strNeedBig, int strNeedBig_sz, bool isundoOptional) const override;
@@ -142,6 +144,8 @@ public:
     void mapFxPin(MediaTrack* trk, int fxNum, int trackChannel, int fxChannel) const override;
     bool forceAmplitudeScaling(TrackEnvelope * trackEnvelope) const override;
     std::optional<std::pair<double, double>> getTrackAudioBounds(MediaTrack* trk, bool ignoreBeforeZero) const override;
+    std::vector<EnvelopePoint> getEnvelopePoints(TrackEnvelope* envelope) const override;
+    bool insertEnvelopePoints(TrackEnvelope* envelope, std::vector<EnvelopePoint> const& points) const override;
     bool TrackFX_GetActualFXName(MediaTrack* track, int fx, std::string& name) const override;
     std::vector<std::string> TrackFX_GetActualFXNames(MediaTrack* track) const override;
     void CleanFXName(std::string& name) const override;
@@ -151,6 +155,10 @@ public:
     std::vector<std::string> SplitVSTElement(const std::string& elm, bool stripBoundingQuotes, bool includeSeperators) const override;
     std::string GetTrackStateChunkStr(MediaTrack* track) const override;
 
+    // Adds PT lines for points to an envelope state chunk, keeping all points in time order
+    // False if the chunk is incomplete or a point can't be written as a PT line
+    static bool insertPointsInEnvelopeChunk(std::string const& chunk, std::vector<EnvelopePoint> const& points, std::string& updatedChunk);
+
 private:
     reaper_plugin_info_t& plugin_info;
 
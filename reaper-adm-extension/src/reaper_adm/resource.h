@@ -9,6 +9,8 @@
 #define IDD_EXPORT                      102
 #define IDC_INFOPANE                    1001
 #define IDC_BUTTON_REFRESH              1002
+#define IDC_SAMPLEFORMAT                1004
+#define IDC_SAMPLEFORMAT_LABEL          1005
 
 // Next default values for new objects
 // 
@@ -16,7 +18,7 @@
 #ifndef APSTUDIO_READONLY_SYMBOLS
 #define _APS_NEXT_RESOURCE_VALUE        102
 #define _APS_NEXT_COMMAND_VALUE         40001
-#define _APS_NEXT_CONTROL_VALUE         1004
+#define _APS_NEXT_CONTROL_VALUE         1006
 #define _APS_NEXT_SYMED_VALUE           101
 #endif
 #endif
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace admplug {
+
+// Values are persisted in the render config, so must not be renumbered.
+// 0 is what configs written before the format was selectable contain.
+// Integer PCM is written by bw64::Bw64Writer, and float by FloatWriter, as libbw64 has no float format.
+enum class SampleFormat : int32_t {
+    PCM24 = 0,
+    PCM16 = 1,
+    PCM32 = 2,
+    FLOAT32 = 3
+};
+
+constexpr uint16_t DEFAULT_BIT_DEPTH{ 24 };
+
+inline uint16_t bitDepth(SampleFormat format) {
+    switch(format) {
+        case SampleFormat::PCM16: return 16;
+        case SampleFormat::PCM32: return 32;
+        case SampleFormat::FLOAT32: return 32;
+        default: return DEFAULT_BIT_DEPTH;
+    }
+}
+
+inline const char* sampleFormatName(SampleFormat format) {
+    switch(format) {
+        case SampleFormat::PCM16: return "16 bit PCM";
+        case SampleFormat::PCM32: return "32 bit PCM";
+        case SampleFormat::FLOAT32: return "32 bit float";
+        default: return "24 bit PCM";
+    }
+}
+
+inline bool isFloat(SampleFormat format) {
+    return format == SampleFormat::FLOAT32;
+}
+
+// Unknown values (e.g, from a newer version) fall back to the default
+inline SampleFormat toSampleFormat(int32_t value) {
+    switch(value) {
+        case static_cast<int32_t>(SampleFormat::PCM16): return SampleFormat::PCM16;
+        case static_cast<int32_t>(SampleFormat::PCM32): return SampleFormat::PCM32;
+        case static_cast<int32_t>(SampleFormat::FLOAT32): return SampleFormat::FLOAT32;
+        default: return SampleFormat::PCM24;
+    }
+}
+
+// Integer bit depths which can be written - others are written at DEFAULT_BIT_DEPTH.
+// Float sources are written as float by PCMWriter, so aren't clipped.
+inline bool isWritableBitDepth(std::size_t bits) {
+    return bits == 16 || bits == 24 || bits == 32;
+}
+
+}
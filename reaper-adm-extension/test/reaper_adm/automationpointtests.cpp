@@ -80,7 +80,52 @@ static std::vector<TestData> const testData {
 TEST_CASE("Test automation simplification") {
     for(auto const& test : testData) {
         auto [input, expected] = test.getTestPoints();
-        REQUIRE(detail::simplify(input) == expected);
+        detail::simplify(input);
+        REQUIRE(input == expected);
+    }
+}
+
+TEST_CASE("Test automation simplification of points in line with their neighbours") {
+    static std::vector<TestData> const collinearData {
+        {{0.1f, 0.2f, 0.3f, 0.4f},          {0,3},       "ramp"},
+        {{0.1f, 0.2f, 0.3f, 0.3f},          {0,2},       "ramp then hold"},
+        {{0.1f, 0.2f, 0.3f, 0.2f, 0.1f},    {0,2,4},     "keep peak of ramps"},
+        {{0.5f, 0.5f, 0.6f, 0.7f, 0.7f},    {0,1,3},     "keep corners of hold then ramp"}
+    };
+    for(auto const& test : collinearData) {
+        auto [input, expected] = test.getTestPoints();
+        detail::simplify(input);
+        REQUIRE(input == expected);
+    }
+}
+
+TEST_CASE("Test automation simplification tolerance") {
+    auto [input, expected] = TestData{{0.1f, 0.2f, 0.31f, 0.4f}, {0,3}, "off line"}.getTestPoints();
+    SECTION("Points further than tolerance from the line are kept") {
+        detail::simplify(input);
+        REQUIRE(input.size() == 4);
+    }
+    SECTION("Points within tolerance of the line are dropped") {
+        detail::simplify(input, false, 0.02);
+        REQUIRE(input == expected);
+    }
+}
+
+TEST_CASE("Test automation simplification of wrapping parameters") {
+    SECTION("In line points are kept where dropping them would make the path wrap") {
+        auto [input, expected] = TestData{{0.1f, 0.3f, 0.5f, 0.7f, 0.9f}, {0,2,4}, "long ramp"}.getTestPoints();
+        detail::simplify(input, true);
+        REQUIRE(input == expected);
+    }
+    SECTION("In line points either side of a wrap are kept") {
+        auto [input, expected] = TestData{{0.8f, 0.9f, 0.1f, 0.2f}, {0,1,2,3}, "wrapped ramp"}.getTestPoints();
+        detail::simplify(input, true);
+        REQUIRE(input == expected);
+    }
+    SECTION("Points are dropped as normal when nothing wraps") {
+        auto [input, expected] = TestData{{0.4f, 0.45f, 0.5f, 0.55f, 0.6f}, {0,4}, "short ramp"}.getTestPoints();
+        detail::simplify(input, true);
+        REQUIRE(input == expected);
     }
 }
 
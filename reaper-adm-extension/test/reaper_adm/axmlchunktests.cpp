@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <sstream>
+#include <catch2/catch_all.hpp>
+#include <bw64/bw64.hpp>
+#include <adm/adm.hpp>
+#include <adm/common_definitions.hpp>
+#include <adm/write.hpp>
+#include "tempdir.h"
+
+#include "exportaction_axmlchunk.h"
+
+using namespace admplug;
+
+namespace {
+// Keeps nothing, recording only how much arrives at once
+class WriteSizeRecorder : public std::streambuf
+{
+public:
+    std::streamsize total{ 0 };
+    std::streamsize largestWrite{ 0 };
+
+protected:
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        total += n;
+        largestWrite = std::max(largestWrite, n);
+        return n;
+    }
+    int_type overflow(int_type ch) override {
+        return xsputn(nullptr, 1) ? traits_type::not_eof(ch) : traits_type::eof();
+    }
+};
+
+std::shared_ptr<adm::Document> testDocument() {
+    auto document = adm::Document::create();
+    adm::addCommonDefinitionsTo(document);
+    auto programme = adm::AudioProgramme::create(adm::AudioProgrammeName("Programme"));
+    auto content = adm::AudioContent::create(adm::AudioContentName("Content"));
+    auto object = adm::AudioObject::create(adm::AudioObjectName("Object"));
+    document->add(programme);
+    programme->addReference(content);
+    content->addReference(object);
+    return document;
+}
+}
+
+TEST_CASE("StreamingAxmlChunk") {
+    auto document = testDocument();
+    const std::string trailer{ "<!-- trailer -->\n" };
+    std::stringstream expected;
+    adm::writeXml(expected, document);
+    expected << trailer;
+
+    SECTION("Writes the serialised document and trailer, matching its size") {
+        StreamingAxmlChunk chunk(document, trailer);
+        std::stringstream written;
+        chunk.write(written);
+        REQUIRE(written.str() == expected.str());
+        REQUIRE(chunk.size() == expected.str().size());
+        REQUIRE(chunk.id() == bw64::utils::fourCC("axml"));
+    }
+
+    SECTION("Sizes and writes long content") {
+        const std::string longTrailer = "<!-- " + std::string(3 * 1024 * 1024, '-') + " -->\n";
+        std::stringstream longExpected;
+        adm::writeXml(longExpected, document);
+        longExpected << longTrailer;
+
+        StreamingAxmlChunk chunk(document, longTrailer);
+        REQUIRE(chunk.size() == longExpected.str().size());
+        std::stringstream written;
+        chunk.write(written);
+        REQUIRE(written.str() == longExpected.str());
+    }
+
+    SECTION("Streams the document as it is serialised rather than from a buffered copy") {
+        auto largeDocument = testDocument();
+        for (int i = 0; i != 200; ++i) {
+            largeDocument->add(adm::AudioObject::create(adm::AudioObjectName("Object " + std::to_string(i))));
+        }
+        StreamingAxmlChunk chunk(largeDocument, trailer);
+        auto size = chunk.size();
+        WriteSizeRecorder recorder;
+        std::ostream stream(&recorder);
+        chunk.write(stream);
+        REQUIRE(static_cast<uint64_t>(recorder.total) == size);
+        REQUIRE(recorder.largestWrite < recorder.total / 100);
+    }
+
+    SECTION("Can be written more than once") {
+        StreamingAxmlChunk chunk(document, trailer);
+        REQUIRE(chunk.size() == expected.str().size());
+        std::stringstream first;
+        chunk.write(first);
+        std::stringstream second;
+        chunk.write(second);
+        REQUIRE(first.str() == expected.str());
+        REQUIRE(second.str() == expected.str());
+    }
+
+    SECTION("Is read back as the file's axml chunk") {
+        test::TempDir dir;
+        auto tempFile = (dir.path() / boost::filesystem::unique_path()).string();
+        {
+            std::vector<std::shared_ptr<bw64::Chunk>> chunks{ std::make_shared<StreamingAxmlChunk>(document, trailer) };
+            bw64::Bw64Writer writer(tempFile.c_str(), 2, 48000, 24, chunks);
+            std::vector<float> frames(16, 0.f);
+            writer.write(frames.data(), 8);
+        }
+        auto reader = bw64::readFile(tempFile);
+        REQUIRE(reader->axmlChunk());
+        std::stringstream readBack;
+        reader->axmlChunk()->write(readBack);
+        REQUIRE(readBack.str() == expected.str());
+    }
+}
@@ -1,8 +1,12 @@
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include <vector>
 #include <chrono>
 #include <random>
 #include <iostream>
 #include <automationpoint.h>
+#include <admextraction.h>
 using namespace admplug;
 
 template<typename Fn>
@@ -72,6 +76,24 @@ std::vector<AutomationPoint> generatePointsInGroupsOfThree(std::size_t numberOfP
     return points;
 }
 
+// Runs of linear ramps, as from ADM blocks interpolating between positions
+std::vector<AutomationPoint> generateRamps(std::size_t numberOfPoints) {
+    std::vector<AutomationPoint> points;
+    points.reserve(numberOfPoints);
+    TimeInc timeInc;
+    double val{0.5};
+    double step{0.0};
+    for(auto i = 0u; i != numberOfPoints; ++i) {
+        if(i % 50 == 0) {
+            step = (randBetween0_1and0_9() - 0.5) / 100.0;
+        }
+        val = std::clamp(val + step, 0.0, 1.0);
+        auto [start, duration] = timeInc();
+        points.emplace_back(start, duration, val);
+    }
+    return points;
+}
+
 bool approxEqual(AutomationPoint const& lhs, AutomationPoint const& rhs) {
     return fabs(rhs.value() - lhs.value()) < 0.00001f;
 }
@@ -170,6 +192,10 @@ void simplifyPointsCopy(std::vector<AutomationPoint>& points) {
     points = std::move(filtered);
 }
 
+void simplifyPointsInPlace(std::vector<AutomationPoint>& points) {
+    detail::simplify(points);
+}
+
 namespace {
 struct Accumulator {
     Accumulator(AutomationPoint first) :
@@ -277,6 +303,7 @@ void testMethods() {
         testMethod(test, simplifyPointsViaFindIf, "FindIf");
         testMethod(test, simplifyPointsCopy, "Copy");
         testMethod(test, simplifyPointsViaAccumulate, "Accumulate");
+        testMethod(test, simplifyPointsInPlace, "InPlace");
     }
 }
 
@@ -303,9 +330,15 @@ void runBenchmarks(std::string name, Fn fn) {
         groupsOfThreeTime += runBenchOnce(fn, generatePointsInGroupsOfThree, POINT_COUNT);
     }
 
+    auto rampsTime = 0ns;
+    for(auto i = 0u; i != ITERATIONS; ++i) {
+        rampsTime += runBenchOnce(fn, generateRamps, POINT_COUNT);
+    }
+
     printResult(name + " implementation with random points", randomTime, ITERATIONS);
     printResult(name + " implementation with indentical points", duplicatesTime, ITERATIONS);
     printResult(name + " implementation with points in groups of three", groupsOfThreeTime, ITERATIONS);
+    printResult(name + " implementation with points on ramps", rampsTime, ITERATIONS);
 }
 
 int main() {
@@ -317,5 +350,12 @@ int main() {
     runBenchmarks("find_if", simplifyPointsViaFindIf);
     runBenchmarks("copy", simplifyPointsCopy);
     runBenchmarks("accumulate", simplifyPointsViaAccumulate);
+    runBenchmarks("in_place_collinear", simplifyPointsInPlace);
+
+    auto ramps = generateRamps(POINT_COUNT);
+    auto rampsCopy = ramps;
+    simplifyPointsCopy(rampsCopy);
+    simplifyPointsInPlace(ramps);
+    std::cout << "Points on ramps kept: " << rampsCopy.size() << " by copy, " << ramps.size() << " by in_place_collinear" << std::endl;
 }
 
@@ -0,0 +1,77 @@
+#include <vector>
+#include <chrono>
+#include <random>
+#include <iostream>
+#include <automationpoint.h>
+#include <reaperapiimpl.h>
+using namespace admplug;
+
+// Synthetic dense automation, as imported from ADM with a short block for every parameter change
+std::vector<AutomationPoint> generateDenseBlocks(std::size_t numberOfBlocks, std::chrono::nanoseconds blockDuration) {
+    std::default_random_engine generator(std::chrono::system_clock::now().time_since_epoch().count());
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+    std::vector<AutomationPoint> points;
+    points.reserve(numberOfBlocks + 1);
+    points.emplace_back(std::chrono::nanoseconds::zero(), std::chrono::nanoseconds::zero(), distribution(generator));
+    auto start = std::chrono::nanoseconds::zero();
+    for(auto i = 0u; i != numberOfBlocks; ++i) {
+        points.emplace_back(start, blockDuration, distribution(generator));
+        start += blockDuration;
+    }
+    return points;
+}
+
+// As DefinedStartEnvelope::createPoints() hands them to ReaperAPI::insertEnvelopePoints()
+std::vector<EnvelopePoint> toEnvelopePoints(std::vector<AutomationPoint> const& points) {
+    std::vector<EnvelopePoint> envelopePoints;
+    envelopePoints.reserve(points.size());
+    for(auto const& point : points) {
+        envelopePoints.push_back({ point.effectiveTime(), point.value() });
+    }
+    return envelopePoints;
+}
+
+void printResult(std::string benchName, std::chrono::nanoseconds elapsed, std::size_t numIterations) {
+    std::cout << elapsed.count() / (numIterations * 1000.0 * 1000.0) << "ms: \t" << "average time taken over " << numIterations << " iterations of " << benchName << std::endl;
+}
+
+void runBenchmark(std::size_t objectCount, std::size_t blockCount) {
+    using namespace std::chrono_literals;
+    auto const ITERATIONS = 3u;
+    auto const PARAMETERS_PER_OBJECT = 3u; // azimuth, elevation & distance
+    std::string const newEnvelopeChunk{"<PARMENV 0 0 1 0\nACT 1 -1\nVIS 1 1 1\nLANEHEIGHT 0 0\nARM 0\nDEFSHAPE 0 -1 -1\nPT 0 0.5 0\n>\n"};
+
+    std::vector<std::vector<EnvelopePoint>> envelopes;
+    for(auto i = 0u; i != objectCount * PARAMETERS_PER_OBJECT; ++i) {
+        envelopes.push_back(toEnvelopePoints(generateDenseBlocks(blockCount, 5ms)));
+    }
+
+    auto totalTime = 0ns;
+    std::size_t chunkBytes{0};
+    std::string updatedChunk;
+    for(auto i = 0u; i != ITERATIONS; ++i) {
+        chunkBytes = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for(auto const& envelope : envelopes) {
+            if(!ReaperAPIImpl::insertPointsInEnvelopeChunk(newEnvelopeChunk, envelope, updatedChunk)) {
+                std::cout << "Failed to build envelope chunk" << std::endl;
+                return;
+            }
+            chunkBytes += updatedChunk.size();
+        }
+        totalTime += std::chrono::high_resolution_clock::now() - start;
+    }
+
+    printResult("building chunks for " + std::to_string(envelopes.size()) + " envelopes of " +
+                std::to_string(blockCount) + " blocks (" + std::to_string(chunkBytes / 1024) + " KiB, " +
+                std::to_string(envelopes.size()) + " set-chunk calls rather than " +
+                std::to_string(envelopes.size() * (blockCount + 1)) + " point inserts)",
+                totalTime, ITERATIONS);
+}
+
+int main() {
+    auto const OBJECT_COUNT = 32u;
+    for(auto blockCount : {1000u, 10000u, 30000u}) {
+        runBenchmark(OBJECT_COUNT, blockCount);
+    }
+}
@@ -0,0 +1,102 @@
+#include <sstream>
+#include <catch2/catch_all.hpp>
+#include <adm/adm.hpp>
+#include <adm/parse.hpp>
+
+#include "blockformatindex.h"
+
+using namespace admplug;
+
+namespace {
+std::string const channelFormats{R"(<?xml version="1.0" encoding="utf-8"?>
+<ebuCoreMain xmlns="urn:ebu:metadata-schema:ebuCore_2014">
+	<coreMetadata>
+		<format>
+			<audioFormatExtended>
+				<!-- <audioBlockFormat> in a comment -->
+				<audioChannelFormat audioChannelFormatID="AC_00031001" audioChannelFormatName="Object > 1" typeLabel="0003" typeDefinition="Objects">
+					<audioBlockFormat audioBlockFormatID="AB_00031001_00000001" rtime="00:00:00.00000" duration="00:00:01.00000">
+						<position coordinate="azimuth">10.000000</position>
+						<position coordinate="elevation">0.000000</position>
+					</audioBlockFormat>
+					<audioBlockFormat audioBlockFormatID="AB_00031001_00000002" rtime="00:00:01.00000" duration="00:00:01.00000">
+						<position coordinate="azimuth">20.000000</position>
+						<position coordinate="elevation">0.000000</position>
+						<jumpPosition>1</jumpPosition>
+					</audioBlockFormat>
+				</audioChannelFormat>
+				<audioChannelFormat audioChannelFormatID="AC_00011001" audioChannelFormatName="Speaker" typeLabel="0001" typeDefinition="DirectSpeakers">
+					<audioBlockFormat audioBlockFormatID="AB_00011001_00000001">
+						<speakerLabel>M+030</speakerLabel>
+						<position coordinate="azimuth">30.000000</position>
+						<position coordinate="elevation">0.000000</position>
+					</audioBlockFormat>
+				</audioChannelFormat>
+			</audioFormatExtended>
+		</format>
+	</coreMetadata>
+</ebuCoreMain>
+)"};
+
+std::shared_ptr<adm::Document> parse(std::string const& xml) {
+    std::istringstream xmlStream{xml};
+    return adm::parseXml(xmlStream, adm::xml::ParserOptions::recursive_node_search);
+}
+
+double azimuthOf(adm::AudioBlockFormatObjects const& block) {
+    return block.get<adm::SphericalPosition>().get<adm::Azimuth>().get();
+}
+}
+
+TEST_CASE("Block format index") {
+    BlockFormatIndex index{channelFormats};
+    auto document = parse(index.structuralXml());
+    auto objectChannel = document->lookup(adm::parseAudioChannelFormatId("AC_00031001"));
+    auto speakerChannel = document->lookup(adm::parseAudioChannelFormatId("AC_00011001"));
+    REQUIRE(objectChannel);
+    REQUIRE(speakerChannel);
+
+    SECTION("Object blocks are left out of the structure") {
+        REQUIRE(index.indexedChannelCount() == 1);
+        REQUIRE(index.indexedBlockCount() == 2);
+        REQUIRE(objectChannel->getElements<adm::AudioBlockFormatObjects>().empty());
+        REQUIRE(objectChannel->get<adm::AudioChannelFormatName>().get() == "Object > 1");
+    }
+
+    SECTION("Other channel types keep their blocks") {
+        REQUIRE(speakerChannel->getElements<adm::AudioBlockFormatDirectSpeakers>().size() == 1);
+    }
+
+    SECTION("Loaded blocks match a full parse") {
+        index.loadBlockFormats(*objectChannel);
+        auto expected = parse(channelFormats)->lookup(adm::parseAudioChannelFormatId("AC_00031001"));
+        auto blocks = objectChannel->getElements<adm::AudioBlockFormatObjects>();
+        auto expectedBlocks = expected->getElements<adm::AudioBlockFormatObjects>();
+        REQUIRE(blocks.size() == expectedBlocks.size());
+        for(std::size_t i = 0; i != blocks.size(); ++i) {
+            REQUIRE(blocks[i].get<adm::AudioBlockFormatId>() == expectedBlocks[i].get<adm::AudioBlockFormatId>());
+            REQUIRE(blocks[i].get<adm::Rtime>().get().asNanoseconds() == expectedBlocks[i].get<adm::Rtime>().get().asNanoseconds());
+            REQUIRE(azimuthOf(blocks[i]) == Catch::Approx(azimuthOf(expectedBlocks[i])));
+        }
+        REQUIRE(adm::isEnabled(blocks[1].get<adm::JumpPosition>()));
+    }
+
+    SECTION("Blocks are only added once") {
+        index.loadBlockFormats(*objectChannel);
+        index.loadBlockFormats(*objectChannel);
+        REQUIRE(objectChannel->getElements<adm::AudioBlockFormatObjects>().size() == 2);
+    }
+
+    SECTION("Channels without indexed blocks are unchanged") {
+        index.loadBlockFormats(*speakerChannel);
+        REQUIRE(speakerChannel->getElements<adm::AudioBlockFormatDirectSpeakers>().size() == 1);
+    }
+}
+
+TEST_CASE("Block format index falls back to the whole document") {
+    std::string const unterminated{"<audioFormatExtended><audioChannelFormat audioChannelFormatID=\"AC_00031001\" typeDefinition=\"Objects\">"
+                                   "<audioBlockFormat audioBlockFormatID=\"AB_00031001_00000001\"/>"};
+    BlockFormatIndex index{unterminated};
+    REQUIRE(index.indexedChannelCount() == 0);
+    REQUIRE(index.structuralXml() == unterminated);
+}
@@ -0,0 +1,130 @@
+#include <cmath>
+#include <catch2/catch_all.hpp>
+#include <adm/adm.hpp>
+
+#include "exportaction_blocksimplification.h"
+
+using namespace admplug;
+using namespace std::chrono_literals;
+
+namespace {
+std::shared_ptr<adm::AudioBlockFormatObjects> objectBlock(std::chrono::nanoseconds rtime, std::chrono::nanoseconds duration, double azimuth, double gain = 1.0) {
+    auto block = std::make_shared<adm::AudioBlockFormatObjects>(adm::SphericalPosition(adm::Azimuth(azimuth), adm::Elevation(0.0)));
+    block->set(adm::Rtime{ rtime });
+    block->set(adm::Duration{ duration });
+    block->set(adm::Gain::fromLinear(gain));
+    return block;
+}
+
+std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> linearPan(int blockCount) {
+    std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> blocks;
+    blocks.push_back(objectBlock(0ms, 0ms, 0.0));
+    for(int n = 1; n <= blockCount; n++) {
+        blocks.push_back(objectBlock((n - 1) * 100ms, 100ms, n * 1.0));
+    }
+    return blocks;
+}
+
+std::shared_ptr<adm::AudioBlockFormatObjects> cartesianBlock(std::chrono::nanoseconds rtime, std::chrono::nanoseconds duration, double x, double width = 0.0) {
+    auto block = std::make_shared<adm::AudioBlockFormatObjects>(adm::CartesianPosition(adm::X(x), adm::Y(0.0)));
+    block->set(adm::Rtime{ rtime });
+    block->set(adm::Duration{ duration });
+    block->set(adm::Width{ static_cast<float>(width) });
+    return block;
+}
+
+std::chrono::nanoseconds rtimeOf(adm::AudioBlockFormatObjects const& block) {
+    return block.get<adm::Rtime>().get().asNanoseconds();
+}
+
+std::chrono::nanoseconds durationOf(adm::AudioBlockFormatObjects const& block) {
+    return block.get<adm::Duration>().get().asNanoseconds();
+}
+}
+
+TEST_CASE("Block simplification") {
+    SECTION("Collinear blocks are merged in to the last") {
+        auto blocks = linearPan(100);
+        auto stats = simplifyBlockFormats(blocks);
+        REQUIRE(blocks.size() == 2);
+        REQUIRE(stats.blocksIn == 101);
+        REQUIRE(stats.blocksOut == 2);
+        REQUIRE(stats.compressionRatio() == Catch::Approx(50.5));
+        REQUIRE(rtimeOf(*blocks[1]) == 0ms);
+        REQUIRE(durationOf(*blocks[1]) == 10s);
+        REQUIRE(blocks[1]->get<adm::SphericalPosition>().get<adm::Azimuth>().get() == Catch::Approx(100.0));
+    }
+
+    SECTION("Changes of direction are kept") {
+        auto blocks = linearPan(100);
+        for(int n = 51; n <= 100; n++) {
+            blocks[n] = objectBlock((n - 1) * 100ms, 100ms, 100.0 - n);
+        }
+        simplifyBlockFormats(blocks);
+        REQUIRE(blocks.size() == 3);
+        REQUIRE(rtimeOf(*blocks[1]) == 0ms);
+        REQUIRE(durationOf(*blocks[1]) == 5s);
+        REQUIRE(rtimeOf(*blocks[2]) == 5s);
+        REQUIRE(durationOf(*blocks[2]) == 5s);
+    }
+
+    SECTION("Deviation in any parameter keeps the block") {
+        auto blocks = linearPan(10);
+        blocks[5] = objectBlock(400ms, 100ms, 5.0, 0.5);
+        simplifyBlockFormats(blocks);
+        REQUIRE(blocks.size() == 5);
+        REQUIRE(blocks[2]->get<adm::Gain>().asLinear() == Catch::Approx(0.5));
+    }
+
+    SECTION("Cartesian width uses the cartesian tolerance") {
+        std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> blocks{ cartesianBlock(0ms, 0ms, 0.0) };
+        for(int n = 1; n <= 10; n++) {
+            blocks.push_back(cartesianBlock((n - 1) * 100ms, 100ms, n * 0.01));
+        }
+        // Well within the polar tolerance of 0.1 degrees
+        blocks[5] = cartesianBlock(400ms, 100ms, 0.05, 0.05);
+        simplifyBlockFormats(blocks);
+        REQUIRE(blocks.size() == 5);
+        REQUIRE(blocks[2]->get<adm::Width>().get() == Catch::Approx(0.05));
+    }
+
+    SECTION("Blocks carrying azimuth across the wrap are kept") {
+        // Collinear, but 170 to -170 directly would be taken as the long way around
+        std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> blocks{ objectBlock(0ms, 0ms, 170.0),
+                                                                            objectBlock(0ms, 100ms, 0.0),
+                                                                            objectBlock(100ms, 100ms, -170.0) };
+        simplifyBlockFormats(blocks);
+        REQUIRE(blocks.size() == 3);
+        REQUIRE(blocks[1]->get<adm::SphericalPosition>().get<adm::Azimuth>().get() == Catch::Approx(0.0));
+    }
+
+    SECTION("Long pans keep a block at least every half turn") {
+        std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> blocks{ objectBlock(0ms, 0ms, 180.0) };
+        for(int n = 1; n <= 36; n++) {
+            blocks.push_back(objectBlock((n - 1) * 100ms, 100ms, 180.0 - n * 10.0));
+        }
+        simplifyBlockFormats(blocks);
+        REQUIRE(blocks.size() > 2);
+        for(size_t n = 1; n < blocks.size(); n++) {
+            auto previous = blocks[n - 1]->get<adm::SphericalPosition>().get<adm::Azimuth>().get();
+            auto current = blocks[n]->get<adm::SphericalPosition>().get<adm::Azimuth>().get();
+            REQUIRE(std::abs(current - previous) <= 180.0);
+        }
+        REQUIRE(rtimeOf(*blocks.back()) + durationOf(*blocks.back()) == 3600ms);
+    }
+
+    SECTION("Blocks around a jump are kept") {
+        auto blocks = linearPan(10);
+        auto jump = objectBlock(500ms, 0ms, 50.0);
+        jump->set(adm::JumpPosition(adm::JumpPositionFlag(true)));
+        blocks.insert(blocks.begin() + 6, jump);
+        simplifyBlockFormats(blocks);
+        REQUIRE(blocks.size() == 5);
+        REQUIRE(blocks[2]->has<adm::JumpPosition>());
+        REQUIRE(adm::isEnabled(blocks[2]->get<adm::JumpPosition>()));
+        REQUIRE(rtimeOf(*blocks[1]) == 0ms);
+        REQUIRE(durationOf(*blocks[1]) == 500ms);
+        REQUIRE(rtimeOf(*blocks[4]) == 600ms);
+        REQUIRE(durationOf(*blocks[4]) == 400ms);
+    }
+}
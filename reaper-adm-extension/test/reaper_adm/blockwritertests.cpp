@@ -0,0 +1,100 @@
+#include <memory>
+#include <ostream>
+#include <vector>
+#include <catch2/catch_all.hpp>
+#include <bw64/bw64.hpp>
+#include "tempdir.h"
+
+#include "exportaction_blockwriter.h"
+#include "floatwriter.h"
+#include "pcmreader.h"
+
+using namespace admplug;
+using Catch::Approx;
+
+TEST_CASE("AsyncBlockWriter") {
+    test::TempDir dir;
+    auto tempFile = dir.path() / boost::filesystem::unique_path();
+    auto tempFileStr = tempFile.string();
+
+    constexpr int channelCount{ 2 };
+    constexpr size_t blockFrameCount{ 8 };
+    auto writer = bw64::writeFile(tempFileStr, channelCount, 48000, 24);
+
+    SECTION("Writes partial blocks in order, beyond the queue length") {
+        std::vector<float> expected;
+        {
+            AsyncBlockWriter blockWriter(*writer, channelCount, blockFrameCount, 2);
+            for (int i = 0; i != 20; ++i) {
+                auto frames = 1 + i % blockFrameCount;
+                auto block = blockWriter.acquireBlock();
+                REQUIRE(block != nullptr);
+                for (size_t s = 0; s != frames * channelCount; ++s) {
+                    block[s] = static_cast<float>(expected.size() % 1000) / 1000.f;
+                    expected.push_back(block[s]);
+                }
+                blockWriter.submitBlock(frames);
+            }
+            REQUIRE(blockWriter.finish());
+        }
+        writer = nullptr;
+
+        bw64::Bw64Reader reader(tempFileStr.c_str());
+        REQUIRE(reader.numberOfFrames() == expected.size() / channelCount);
+        std::vector<float> readBuffer(expected.size());
+        reader.read(readBuffer.data(), reader.numberOfFrames());
+        for (std::size_t i = 0; i != expected.size(); ++i) {
+            REQUIRE(readBuffer[i] == Approx(expected[i]).margin(1e-6));
+        }
+    }
+
+    SECTION("Finishing with nothing queued succeeds") {
+        AsyncBlockWriter blockWriter(*writer, channelCount, blockFrameCount);
+        REQUIRE(blockWriter.finish());
+        REQUIRE_FALSE(blockWriter.hasFailed());
+    }
+}
+
+namespace {
+// Odd sized, so the writer has to pad it
+class TestChunk : public bw64::Chunk {
+public:
+    uint32_t id() const override { return bw64::utils::fourCC("test"); }
+    uint64_t size() const override { return 3; }
+    void write(std::ostream& stream) const override { stream.write("abc", 3); }
+};
+}
+
+TEST_CASE("AsyncBlockWriter to a FloatWriter") {
+    test::TempDir dir;
+    auto tempFile = (dir.path() / boost::filesystem::unique_path()).string();
+
+    constexpr int channelCount{ 2 };
+    constexpr size_t blockFrameCount{ 4 };
+    std::vector<float> expected;
+    {
+        FloatWriter writer(tempFile, channelCount, 48000, { std::make_shared<TestChunk>() });
+        AsyncBlockWriter blockWriter(writer, channelCount, blockFrameCount, 2);
+        for (int i = 0; i != 5; ++i) {
+            auto block = blockWriter.acquireBlock();
+            REQUIRE(block != nullptr);
+            for (size_t s = 0; s != blockFrameCount * channelCount; ++s) {
+                // Beyond full scale, which integer PCM would clip
+                block[s] = static_cast<float>(expected.size()) / 4.f - 2.f;
+                expected.push_back(block[s]);
+            }
+            blockWriter.submitBlock(blockFrameCount);
+        }
+        REQUIRE(blockWriter.finish());
+    }
+
+    MappedBw64PCMReader reader{ tempFile };
+    REQUIRE(reader.totalFrames() == expected.size() / channelCount);
+    auto block = reader.read();
+    REQUIRE(block->isFloat());
+    REQUIRE(block->channelCount() == channelCount);
+    REQUIRE(block->frameCount() == reader.totalFrames());
+    for (std::size_t i = 0; i != expected.size(); ++i) {
+        REQUIRE(block->data()[i] == expected[i]);
+    }
+}
@@ -4,6 +4,7 @@
 #include "blockbuilders.h"
 #include "mocks/reaperapi.h"
 #include <automationenvelope.h>
+#include <reaperapiimpl.h>
 #include "fakeptr.h"
 
 using namespace admplug;
@@ -123,6 +124,79 @@ TEST_CASE("creating point with an offset offsets all points", "[envelope]") {
     env.createPoints(offset);
 }
 
+TEST_CASE("When points can be inserted in bulk, they are not inserted individually", "[envelope]") {
+    FakePtrFactory fake;
+    auto fakeEnvelope = fake.get<TrackEnvelope>();
+    NiceMock<MockReaperAPI> api;
+
+    DefinedStartEnvelope env{fakeEnvelope, api};
+    env.addPoint(AutomationPoint{1000ns, 0ns, 0.1});
+    env.addPoint(AutomationPoint{1000ns, 2000ns, 0.2});
+    auto offset = 2.5;
+    std::vector<EnvelopePoint> inserted;
+    EXPECT_CALL(api, insertEnvelopePoints(fakeEnvelope, _)).WillOnce(::testing::DoAll(::testing::SaveArg<1>(&inserted), Return(true)));
+    EXPECT_CALL(api, InsertEnvelopePoint(_, _, _, _, _, _, _)).Times(0);
+    EXPECT_CALL(api, DeleteEnvelopePointRange(fakeEnvelope, DoubleEq(0.0), DoubleEq(0.000001 + offset))).Times(1);
+    env.createPoints(offset);
+
+    REQUIRE(inserted.size() == 2);
+    CHECK(inserted[0].time == Catch::Approx(0.000001 + offset));
+    CHECK(inserted[0].value == Catch::Approx(0.1));
+    CHECK(inserted[1].time == Catch::Approx(0.000003 + offset));
+    CHECK(inserted[1].value == Catch::Approx(0.2));
+    CHECK(inserted[1].shape == EnvelopeShape::Linear);
+}
+
+TEST_CASE("Envelope chunk point insertion", "[envelope]") {
+    std::string const chunk{"<VOLENV\nACT 1 -1\nVIS 1 1 1\nPT 0 1 0\nPT 2 0.5 0\n>\n"};
+    std::string updated;
+
+    SECTION("New points are merged with existing points in time order") {
+        std::vector<EnvelopePoint> points{ {3.0, 0.25}, {1.0, 0.75} };
+        REQUIRE(ReaperAPIImpl::insertPointsInEnvelopeChunk(chunk, points, updated));
+        CHECK(updated == "<VOLENV\nACT 1 -1\nVIS 1 1 1\nPT 0 1 0\n"
+                         "PT 1.000000000000 0.75 0\nPT 2 0.5 0\nPT 3.000000000000 0.25 0\n>\n");
+    }
+
+    SECTION("Existing points come before new points at the same time") {
+        std::vector<EnvelopePoint> points{ {2.0, 0.25} };
+        REQUIRE(ReaperAPIImpl::insertPointsInEnvelopeChunk(chunk, points, updated));
+        CHECK(updated.find("PT 2 0.5 0\nPT 2.000000000000 0.25 0\n") != std::string::npos);
+    }
+
+    SECTION("Other lines keep their order, with the points where the existing points were") {
+        std::string const chunkWithTrailingLines{"<VOLENV\nACT 1 -1\nPT 0 1 0\nPT 2 0.5 0\nPOOLEDENVINST 1 0 4 0 0 1 0 0 0\nVIS 1 1 1\n>\n"};
+        std::vector<EnvelopePoint> points{ {1.0, 0.75} };
+        REQUIRE(ReaperAPIImpl::insertPointsInEnvelopeChunk(chunkWithTrailingLines, points, updated));
+        CHECK(updated == "<VOLENV\nACT 1 -1\nPT 0 1 0\nPT 1.000000000000 0.75 0\nPT 2 0.5 0\n"
+                         "POOLEDENVINST 1 0 4 0 0 1 0 0 0\nVIS 1 1 1\n>\n");
+    }
+
+    SECTION("Points go at the end of a chunk without any") {
+        std::vector<EnvelopePoint> points{ {1.0, 0.75} };
+        REQUIRE(ReaperAPIImpl::insertPointsInEnvelopeChunk("<VOLENV\nACT 1 -1\n>\n", points, updated));
+        CHECK(updated == "<VOLENV\nACT 1 -1\nPT 1.000000000000 0.75 0\n>\n");
+    }
+
+    SECTION("Nested blocks are kept whole, and their lines aren't taken for points") {
+        std::string const nestedChunk{"<VOLENV\nACT 1 -1\n<EXT\nPT 5 0 0\n>\nPT 0 1 0\n>\n"};
+        std::vector<EnvelopePoint> points{ {1.0, 0.75} };
+        REQUIRE(ReaperAPIImpl::insertPointsInEnvelopeChunk(nestedChunk, points, updated));
+        CHECK(updated == "<VOLENV\nACT 1 -1\n<EXT\nPT 5 0 0\n>\nPT 0 1 0\nPT 1.000000000000 0.75 0\n>\n");
+    }
+
+    SECTION("Incomplete chunks are not updated") {
+        std::vector<EnvelopePoint> points{ {1.0, 0.75} };
+        CHECK_FALSE(ReaperAPIImpl::insertPointsInEnvelopeChunk("<VOLENV\nACT 1 -1\nPT 0 1", points, updated));
+        CHECK_FALSE(ReaperAPIImpl::insertPointsInEnvelopeChunk("<VOLENV\n<EXT\nPT 0 1 0\n>\n", points, updated));
+    }
+
+    SECTION("Tensioned points are not inserted") {
+        EnvelopePoint point{1.0, 0.75, EnvelopeShape::Bezier, 0.5};
+        CHECK_FALSE(ReaperAPIImpl::insertPointsInEnvelopeChunk(chunk, {point}, updated));
+    }
+}
+
 TEST_CASE("Wrapped envelope does not insert extra points when shortest path is positive and direct", "[envelope]") {
 
     FakePtrFactory fake;
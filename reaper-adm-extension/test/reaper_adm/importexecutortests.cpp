@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <catch2/catch_all.hpp>
+
+#include "admimporter.h"
+#include "importexecutor.h"
+
+using namespace admplug;
+
+namespace {
+// Records the steps it's asked to run. Extraction waits until released, so tests can hold the worker there.
+class FakeImporter : public IADMImporter {
+public:
+    bool parse() override {
+        record("parse");
+        return parsed;
+    }
+    void extractAudio() override {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            extractionReleased.wait(lock, [this]() { return releaseExtraction; });
+        }
+        record("extractAudio");
+        if(extractionThrows) {
+            throw std::logic_error("Extraction failed");
+        }
+    }
+    void finishExtraction() override {
+        record("finishExtraction");
+    }
+    void buildProject() override {
+        record("buildProject");
+    }
+    void reportError(std::exception const& e) override {
+        record(std::string("reportError: ") + e.what());
+    }
+    void cancel() override {
+        record("cancel");
+    }
+
+    void releaseWorker() {
+        std::lock_guard<std::mutex> lock(mutex);
+        releaseExtraction = true;
+        extractionReleased.notify_all();
+    }
+    std::vector<std::string> steps() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return calls;
+    }
+    bool called(std::string const& step) {
+        auto current = steps();
+        return std::find(current.begin(), current.end(), step) != current.end();
+    }
+
+    bool parsed{ true };
+    bool extractionThrows{ false };
+
+private:
+    void record(std::string step) {
+        std::lock_guard<std::mutex> lock(mutex);
+        calls.push_back(std::move(step));
+    }
+
+    std::mutex mutex;
+    std::condition_variable extractionReleased;
+    bool releaseExtraction{ false };
+    std::vector<std::string> calls;
+};
+
+template<typename Predicate>
+bool waitFor(Predicate predicate) {
+    auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while(!predicate()) {
+        if(std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+}
+
+TEST_CASE("SerialImport") {
+    auto importer = std::make_shared<FakeImporter>();
+    importer->releaseWorker();
+    SerialImport executor{ importer };
+
+    SECTION("Runs each step in order") {
+        executor.start();
+        executor.buildProject();
+        REQUIRE(importer->steps() == std::vector<std::string>{ "parse", "extractAudio", "finishExtraction", "buildProject" });
+    }
+
+    SECTION("Stops after parsing if there's nothing to extract") {
+        importer->parsed = false;
+        executor.start();
+        REQUIRE(importer->steps() == std::vector<std::string>{ "parse" });
+    }
+}
+
+TEST_CASE("ThreadedImport") {
+    auto importer = std::make_shared<FakeImporter>();
+
+    SECTION("Runs each step in order, building the project on the calling thread") {
+        importer->releaseWorker();
+        ThreadedImport executor{ importer };
+        executor.start();
+        REQUIRE(waitFor([&]() { return importer->called("finishExtraction"); }));
+        executor.buildProject();
+        REQUIRE(importer->steps() == std::vector<std::string>{ "parse", "extractAudio", "finishExtraction", "buildProject" });
+    }
+
+    SECTION("Reports anything the worker throws through the importer") {
+        importer->extractionThrows = true;
+        importer->releaseWorker();
+        ThreadedImport executor{ importer };
+        executor.start();
+        REQUIRE(waitFor([&]() { return importer->called("reportError: Extraction failed"); }));
+        REQUIRE_FALSE(importer->called("finishExtraction"));
+    }
+
+    SECTION("Cancels rather than waits for a worker still running when destroyed") {
+        {
+            ThreadedImport executor{ importer };
+            executor.start();
+            REQUIRE(waitFor([&]() { return importer->called("parse"); }));
+        }
+        REQUIRE(importer->called("cancel"));
+        importer->releaseWorker();
+        REQUIRE(waitFor([&]() { return importer->called("finishExtraction"); }));
+    }
+
+    SECTION("Can be destroyed before the project is built") {
+        importer->parsed = false;
+        {
+            ThreadedImport executor{ importer };
+            executor.start();
+            REQUIRE(waitFor([&]() { return importer->called("parse"); }));
+        }
+        REQUIRE(importer->steps().front() == "parse");
+    }
+}
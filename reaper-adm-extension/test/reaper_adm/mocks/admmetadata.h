@@ -10,6 +10,8 @@ class MockIADMMetaData : public IADMMetaData {
       std::shared_ptr<adm::Document const>());
   MOCK_CONST_METHOD0(fileName,
       std::string());
+  MOCK_CONST_METHOD1(loadBlockFormats,
+      void(adm::AudioChannelFormat const& channelFormat));
 };
 
 }  // namespace admplug
@@ -24,6 +24,10 @@ class MockIPCMBlock : public IPCMBlock {
       std::size_t());
   MOCK_CONST_METHOD0(sampleRate,
       std::size_t());
+  MOCK_CONST_METHOD0(bitDepth,
+      std::size_t());
+  MOCK_CONST_METHOD0(isFloat,
+      bool());
   MOCK_CONST_METHOD0(data,
       const std::vector<float>&());
 };
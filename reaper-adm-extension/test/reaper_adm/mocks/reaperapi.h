@@ -89,6 +89,8 @@ class MockReaperAPI : public ReaperAPI {
       int(PCM_source* source));
   MOCK_CONST_METHOD1(PCM_Source_CreateFromFile,
       PCM_source*(const char* filename));
+  MOCK_CONST_METHOD2(PCM_Source_CreateFromSimple,
+      PCM_source*(ISimpleMediaDecoder* dec, const char* fn));
   MOCK_CONST_METHOD4(TrackFX_AddByName,
       int(MediaTrack* track, const char* fxname, bool recFX, int instantiate));
   MOCK_CONST_METHOD2(TrackFX_Delete,
@@ -171,6 +173,7 @@ class MockReaperAPI : public ReaperAPI {
       bool(MediaTrack* track, int fx, char* presetname, int presetname_sz));
   MOCK_CONST_METHOD1(CountEnvelopePoints, int(TrackEnvelope* envelope));
   MOCK_CONST_METHOD7(GetEnvelopePoint, bool(TrackEnvelope* envelope, int ptidx, double* timeOutOptional, double* valueOutOptional, int* shapeOutOptional, double* tensionOutOptional, bool* selectedOutOptional));
+  MOCK_CONST_METHOD1(CountAutomationItems, int(TrackEnvelope* env));
   MOCK_CONST_METHOD3(GetTrackUIVolPan, bool(MediaTrack* track, double* volumeOut, double* panOut));
   MOCK_CONST_METHOD8(Envelope_Evaluate, int(TrackEnvelope* envelope, double time, double samplerate, int samplesRequested, double* valueOutOptional, double* dVdSOutOptional, double* ddVdSOutOptional, double* dddVdSOutOptional));
   MOCK_CONST_METHOD4(GetEnvelopeStateChunk, bool(TrackEnvelope* env, char* strNeedBig, int strNeedBig_sz, bool isundoOptional));
@@ -231,6 +234,8 @@ class MockReaperAPI : public ReaperAPI {
   MOCK_CONST_METHOD4(mapFxPin, void(MediaTrack* trk, int fxNum, int trackChannel, int fxChannel));
   MOCK_CONST_METHOD1(forceAmplitudeScaling, bool(TrackEnvelope * trackEnvelope));
   MOCK_CONST_METHOD2(getTrackAudioBounds, std::optional<std::pair<double, double>>(MediaTrack* tr, bool ignoreBeforeZero));
+  MOCK_CONST_METHOD1(getEnvelopePoints, std::vector<EnvelopePoint>(TrackEnvelope* envelope));
+  MOCK_CONST_METHOD2(insertEnvelopePoints, bool(TrackEnvelope* envelope, std::vector<EnvelopePoint> const& points));
   MOCK_CONST_METHOD3(TrackFX_GetActualFXName, bool(MediaTrack* track, int fx, std::string& name));
   MOCK_CONST_METHOD1(TrackFX_GetActualFXNames, std::vector<std::string>(MediaTrack* track));
   MOCK_CONST_METHOD1(CleanFXName, void(std::string& name));
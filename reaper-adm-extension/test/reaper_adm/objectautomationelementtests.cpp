@@ -187,7 +187,7 @@ TEST_CASE("JumpPosition Insertion"){
     SECTION("Jump Position Scenario 1: No jump position"){
         AutomationPoint point1{ns::zero(), ns(1000000000), 0.1};
         AutomationPoint point2{ns(1000000000), ns(1000000000), 0.2};
-        AutomationPoint point3{ns(2000000000), ns(1000000000), 0.3};
+        AutomationPoint point3{ns(2000000000), ns(1000000000), 0.4}; // Not in line with the others, or simplify would drop point2
         auto blockRange = ObjectTypeBlockRange{}.with(initialSphericalBlock().withDistance(0.0).withJumpPosition(false).withDuration(1.0))
                 .followedBy(SphericalCoordBlock{}.withDistance(55.0).withJumpPosition(false).withDuration(1.0))
                 .followedBy(SphericalCoordBlock{}.withDistance(20.0).withJumpPosition(false).withDuration(1.0));
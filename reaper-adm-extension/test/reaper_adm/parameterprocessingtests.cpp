@@ -0,0 +1,247 @@
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include <catch2/catch_all.hpp>
+#include <gmock/gmock.h>
+#include <adm/adm.hpp>
+
+#include "exportaction_parameterprocessing.h"
+#include "mocks/reaperapi.h"
+#include "fakeptr.h"
+
+using namespace admplug;
+using namespace std::chrono_literals;
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+namespace {
+class ScaledParameter : public Parameter {
+public:
+    ScaledParameter(AdmParameter parameter, double scale) : parameter{ parameter }, scale{ scale } {}
+    using Parameter::forwardMap;
+    using Parameter::reverseMap;
+    double forwardMap(double val) const override { return val / scale; }
+    double reverseMap(double val) const override { return val * scale; }
+    AdmParameter admParameter() const override { return parameter; }
+
+private:
+    AdmParameter parameter;
+    double scale;
+};
+
+struct FakePoint {
+    double time;
+    double value;
+    int shape;
+};
+
+// Stands in for REAPER's envelopes, with square and sine shaped curves for anything not linear
+class FakeEnvelopes {
+public:
+    explicit FakeEnvelopes(NiceMock<MockReaperAPI>& api) {
+        ON_CALL(api, GetEnvelopeScalingMode(_)).WillByDefault(Return(0));
+        ON_CALL(api, ScaleFromEnvelopeMode(_, _)).WillByDefault([](int, double value) { return value; });
+        ON_CALL(api, CountAutomationItems(_)).WillByDefault(Return(0));
+        ON_CALL(api, getEnvelopePoints(_)).WillByDefault([this](TrackEnvelope* envelope) {
+            std::vector<EnvelopePoint> points;
+            for(auto const& point : envelopes.at(envelope)) {
+                EnvelopePoint envelopePoint;
+                envelopePoint.time = point.time;
+                envelopePoint.value = point.value;
+                envelopePoint.shape = point.shape;
+                points.push_back(envelopePoint);
+            }
+            return points;
+        });
+        ON_CALL(api, GetEnvelopeStateChunk(_, _, _, _)).WillByDefault([this](TrackEnvelope* envelope, char* buffer, int size, bool) {
+            std::string chunk{ "<PARMENV\n" };
+            char line[128];
+            for(auto const& point : envelopes.at(envelope)) {
+                std::snprintf(line, sizeof(line), "PT %.6f %.6f %d\n", point.time, point.value, point.shape);
+                chunk += line;
+            }
+            chunk += ">\n";
+            std::snprintf(buffer, static_cast<std::size_t>(size), "%s", chunk.c_str());
+            return true;
+        });
+        ON_CALL(api, Envelope_Evaluate(_, _, _, _, _, _, _, _)).WillByDefault([this](TrackEnvelope* envelope, double time, double, int, double* value, double*, double*, double*) {
+            *value = evaluate(envelopes.at(envelope), time);
+            return 0;
+        });
+    }
+
+    TrackEnvelope* add(std::vector<FakePoint> points) {
+        auto envelope = fakePtr.get<TrackEnvelope>();
+        envelopes[envelope] = std::move(points);
+        return envelope;
+    }
+
+private:
+    static double evaluate(std::vector<FakePoint> const& points, double time) {
+        if(time <= points.front().time) return points.front().value;
+        for(std::size_t i = 0; i + 1 < points.size(); ++i) {
+            auto const& prev = points[i];
+            auto const& next = points[i + 1];
+            if(time < next.time) {
+                if(prev.shape == EnvelopeShape::Square) return prev.value;
+                auto fraction = (time - prev.time) / (next.time - prev.time);
+                if(prev.shape != EnvelopeShape::Linear) fraction = std::sin(fraction * 1.5707963);
+                return prev.value + (next.value - prev.value) * fraction;
+            }
+        }
+        return points.back().value;
+    }
+
+    FakePtrFactory fakePtr;
+    std::map<TrackEnvelope*, std::vector<FakePoint>> envelopes;
+};
+
+struct ExpectedBlock {
+    std::chrono::nanoseconds rtime;
+    std::chrono::nanoseconds duration;
+    double azimuth;
+    double elevation;
+    double gain;
+    double width;
+    bool jump;
+};
+
+// Points on a whole millisecond, with values to three decimal places, of any of the first three shapes.
+// Only the raw output of mt19937 is used, as the standard distributions differ between libraries.
+std::vector<FakePoint> randomEnvelope(std::mt19937& rng, int pointCount) {
+    auto uniform = [&rng]() { return rng() / 4294967296.0; };
+    std::vector<FakePoint> points;
+    long timeMs = 0;
+    for(int i = 0; i != pointCount; ++i) {
+        FakePoint point;
+        point.time = timeMs / 1000.0;
+        point.value = std::round(uniform() * 1000) / 1000;
+        point.shape = static_cast<int>(uniform() * 3);
+        points.push_back(point);
+        timeMs += static_cast<long>(uniform() * 2500);
+    }
+    return points;
+}
+
+std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> blocksForRandomEnvelopes(unsigned int seed) {
+    std::mt19937 rng{ seed };
+    NiceMock<MockReaperAPI> api;
+    FakeEnvelopes envelopes{ api };
+    std::vector<ScaledParameter> parameters{ { AdmParameter::OBJECT_AZIMUTH, 360.0 },
+                                             { AdmParameter::OBJECT_ELEVATION, 90.0 },
+                                             { AdmParameter::OBJECT_GAIN, 2.0 },
+                                             { AdmParameter::OBJECT_WIDTH, 1.0 } };
+    CumulatedPointData data{ 0s, 10s };
+    for(auto& parameter : parameters) {
+        auto envelope = envelopes.add(randomEnvelope(rng, 5));
+        REQUIRE(data.useEnvelopeDataForParameter(*envelope, parameter, parameter.admParameter(), api).empty());
+    }
+    auto blocks = data.generateAudioBlockFormatObjects(nullptr, nullptr, api);
+    REQUIRE(blocks.has_value());
+    return *blocks;
+}
+
+void requireBlocksMatch(std::vector<std::shared_ptr<adm::AudioBlockFormatObjects>> const& blocks, std::vector<ExpectedBlock> const& expected) {
+    REQUIRE(blocks.size() == expected.size());
+    for(std::size_t i = 0; i != blocks.size(); ++i) {
+        INFO("Block " << i);
+        auto const& block = *blocks[i];
+        REQUIRE(block.get<adm::Rtime>().get().asNanoseconds() == expected[i].rtime);
+        REQUIRE(block.get<adm::Duration>().get().asNanoseconds() == expected[i].duration);
+        auto position = block.get<adm::SphericalPosition>();
+        REQUIRE(position.get<adm::Azimuth>().get() == Catch::Approx(expected[i].azimuth));
+        REQUIRE(position.get<adm::Elevation>().get() == Catch::Approx(expected[i].elevation));
+        REQUIRE(block.get<adm::Gain>().asLinear() == Catch::Approx(expected[i].gain));
+        REQUIRE(block.get<adm::Width>().get() == Catch::Approx(expected[i].width));
+        REQUIRE((block.has<adm::JumpPosition>() && adm::isEnabled(block.get<adm::JumpPosition>())) == expected[i].jump);
+    }
+}
+}
+
+// Expected blocks are as output before point data was held column-wise
+TEST_CASE("Cumulated point data from random envelopes") {
+    SECTION("Seed 1") {
+        requireBlocksMatch(blocksForRandomEnvelopes(1), {
+            { 0ns, 0ns, 150.12, 60.3, 1.34, 0.093, false },
+            { 0ns, 900000000ns, 281.472153913, 60.3, 0.923841100406, 0.787833776681, false },
+            { 900000000ns, 0ns, 281.472153913, 60.3, 0.923841100406, 0.787833776681, true },
+            { 900000000ns, 142999999ns, 296.799781431, 60.3, 0.914, 0.839704813827, false },
+            { 1042999999ns, 0ns, 296.799781431, 60.3, 0.914, 0.839704813827, true },
+            { 1042999999ns, 252000001ns, 318.131586292, 60.3, 0.914, 0.876, false },
+            { 1295000000ns, 505000000ns, 335.88, 60.3, 0.914, 0.859673657064, false },
+            { 1800000000ns, 160000000ns, 222.3, 60.3, 0.914, 0.854833253267, false },
+            { 1960000000ns, 159000000ns, 109.429875, 60.3, 0.914, 0.850287618026, false },
+            { 2119000000ns, 0ns, 109.429875, 60.3, 0.28, 0.850287618026, true },
+            { 2119000000ns, 1000000ns, 108.72, 60.3, 0.284049157, 0.850259985789, false },
+            { 2120000000ns, 218000000ns, 89.5941100528, 60.3, 1.09709101438, 0.844562314173, false },
+            { 2338000000ns, 0ns, 89.5941100528, 48.51, 1.09709101438, 0.844562314173, true },
+            { 2338000000ns, 148000000ns, 84.96, 44.0306878555, 1.45217768409, 0.841106090009, false },
+            { 2486000000ns, 0ns, 84.96, 44.0306878555, 1.45217768409, 0.841106090009, true },
+            { 2486000000ns, 128000000ns, 82.6350756811, 40.3262799087, 1.556, 0.838419579901, false },
+            { 2614000000ns, 0ns, 82.6350756811, 40.3262799087, 1.556, 0.838419579901, true },
+            { 2614000000ns, 771000000ns, 68.6310393542, 28.17, 1.79404240954, 0.829246995584, false },
+            { 3385000000ns, 92000000ns, 66.96, 27.0908193704, 1.81716704547, 0.829033814273, false },
+            { 3477000000ns, 0ns, 66.96, 27.0908193704, 1.81716704547, 0.829033814273, true },
+            { 3477000000ns, 54000000ns, 66.96, 26.4626530606, 1.82995615796, 0.829, false },
+            { 3531000000ns, 872000000ns, 66.96, 18.9583340187, 1.936, 0.496849566056, false },
+            { 4403000000ns, 0ns, 66.96, 18.9583340187, 1.936, 0.496849566056, true },
+            { 4403000000ns, 293000000ns, 66.96, 18.36, 1.936, 0.385243972999, false },
+            { 4696000000ns, 909000000ns, 66.96, 18.36, 1.936, 0.039, false },
+            { 5605000000ns, 424000000ns, 66.96, 18.36, 1.936, 0.059, false },
+            { 6029000000ns, 862000000ns, 66.96, 18.36, 1.936, 0.059, false },
+            { 6891000000ns, 0ns, 66.96, 20.7, 1.936, 0.059, true },
+            { 6891000000ns, 3109000000ns, 66.96, 20.7, 1.936, 0.059, false }
+        });
+    }
+
+    SECTION("Seed 2") {
+        requireBlocksMatch(blocksForRandomEnvelopes(2), {
+            { 0ns, 0ns, 156.96, 10.8, 1.57, 0.116, false },
+            { 0ns, 64000000ns, 335.52, 11.4986138614, 1.55566447985, 0.117550660793, false },
+            { 64000000ns, 390000000ns, 335.52, 15.7557920792, 1.46830740394, 0.127, false },
+            { 454000000ns, 758000000ns, 335.52, 24.03, 1.29852108716, 0.127, false },
+            { 1212000000ns, 733000000ns, 335.52, 24.03, 1.13433458294, 0.127, false },
+            { 1945000000ns, 0ns, 335.52, 24.03, 1.13433458294, 0.566, true },
+            { 1945000000ns, 189000000ns, 335.52, 24.03, 1.092, 0.409409747292, false },
+            { 2134000000ns, 299000000ns, 335.52, 24.03, 1.092, 0.161682310469, false },
+            { 2433000000ns, 0ns, 156.6, 24.03, 1.092, 0.161682310469, true },
+            { 2433000000ns, 66000000ns, 156.6, 24.03, 1.092, 0.107, false },
+            { 2499000000ns, 265000000ns, 156.6, 24.03, 1.092, 0.429714328769, false },
+            { 2764000000ns, 0ns, 156.6, 73.62, 1.092, 0.429714328769, true },
+            { 2764000000ns, 285000000ns, 156.6, 73.62, 1.092, 0.577, false },
+            { 3049000000ns, 103000000ns, 156.6, 73.62, 1.092, 0.577, false },
+            { 3152000000ns, 0ns, 156.6, 73.62, 1.694, 0.577, true },
+            { 3152000000ns, 199000000ns, 156.6, 73.62, 1.94, 0.577, false },
+            { 3351000000ns, 132000000ns, 156.6, 73.62, 1.94, 0.577, false },
+            { 3483000000ns, 0ns, 115.56, 73.62, 1.94, 0.577, true },
+            { 3483000000ns, 386000000ns, 73.8, 73.62, 1.94, 0.577, false },
+            { 3869000000ns, 224000000ns, 73.8, 73.62, 1.94, 0.577, false },
+            { 4093000000ns, 0ns, 73.8, 73.62, 0.13, 0.577, true },
+            { 4093000000ns, 378000000ns, 73.8, 73.62, 0.13, 0.577, false },
+            { 4471000000ns, 0ns, 73.8, 12.15, 0.13, 0.577, true },
+            { 4471000000ns, 1283000000ns, 73.8, 12.15, 0.13, 0.577, false },
+            { 5754000000ns, 0ns, 73.8, 52.83, 0.13, 0.577, true },
+            { 5754000000ns, 4246000000ns, 73.8, 52.83, 0.13, 0.577, false }
+        });
+    }
+}
+
+TEST_CASE("EnvelopeSnapshot") {
+    NiceMock<MockReaperAPI> api;
+    FakeEnvelopes envelopes{ api };
+    auto envelope = envelopes.add({ { 2.0, 0.2, 0 }, { 0.0, 0.0, 0 }, { 1.0, 0.1, 0 }, { 1.0, 0.15, 0 } });
+
+    SECTION("Sorts its copy of the points by time, keeping points at the same time in order, without sorting the envelope") {
+        EXPECT_CALL(api, Envelope_SortPoints(_)).Times(0);
+        auto snapshot = EnvelopeSnapshot::take(*envelope, api);
+        REQUIRE(snapshot.points.size() == 4);
+        REQUIRE(snapshot.points[0].time == 0.0);
+        REQUIRE(snapshot.points[1].value == 0.1);
+        REQUIRE(snapshot.points[2].value == 0.15);
+        REQUIRE(snapshot.points[3].time == 2.0);
+    }
+}
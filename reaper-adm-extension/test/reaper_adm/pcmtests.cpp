@@ -1,4 +1,14 @@
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
 #include <vector>
 #include <catch2/catch_all.hpp>
 #include <gmock/gmock.h>
@@ -12,6 +22,8 @@
 #include "channelindexer.h"
 #include "pluginsuite.h"
 #include "pcmsourcecreator.h"
+#include "pcmpipeline.h"
+#include "channelselectsource.h"
 #include "mocks/reaperapi.h"
 #include "mocks/pcmgroup.h"
 #include "mocks/pcmgroupregistry.h"
@@ -240,6 +252,123 @@ TEST_CASE("PCMReader stereo file tests") {
     }
 }
 
+namespace {
+    std::vector<float> readAll(PCMReader& reader) {
+        std::vector<float> samples;
+        for(auto block = reader.read(); block->frameCount() > 0; block = reader.read()) {
+            auto const& data = block->data();
+            samples.insert(samples.end(), data.begin(), data.begin() + block->frameCount() * block->channelCount());
+        }
+        return samples;
+    }
+
+    void writeLittleEndian(std::ostream& file, uint64_t value, int bytes) {
+        for(int i = 0; i != bytes; ++i) {
+            file.put(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+}
+
+TEST_CASE("MappedBw64PCMReader") {
+    SECTION("Reads the same samples as Bw64PCMReader") {
+        test::TempDir dir;
+        auto bitDepth = GENERATE(as<uint16_t>{}, 16, 24, 32);
+        auto tempFile = (dir.path() / boost::filesystem::unique_path()).string();
+        {
+            std::vector<float> data(3 * 10000);
+            for(std::size_t i = 0; i != data.size(); ++i) {
+                data[i] = std::sin(static_cast<float>(i) * 0.01f) * 0.9f;
+            }
+            auto writer = bw64::writeFile(tempFile, 3, 48000, bitDepth);
+            writer->write(data.data(), 10000);
+        }
+        Bw64PCMReader streamReader{ tempFile };
+        MappedBw64PCMReader mappedReader{ tempFile, 1000 };
+        REQUIRE(mappedReader.totalFrames() == streamReader.totalFrames());
+        auto expected = readAll(streamReader);
+        auto samples = readAll(mappedReader);
+        REQUIRE(samples.size() == expected.size());
+        for(std::size_t i = 0; i != samples.size(); ++i) {
+            REQUIRE(samples[i] == Approx(expected[i]));
+        }
+    }
+
+    SECTION("Reports the file's format on each block") {
+        MappedBw64PCMReader reader{ "data/channels_stereo_adm.wav" };
+        auto block = reader.read();
+        REQUIRE(block->channelCount() == 2);
+        REQUIRE(block->frameCount() == reader.blockFrames());
+    }
+
+    SECTION("Reuses blocks once released") {
+        MappedBw64PCMReader reader{ "data/channels_stereo_adm.wav", 16 };
+        auto block = reader.read();
+        auto first = block.get();
+        block = nullptr;
+        block = reader.read();
+        REQUIRE(block.get() == first);
+        auto second = reader.read();
+        REQUIRE(second.get() != first);
+    }
+
+    SECTION("Throws for files it can't read") {
+        REQUIRE_THROWS_AS(MappedBw64PCMReader{ "data/does_not_exist.wav" }, std::runtime_error);
+    }
+}
+
+TEST_CASE("MappedBw64PCMReader reads multi-GB RF64 files", "[.][large]") {
+    test::TempDir dir;
+    auto tempFile = (dir.path() / boost::filesystem::unique_path()).string();
+    constexpr uint64_t channelCount{ 2 };
+    constexpr uint64_t frameCount{ (uint64_t{ 5 } << 30) / (channelCount * 2) + 3 }; // Just over 5 GiB of 16 bit samples
+    constexpr uint64_t dataSize{ frameCount * channelCount * 2 };
+    uint64_t dataStart{ 0 };
+    {
+        std::ofstream file(tempFile, std::ios::binary);
+        file.write("RF64", 4);
+        writeLittleEndian(file, 0xFFFFFFFF, 4);
+        file.write("WAVE", 4);
+        file.write("ds64", 4);
+        writeLittleEndian(file, 28, 4);
+        writeLittleEndian(file, dataSize + 72, 8);
+        writeLittleEndian(file, dataSize, 8);
+        writeLittleEndian(file, frameCount, 8);
+        writeLittleEndian(file, 0, 4);
+        file.write("fmt ", 4);
+        writeLittleEndian(file, 16, 4);
+        writeLittleEndian(file, 1, 2);
+        writeLittleEndian(file, channelCount, 2);
+        writeLittleEndian(file, 48000, 4);
+        writeLittleEndian(file, 48000 * channelCount * 2, 4);
+        writeLittleEndian(file, channelCount * 2, 2);
+        writeLittleEndian(file, 16, 2);
+        file.write("data", 4);
+        writeLittleEndian(file, 0xFFFFFFFF, 4);
+        dataStart = static_cast<uint64_t>(file.tellp());
+    }
+    // Sparse, so only the last frame needs writing
+    boost::filesystem::resize_file(tempFile, dataStart + dataSize);
+    {
+        std::fstream file(tempFile, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(dataStart + dataSize - 4));
+        writeLittleEndian(file, 0x4000, 2);
+        writeLittleEndian(file, 0xC000, 2);
+    }
+
+    MappedBw64PCMReader reader{ tempFile };
+    REQUIRE(reader.totalFrames() == frameCount);
+    uint64_t framesRead{ 0 };
+    std::shared_ptr<IPCMBlock> last;
+    for(auto block = reader.read(); block->frameCount() > 0; block = reader.read()) {
+        framesRead += block->frameCount();
+        last = block;
+    }
+    REQUIRE(framesRead == frameCount);
+    auto lastFrame = (last->frameCount() - 1) * channelCount;
+    REQUIRE(last->data()[lastFrame] == Approx(0.5f));
+    REQUIRE(last->data()[lastFrame + 1] == Approx(-0.5f));
+}
+
 namespace {
     std::unique_ptr<NiceMock<MockIPCMWriter>> createWriter() {
         auto writer = std::make_unique<NiceMock<MockIPCMWriter>>();
@@ -309,6 +438,278 @@ TEST_CASE("PCMWriter") {
             REQUIRE(readBuffer[i] == Approx(data[i]));
         }
     }
+    SECTION("Writes with the bit depth of the source, defaulting to 24 bit") {
+        auto sourceBitDepth = GENERATE(as<std::size_t>{}, 0, 8, 16, 24, 32);
+        NiceMock<MockIPCMBlock> fakeBlock;
+        std::vector<float> data({ 0.1f, 0.2f, 0.3f, 0.4f });
+        ON_CALL(fakeBlock, sampleRate()).WillByDefault(Return(48000));
+        ON_CALL(fakeBlock, channelCount()).WillByDefault(Return(1));
+        ON_CALL(fakeBlock, frameCount()).WillByDefault(Return(4));
+        ON_CALL(fakeBlock, bitDepth()).WillByDefault(Return(sourceBitDepth));
+        ON_CALL(fakeBlock, data()).WillByDefault(ReturnRef(data));
+        auto writer = std::make_unique<PCMWriter>(tempFile.string());
+        writer->write(fakeBlock);
+        writer = nullptr;
+
+        bw64::Bw64Reader reader(tempFile.string().c_str());
+        auto expectedBitDepth = (sourceBitDepth == 16 || sourceBitDepth == 32)? sourceBitDepth : 24;
+        REQUIRE(reader.bitDepth() == expectedBitDepth);
+    }
+    SECTION("Writes float sources as float, without clipping") {
+        NiceMock<MockIPCMBlock> fakeBlock;
+        std::vector<float> data({ 0.1f, -0.2f, 1.5f, -2.25f, 8.f, 0.f });
+        ON_CALL(fakeBlock, sampleRate()).WillByDefault(Return(48000));
+        ON_CALL(fakeBlock, channelCount()).WillByDefault(Return(2));
+        ON_CALL(fakeBlock, frameCount()).WillByDefault(Return(3));
+        ON_CALL(fakeBlock, bitDepth()).WillByDefault(Return(32));
+        ON_CALL(fakeBlock, isFloat()).WillByDefault(Return(true));
+        ON_CALL(fakeBlock, data()).WillByDefault(ReturnRef(data));
+        auto writer = std::make_unique<PCMWriter>(tempFile.string());
+        writer->write(fakeBlock);
+        writer->write(fakeBlock);
+        writer = nullptr;
+
+        MappedBw64PCMReader reader{ tempFile.string() };
+        REQUIRE(reader.totalFrames() == 6);
+        auto block = reader.read();
+        REQUIRE(block->isFloat());
+        REQUIRE(block->bitDepth() == 32);
+        REQUIRE(block->channelCount() == 2);
+        REQUIRE(block->frameCount() == 6);
+        for(std::size_t i = 0; i != 2 * data.size(); ++i) {
+            REQUIRE(block->data()[i] == data[i % data.size()]);
+        }
+    }
+}
+
+namespace {
+    constexpr std::size_t PIPELINE_BLOCK_FRAMES{ 10 };
+
+    // Each block holds its index, so writers can check the order they get them in
+    class IndexedBlock : public IPCMBlock {
+    public:
+        IndexedBlock(std::size_t index, std::size_t frames) :
+            samples(PIPELINE_BLOCK_FRAMES, static_cast<float>(index)), frames{frames} {}
+        std::size_t frameCount() const override { return frames; }
+        std::size_t channelCount() const override { return 1; }
+        std::size_t sampleRate() const override { return 48000; }
+        std::size_t bitDepth() const override { return 24; }
+        bool isFloat() const override { return false; }
+        std::vector<float> const& data() const override { return samples; }
+    private:
+        std::vector<float> samples;
+        std::size_t frames;
+    };
+
+    class IndexedBlockReader : public PCMReader {
+    public:
+        explicit IndexedBlockReader(std::size_t blockCount, std::size_t throwAtBlock = std::numeric_limits<std::size_t>::max()) :
+            blockCount{blockCount}, throwAtBlock{throwAtBlock} {}
+        std::shared_ptr<IPCMBlock> read() override {
+            auto index = blocksRead.load();
+            if(index == throwAtBlock) {
+                throw std::runtime_error("Read failed");
+            }
+            if(index == blockCount) {
+                return std::make_shared<IndexedBlock>(index, 0);
+            }
+            ++blocksRead;
+            return std::make_shared<IndexedBlock>(index, PIPELINE_BLOCK_FRAMES);
+        }
+        std::size_t totalFrames() override { return blockCount * PIPELINE_BLOCK_FRAMES; }
+        std::atomic<std::size_t> blocksRead{ 0 };
+    private:
+        std::size_t blockCount;
+        std::size_t throwAtBlock;
+    };
+
+    // Blocks writers until opened
+    class Gate {
+    public:
+        void open() {
+            std::lock_guard<std::mutex> lock(mutex);
+            isOpen = true;
+            opened.notify_all();
+        }
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            opened.wait(lock, [this]() { return isOpen; });
+        }
+    private:
+        std::mutex mutex;
+        std::condition_variable opened;
+        bool isOpen{ false };
+    };
+
+    class RecordingWriter : public IPCMWriter {
+    public:
+        explicit RecordingWriter(Gate* gate = nullptr, std::size_t throwAtBlock = std::numeric_limits<std::size_t>::max()) :
+            gate{gate}, throwAtBlock{throwAtBlock} {}
+        void write(IPCMBlock const& block) override {
+            if(gate) {
+                gate->wait();
+            }
+            if(blocks.size() == throwAtBlock) {
+                throw std::runtime_error("Write failed");
+            }
+            blocks.push_back(static_cast<std::size_t>(block.data()[0]));
+            ++blocksWritten;
+        }
+        std::string fileName() override { return "recording"; }
+        std::vector<std::size_t> blocks;
+        std::atomic<std::size_t> blocksWritten{ 0 };
+    private:
+        Gate* gate;
+        std::size_t throwAtBlock;
+    };
+
+    template<typename Predicate>
+    bool waitFor(Predicate predicate) {
+        auto const deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while(!predicate()) {
+            if(std::chrono::steady_clock::now() > deadline) return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+}
+
+TEST_CASE("PCMPipeline") {
+    constexpr std::chrono::seconds timeout{ 10 };
+    std::vector<std::unique_ptr<IPCMWriter>> writers;
+    auto recorder = [&writers](std::size_t i) {
+        return static_cast<RecordingWriter*>(writers[i].get());
+    };
+
+    SECTION("Every writer receives every block in order") {
+        constexpr std::size_t blockCount{ 64 };
+        IndexedBlockReader reader{ blockCount };
+        for(int i = 0; i != 7; ++i) {
+            writers.push_back(std::make_unique<RecordingWriter>());
+        }
+        PCMPipeline pipeline{ reader, writers, 3, 4 };
+        REQUIRE(pipeline.waitUntilFinished(timeout));
+        pipeline.finish();
+
+        std::vector<std::size_t> expected(blockCount);
+        std::iota(expected.begin(), expected.end(), 0);
+        for(std::size_t i = 0; i != writers.size(); ++i) {
+            REQUIRE(recorder(i)->blocks == expected);
+        }
+        REQUIRE(pipeline.framesWritten() == blockCount * PIPELINE_BLOCK_FRAMES);
+    }
+
+    SECTION("framesWritten() reports the slowest writer") {
+        Gate gate;
+        IndexedBlockReader reader{ 10 };
+        writers.push_back(std::make_unique<RecordingWriter>());
+        writers.push_back(std::make_unique<RecordingWriter>(&gate));
+        PCMPipeline pipeline{ reader, writers, 2, 4 };
+        REQUIRE(waitFor([&]() { return recorder(0)->blocksWritten == 4; }));
+        REQUIRE(pipeline.framesWritten() == 0);
+        gate.open();
+        REQUIRE(pipeline.waitUntilFinished(timeout));
+        pipeline.finish();
+        REQUIRE(pipeline.framesWritten() == 10 * PIPELINE_BLOCK_FRAMES);
+    }
+
+    SECTION("finish() rethrows an exception from the reader") {
+        IndexedBlockReader reader{ 20, 5 };
+        for(int i = 0; i != 3; ++i) {
+            writers.push_back(std::make_unique<RecordingWriter>());
+        }
+        PCMPipeline pipeline{ reader, writers, 3, 2 };
+        REQUIRE(pipeline.waitUntilFinished(timeout));
+        REQUIRE_THROWS_WITH(pipeline.finish(), "Read failed");
+    }
+
+    SECTION("finish() rethrows an exception from a writer") {
+        IndexedBlockReader reader{ 20 };
+        writers.push_back(std::make_unique<RecordingWriter>());
+        writers.push_back(std::make_unique<RecordingWriter>(nullptr, 3));
+        PCMPipeline pipeline{ reader, writers, 2, 2 };
+        REQUIRE(pipeline.waitUntilFinished(timeout));
+        REQUIRE_THROWS_WITH(pipeline.finish(), "Write failed");
+        REQUIRE(recorder(1)->blocks.size() == 3);
+    }
+
+    SECTION("cancel() stops a pipeline blocked on a full ring") {
+        Gate gate;
+        IndexedBlockReader reader{ 100 };
+        writers.push_back(std::make_unique<RecordingWriter>(&gate));
+        PCMPipeline pipeline{ reader, writers, 1, 2 };
+        REQUIRE(waitFor([&]() { return reader.blocksRead == 2; }));
+        pipeline.cancel();
+        REQUIRE(pipeline.waitUntilFinished(timeout));
+        gate.open();
+        pipeline.finish();
+        REQUIRE(reader.blocksRead == 2);
+        REQUIRE(recorder(0)->blocks.size() <= 1);
+    }
+}
+
+TEST_CASE("ChannelSelectDecoder") {
+    test::TempDir dir;
+    auto tempFile = dir.path() / boost::filesystem::unique_path();
+    constexpr int channelCount = 3;
+    constexpr int frameCount = 1000;
+    {
+        std::vector<float> data(channelCount * frameCount);
+        for(std::size_t i = 0; i != data.size(); ++i) {
+            data[i] = static_cast<float>(i) / static_cast<float>(data.size());
+        }
+        auto writer = bw64::writeFile(tempFile.string(), channelCount, 48000, 32);
+        writer->write(data.data(), frameCount);
+    }
+    auto expected = [](int frame, int channel) {
+        return static_cast<double>(frame * channelCount + channel) / (channelCount * frameCount);
+    };
+
+    ChannelSelectDecoder decoder{ tempFile.string(), { 2, -1, 0 } };
+    decoder.Open(nullptr, 0, 0, 0);
+    REQUIRE(decoder.IsOpen());
+    REQUIRE(decoder.GetNumChannels() == 3);
+    REQUIRE(decoder.GetLength() == frameCount);
+
+    SECTION("Reads selected channels in order, with silence for undefined tracks") {
+        std::vector<ReaSample> buffer(3 * frameCount);
+        REQUIRE(decoder.ReadSamples(buffer.data(), frameCount) == frameCount);
+        for(int frame = 0; frame != frameCount; ++frame) {
+            REQUIRE(buffer[frame * 3] == Approx(expected(frame, 2)));
+            REQUIRE(buffer[frame * 3 + 1] == 0.0);
+            REQUIRE(buffer[frame * 3 + 2] == Approx(expected(frame, 0)));
+        }
+        REQUIRE(decoder.ReadSamples(buffer.data(), frameCount) == 0);
+    }
+
+    SECTION("Reads from the position set") {
+        std::vector<ReaSample> buffer(3 * 10);
+        decoder.SetPosition(995);
+        REQUIRE(decoder.ReadSamples(buffer.data(), 10) == 5);
+        REQUIRE(buffer[0] == Approx(expected(995, 2)));
+        decoder.SetPosition(10);
+        REQUIRE(decoder.ReadSamples(buffer.data(), 10) == 10);
+        REQUIRE(buffer[2] == Approx(expected(10, 0)));
+        REQUIRE(decoder.GetPosition() == 20);
+    }
+
+    SECTION("Stops short when the file is replaced by a shorter one whilst open") {
+        constexpr int shorterFrameCount = frameCount / 2;
+        {
+            std::vector<float> data(channelCount * shorterFrameCount, 0.5f);
+            auto writer = bw64::writeFile(tempFile.string(), channelCount, 48000, 32);
+            writer->write(data.data(), shorterFrameCount);
+        }
+        std::vector<ReaSample> buffer(3 * frameCount);
+        REQUIRE(decoder.ReadSamples(buffer.data(), frameCount) == shorterFrameCount);
+        REQUIRE(buffer[0] == Approx(0.5));
+        REQUIRE(buffer[1] == 0.0);
+        REQUIRE(decoder.ReadSamples(buffer.data(), frameCount) == 0);
+
+        std::ofstream{ tempFile.string(), std::ios::binary | std::ios::trunc };
+        decoder.SetPosition(0);
+        REQUIRE(decoder.ReadSamples(buffer.data(), frameCount) == 0);
+    }
 }
 
 TEST_CASE("ChannelRouter tests") {
@@ -345,6 +746,18 @@ TEST_CASE("ChannelRouter tests") {
         auto file = ChannelRouter(std::move(fakeWriter), otherIndices);
         file.write(fakeBlock);
     }
+
+    SECTION("On write(), channels are reordered and undefined tracks zeroed across repeated blocks") {
+        std::vector<int> otherIndices({ 1, -1, 0 });
+        auto expected = std::vector<float>{ 2,0,1, 2,0,1, 2,0,1 };
+        EXPECT_CALL(*fakeWriter, write(_)).Times(2).WillRepeatedly(Invoke([&expected](IPCMBlock const& block) {
+            REQUIRE(block.channelCount() == 3);
+            REQUIRE(block.data() == expected);
+        }));
+        auto file = ChannelRouter(std::move(fakeWriter), otherIndices);
+        file.write(fakeBlock);
+        file.write(fakeBlock);
+    }
 }
 
 namespace {
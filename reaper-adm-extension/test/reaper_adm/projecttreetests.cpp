@@ -11,6 +11,7 @@
 #include "mocks/importlistener.h"
 #include "projecttree.h"
 #include <map>
+#include <algorithm>
 
 using ::testing::AnyNumber;
 using ::testing::Invoke;
@@ -361,6 +362,40 @@ TEST_CASE("Project tree", "") {
         }
     }
 
+    SECTION("Given a project tree which already has two takes compatible with a route") {
+        auto object = adm::createSimpleObject("Object");
+        auto takeWithChannel = std::make_shared<MediaTakeElement>(object.audioObject);
+        takeWithChannel->addChannelOfOriginal(1);
+        auto takeWithoutChannels = std::make_shared<MediaTakeElement>(object.audioObject);
+
+        auto rootNode = std::make_unique<ProjectNode>(rootElement);
+        rootNode->addChildNode(std::make_shared<ProjectNode>(takeWithChannel));
+        rootNode->addChildNode(std::make_shared<ProjectNode>(takeWithoutChannels));
+        ProjectTree tree(std::move(fakeCreator),
+                         fakePcmSourceCreator,
+                         std::move(rootNode),
+                         fakeListener);
+        auto doc = adm::Document::create();
+        doc->add(object.audioObject);
+
+        SECTION("When it receives that route") {
+            setChannelForTrackUidExpectations(fakePcmSourceCreator.get(), { {object.audioTrackUid, 1} });
+            expectNodes(0, 1, 0, 1);
+            tree(object.audioObject);
+            tree(object.audioPackFormat);
+            SECTION("it uses the take it comes to first in the tree") {
+                auto trackChildren = tree.getState().currentNode->children();
+                auto hasChildWithElement = [&trackChildren](std::shared_ptr<ProjectElement> const& element) {
+                    return std::any_of(trackChildren.begin(), trackChildren.end(), [&element](auto const& child) {
+                        return child->getProjectElement() == element;
+                    });
+                };
+                REQUIRE(hasChildWithElement(takeWithChannel));
+                REQUIRE_FALSE(hasChildWithElement(takeWithoutChannels));
+            }
+        }
+    }
+
     SECTION("Given a project tree in initial state") {
         ProjectTree tree(std::move(fakeCreator),
                          fakePcmSourceCreator,
@@ -392,6 +427,22 @@ TEST_CASE("Project tree", "") {
                 }
             }
 
+            SECTION("When it receives the same route twice") {
+                uint32_t chCount = 0;
+                setUniqueChannelForTrackUidExpectations(fakePcmSourceCreator.get(), &chCount);
+                expectNodes(0, 1, 1, 1);
+                tree.resetRoot();
+                tree(ao);
+                tree(apf);
+                auto firstTrackNode = tree.getState().currentNode;
+                tree.resetRoot();
+                tree(ao);
+                tree(apf);
+                SECTION("it moves to the existing track") {
+                    REQUIRE(tree.getState().currentNode == firstTrackNode);
+                }
+            }
+
             SECTION("When it receives an object followed by two referenced tuids and channel formats which point to unique tracks of audio") {
                 auto secondTuid = adm::AudioTrackUid::create();
                 auto secondTF = adm::AudioTrackFormat::create(adm::AudioTrackFormatName{ "secondTF" }, adm::FormatDefinition::PCM);
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 /*
     Series of very basic common functions for working with containers
@@ -15,6 +18,11 @@ bool contains(C const& container, T const& element) {
         container.end();
 }
 
+template <typename T>
+bool contains(std::unordered_set<T> const& container, T const& element) {
+    return container.find(element) != container.end();
+}
+
 template <typename C, typename T>
 auto find(C& container, T& element) {
     return std::find(container.begin(), container.end(), element);
@@ -51,4 +59,29 @@ void removeFromMap(std::map<Key, Value>& targetMap, Key key) {
     if (it != targetMap.end()) targetMap.erase(it);
 }
 
+template <typename Key, typename Value>
+Value* getValuePointerFromMap(std::unordered_map<Key, Value>& targetMap, Key key) {
+    auto it = targetMap.find(key);
+    if (it == targetMap.end()) return nullptr;
+    return &(it->second);
+}
+
+template <typename Key, typename Value>
+Value* setInMap(std::unordered_map<Key, Value>& targetMap, Key key, Value value) {
+    auto ins = targetMap.insert_or_assign(key, value);
+    return &(ins.first->second);
+}
+
+template <typename Key, typename Value>
+bool mapHasKey(std::unordered_map<Key, Value>& targetMap, Key key) {
+    auto it = targetMap.find(key);
+    return (it != targetMap.end());
+}
+
+template <typename Key, typename Value>
+void removeFromMap(std::unordered_map<Key, Value>& targetMap, Key key) {
+    auto it = targetMap.find(key);
+    if (it != targetMap.end()) targetMap.erase(it);
+}
+
 }
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#ifdef WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+NOTE:
+
+Read-only view of a whole file, mapped in to memory so large files can be
+read without copying them through stream buffers first. Mapped for
+sequential access, so the OS reads ahead of the current position.
+*/
+
+class MappedFile {
+public:
+    ~MappedFile() {
+#ifdef WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+        if (view) munmap(view, mappedSize);
+#endif
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // nullptr if the file can't be opened or mapped (including when empty)
+    static std::unique_ptr<MappedFile> open(const std::string& path) {
+        std::unique_ptr<MappedFile> mapped{new MappedFile()};
+#ifdef WIN32
+        mapped->file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                   FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (mapped->file == INVALID_HANDLE_VALUE) return nullptr;
+        LARGE_INTEGER fileSize{};
+        if (!GetFileSizeEx(mapped->file, &fileSize) || fileSize.QuadPart <= 0) return nullptr;
+        if (static_cast<uint64_t>(fileSize.QuadPart) > SIZE_MAX) return nullptr;
+        mapped->mapping = CreateFileMappingA(mapped->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mapped->mapping) return nullptr;
+        mapped->view = MapViewOfFile(mapped->mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!mapped->view) return nullptr;
+        mapped->mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return nullptr;
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0 ||
+            static_cast<uint64_t>(st.st_size) > SIZE_MAX) {
+            ::close(fd);
+            return nullptr;
+        }
+        auto size = static_cast<size_t>(st.st_size);
+        void* view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return nullptr;
+        madvise(view, size, MADV_SEQUENTIAL);
+        mapped->view = view;
+        mapped->mappedSize = size;
+#endif
+        return mapped;
+    }
+
+    const uint8_t* data() const { return static_cast<const uint8_t*>(view); }
+    size_t size() const { return mappedSize; }
+
+private:
+    MappedFile() = default;
+
+    void* view{nullptr};
+    size_t mappedSize{0};
+#ifdef WIN32
+    HANDLE file{INVALID_HANDLE_VALUE};
+    HANDLE mapping{NULL};
+#endif
+};
@@ -0,0 +1,253 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "sample_interleaving.hpp"
+#include "shared_memory.h"
+
+/*
+NOTE:
+
+Shared-memory transport carrying export audio from many ADM Export
+Source plugins to the REAPER extension at once.
+
+The extension (single consumer) creates one ring per render and
+assigns each plugin a stream: a fixed range of channels within every
+frame. Plugins (one producer per stream) interleave their blocks
+straight into their own columns of the ring, so a frame is complete
+- and the extension can copy it out alongside every other complete
+frame - once every stream has written it.
+
+The ring is named after a token chosen by the extension, which is
+passed to each plugin over its command socket.
+*/
+
+namespace MultiplexedSamplesRingAddr {
+#ifdef WIN32
+    const std::string basePath{"Local\\ep-m-"};
+    const std::string doorbellBasePath{"Local\\ep-md-"};
+#else
+    const std::string basePath{"/ep-m-"};
+#endif
+}
+
+class MultiplexedSamplesRing {
+public:
+    static constexpr uint32_t MAX_STREAMS = 1024;
+    static constexpr uint32_t BLOCKS_OF_HEADROOM = 16;
+    static constexpr uint32_t MIN_CAPACITY_FRAMES = 16384;
+
+    MultiplexedSamplesRing(const MultiplexedSamplesRing&) = delete;
+    MultiplexedSamplesRing& operator=(const MultiplexedSamplesRing&) = delete;
+
+    // `streamChannels[n]` is the channel count of stream n; streams are laid out in order within each frame
+    static std::unique_ptr<MultiplexedSamplesRing> create(const std::vector<uint32_t>& streamChannels, uint32_t blockSize) {
+        if (streamChannels.empty() || streamChannels.size() > MAX_STREAMS) return nullptr;
+        uint32_t frameChannels = 0;
+        for (auto channels : streamChannels) frameChannels += channels;
+        if (frameChannels == 0) return nullptr;
+        uint32_t capacityFrames = std::max(blockSize * BLOCKS_OF_HEADROOM, MIN_CAPACITY_FRAMES);
+        auto streamCount = static_cast<uint32_t>(streamChannels.size());
+        auto size = totalSize(streamCount, frameChannels, capacityFrames);
+
+        std::random_device random;
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            uint32_t token = random();
+            if (token == 0) continue;  // Reserved for "not multiplexed"
+            std::unique_ptr<MultiplexedSamplesRing> ring{new MultiplexedSamplesRing(token)};
+            ring->region = SharedMemoryRegion::create(ring->name, size, false);
+            if (!ring->region) continue;  // Token in use by another render
+
+            ring->header = new (ring->region->data()) Header{};
+            ring->header->streamCount = streamCount;
+            ring->header->frameChannels = frameChannels;
+            ring->header->capacityFrames = capacityFrames;
+            ring->attach();
+            uint32_t channelOffset = 0;
+            for (uint32_t n = 0; n < streamCount; ++n) {
+                new (&ring->streams[n]) Stream{};
+                ring->streams[n].channelOffset = channelOffset;
+                ring->streams[n].channelCount = streamChannels[n];
+                channelOffset += streamChannels[n];
+            }
+            ring->header->magic.store(MAGIC, std::memory_order_release);
+            return ring;
+        }
+        return nullptr;
+    }
+
+    static std::unique_ptr<MultiplexedSamplesRing> open(uint32_t token) {
+        std::unique_ptr<MultiplexedSamplesRing> ring{new MultiplexedSamplesRing(token)};
+        ring->region = SharedMemoryRegion::open(ring->name);
+        if (!ring->region || ring->region->size() < HEADER_SIZE) return nullptr;
+        ring->header = static_cast<Header*>(ring->region->data());
+        // Magic is set last by the creator
+        if (ring->header->magic.load(std::memory_order_acquire) != MAGIC ||
+            ring->region->size() < totalSize(ring->header->streamCount, ring->header->frameChannels, ring->header->capacityFrames)) {
+            return nullptr;
+        }
+        ring->attach();
+        return ring;
+    }
+
+    uint32_t getToken() const { return token; }
+    uint32_t getStreamCount() const { return header->streamCount; }
+    uint32_t getFrameChannels() const { return header->frameChannels; }
+    uint32_t getCapacityFrames() const { return header->capacityFrames; }
+    uint32_t getStreamChannelCount(uint32_t stream) const { return streams[stream].channelCount; }
+
+    // Writer side - one writer per stream
+
+    // Interleaves `numFrames` from planar `channels` into the stream's channels of the ring.
+    // Channels beyond `numChannels`, or which are nullptr, are zeroed.
+    // Returns false if the reader did not make room within `timeOutMs`.
+    bool writeFrames(uint32_t stream, const float* const* channels, uint32_t numChannels, uint32_t numFrames, int timeOutMs) {
+        if (stream >= header->streamCount) return false;
+        auto& s = streams[stream];
+        const uint32_t capacity = header->capacityFrames;
+        const uint32_t frameChannels = header->frameChannels;
+        uint64_t writePos = s.writeFrame.load(std::memory_order_relaxed);
+        uint32_t written = 0;
+
+        while (written < numFrames) {
+            uint32_t space = capacity - static_cast<uint32_t>(writePos - header->readFrame.load(std::memory_order_acquire));
+            if (space == 0) {
+                if (!spaceBell.waitUntil(timeOutMs, [this, writePos, capacity]() {
+                        return writePos - header->readFrame.load(std::memory_order_acquire) < capacity;
+                    })) {
+                    return false;
+                }
+                continue;
+            }
+
+            uint32_t frameIndex = static_cast<uint32_t>(writePos % capacity);
+            uint32_t chunk = std::min({space, numFrames - written, capacity - frameIndex});
+            interleaveBlock(channels, numChannels, written, chunk,
+                            data + static_cast<size_t>(frameIndex) * frameChannels + s.channelOffset,
+                            frameChannels, s.channelCount);
+
+            written += chunk;
+            writePos += chunk;
+            s.writeFrame.store(writePos, std::memory_order_release);
+            dataBell.ring();
+        }
+        return true;
+    }
+
+    // No more frames will be written to this stream
+    void markEndOfStream(uint32_t stream) {
+        if (stream >= header->streamCount) return;
+        streams[stream].endOfStream.store(1, std::memory_order_release);
+        dataBell.ring();
+    }
+
+    // Reader side
+
+    // Frames which every stream has written and are yet to be read
+    uint64_t readableFrames() const {
+        uint64_t complete = UINT64_MAX;
+        for (uint32_t n = 0; n < header->streamCount; ++n) {
+            complete = std::min(complete, streams[n].writeFrame.load(std::memory_order_acquire));
+        }
+        return complete - header->readFrame.load(std::memory_order_relaxed);
+    }
+
+    // Returns early (false) at the end of the stream
+    bool waitForFrame(int timeOutMs) {
+        dataBell.waitUntil(timeOutMs, [this]() { return readableFrames() > 0 || endOfStream(); });
+        return readableFrames() > 0;
+    }
+
+    // True once any stream has ended and every frame it completed has been read -
+    // frames need every stream, so no more can follow
+    bool endOfStream() const {
+        uint64_t readPos = header->readFrame.load(std::memory_order_relaxed);
+        for (uint32_t n = 0; n < header->streamCount; ++n) {
+            auto& s = streams[n];
+            if (s.endOfStream.load(std::memory_order_acquire) != 0 &&
+                s.writeFrame.load(std::memory_order_acquire) <= readPos) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Pointer to the oldest unread frame (`getFrameChannels()` interleaved samples).
+    // Only valid if readableFrames() > 0, and until advanceFrames() is called.
+    const float* currentFrame() const {
+        uint64_t readPos = header->readFrame.load(std::memory_order_relaxed);
+        return data + static_cast<size_t>(readPos % header->capacityFrames) * header->frameChannels;
+    }
+
+    // Frames readable from currentFrame() onwards before the ring wraps
+    uint32_t contiguousReadableFrames() const {
+        uint64_t readPos = header->readFrame.load(std::memory_order_relaxed);
+        uint32_t untilWrap = header->capacityFrames - static_cast<uint32_t>(readPos % header->capacityFrames);
+        return static_cast<uint32_t>(std::min<uint64_t>(readableFrames(), untilWrap));
+    }
+
+    void advanceFrames(uint32_t count) {
+        header->readFrame.fetch_add(count, std::memory_order_release);
+        spaceBell.ring();
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x4550534D;  // "EPSM"
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Shared between processes - plain data only
+    struct Header {
+        std::atomic<uint32_t> magic{0};
+        uint32_t streamCount{0};
+        uint32_t frameChannels{0};
+        uint32_t capacityFrames{0};
+        alignas(CACHE_LINE) std::atomic<uint64_t> readFrame{0};
+        alignas(CACHE_LINE) std::atomic<uint32_t> dataSequence{0};
+        std::atomic<uint32_t> dataWaiters{0};
+        std::atomic<uint32_t> spaceSequence{0};
+        std::atomic<uint32_t> spaceWaiters{0};
+    };
+    // One per stream, each on its own cache line as they are written by different plugins
+    struct alignas(CACHE_LINE) Stream {
+        uint32_t channelOffset{0};
+        uint32_t channelCount{0};
+        std::atomic<uint64_t> writeFrame{0};
+        std::atomic<uint32_t> endOfStream{0};
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring positions must be lock-free to be shared between processes");
+    static constexpr size_t HEADER_SIZE = (sizeof(Header) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+
+    static size_t totalSize(uint32_t streamCount, uint32_t frameChannels, uint32_t capacityFrames) {
+        return HEADER_SIZE + static_cast<size_t>(streamCount) * sizeof(Stream) +
+               static_cast<size_t>(frameChannels) * capacityFrames * sizeof(float);
+    }
+
+    explicit MultiplexedSamplesRing(uint32_t token)
+        : name{MultiplexedSamplesRingAddr::basePath + std::to_string(token)}, token{token} {}
+
+    void attach() {
+        std::string bellName;
+#ifdef WIN32
+        bellName = MultiplexedSamplesRingAddr::doorbellBasePath + std::to_string(token);
+#endif
+        dataBell.attach(&header->dataSequence, &header->dataWaiters, bellName + "-d");
+        spaceBell.attach(&header->spaceSequence, &header->spaceWaiters, bellName + "-s");
+        streams = reinterpret_cast<Stream*>(reinterpret_cast<char*>(header) + HEADER_SIZE);
+        data = reinterpret_cast<float*>(reinterpret_cast<char*>(streams) + static_cast<size_t>(header->streamCount) * sizeof(Stream));
+    }
+
+    std::string name;
+    uint32_t token;
+    std::unique_ptr<SharedMemoryRegion> region;
+    Header* header{nullptr};
+    Stream* streams{nullptr};
+    float* data{nullptr};
+    SharedMemoryDoorbell dataBell;
+    SharedMemoryDoorbell spaceBell;
+};
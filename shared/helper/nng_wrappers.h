@@ -12,6 +12,9 @@
 #include <nng/protocol/reqrep0/rep.h>
 #include <nng/protocol/pair0/pair.h>
 #include <assert.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <memory>
 #include <string>
@@ -19,6 +22,10 @@
 #include <cstdlib>
 #include <memory>
 #include <cstring>
+#include <mutex>
+#include <thread>
+
+#include "sample_interleaving.hpp"
 
 namespace NNGAddr {
     const std::string protocol {"ipc://"};
@@ -186,6 +193,8 @@ public:
 
     bool atSeqReadEnd() { return (!buf) || (seqReadPos >= getDataCount()); }
 
+    int getSeqReadRemaining() { return buf ? (int)getDataCount() - seqReadPos : 0; }
+
     T* getSeqReadPointer() {
         if (atSeqReadEnd()) return nullptr;
         T* ret = (T*)buf + seqReadPos;
@@ -297,7 +306,33 @@ protected:
 
 class CommandCommon {
 public:
-    enum Command { GetConfig, StartRender, StopRender, GetAdmAndMappings, GetAdmAndMappingsResp, SetAdmAndMappings, SetAdmAndMappingsResp };
+    enum Command { GetConfig, StartRender, StopRender, GetAdmAndMappings, GetAdmAndMappingsResp, SetAdmAndMappings, SetAdmAndMappingsResp, SetChannelMask, SetChannelMaskResp, SetMultiplexedStream, SetMultiplexedStreamResp };
+
+    // Capability flags a plugin appends to its info response
+    static constexpr uint8_t CAPABILITY_MULTIPLEXED_SAMPLES = 1 << 0;
+
+    // Bit n set = input channel n is streamed during export.
+    // Channels are sent in ascending order, so a frame only holds the set channels.
+    static constexpr uint64_t ALL_CHANNELS_MASK = ~uint64_t{0};
+
+    uint64_t decodeChannelMaskMessage(std::shared_ptr<NngMsg> msg) {
+        const size_t cmdSz = sizeof(uint8_t);
+        uint64_t mask = ALL_CHANNELS_MASK;
+        assert(msg->getSize() == cmdSz + sizeof(mask));
+        if (msg->getSize() == cmdSz + sizeof(mask)) {
+            memcpy(&mask, (char*)msg->getBufferPointer() + cmdSz, sizeof(mask));
+        }
+        return mask;
+    }
+
+    // Token 0 leaves the multiplexed ring and returns to the samples socket
+    bool decodeMultiplexedStreamMessage(std::shared_ptr<NngMsg> msg, uint32_t& token, uint32_t& stream) {
+        const size_t cmdSz = sizeof(uint8_t);
+        if (msg->getSize() != cmdSz + sizeof(token) + sizeof(stream)) return false;
+        memcpy(&token, (char*)msg->getBufferPointer() + cmdSz, sizeof(token));
+        memcpy(&stream, (char*)msg->getBufferPointer() + cmdSz + sizeof(token), sizeof(stream));
+        return true;
+    }
 
     nng_msg* encodeAdmAndMappingsMessage(Command cmd, std::string& admStr, std::vector<PluginToAdmMap>& pluginToAdmMaps) {
         nng_msg* msg;
@@ -370,17 +405,21 @@ public:
         nng_aio_set_msg(aio, msg);
     }
 
+    // Readers which predate `capabilities` and `blockSize` only read the first 11 bytes
     void sendInfo(uint8_t channels, uint32_t sampleRate,
                   uint16_t admTypeDefinition = 0, uint16_t admPackFormatId = 0,
-                  uint16_t admChannelFormatId = 0) {
+                  uint16_t admChannelFormatId = 0, uint8_t capabilities = 0,
+                  uint32_t blockSize = 0) {
         nng_msg* msg;
-        nng_msg_alloc(&msg, 11);
+        nng_msg_alloc(&msg, 16);
         char* bufPtr = (char*)nng_msg_body(msg);
         memcpy(bufPtr + 0, &channels, 1);
         memcpy(bufPtr + 1, &sampleRate, 4);
         memcpy(bufPtr + 5, &admTypeDefinition, 2);
         memcpy(bufPtr + 7, &admPackFormatId, 2);
         memcpy(bufPtr + 9, &admChannelFormatId, 2);
+        memcpy(bufPtr + 11, &capabilities, 1);
+        memcpy(bufPtr + 12, &blockSize, 4);
         nng_aio_set_msg(aio, msg);
     }
 
@@ -540,6 +579,47 @@ public:
         return std::move(nngMsg);
     }
 
+    // Plugins which predate this command echo it back rather than replying SetChannelMaskResp
+    std::shared_ptr<NngMsg> sendChannelMask(uint64_t mask) {
+        nng_msg* msg;
+        uint8_t cmdInt = (uint8_t)Command::SetChannelMask;
+        auto resMsg = nng_msg_alloc(&msg, 0);
+        assert(resMsg == 0);
+        resMsg = nng_msg_append(msg, &cmdInt, 1);
+        assert(resMsg == 0);
+        resMsg = nng_msg_append(msg, &mask, sizeof(mask));
+        assert(resMsg == 0);
+        resMsg = nng_sendmsg(socket, msg, 0);
+        assert(resMsg == 0);
+        resMsg = nng_recvmsg(socket, &msg, 0);
+        assert(resMsg == 0);
+        auto nngMsg = std::make_shared<NngMsg>(msg);
+        nng_msg_free(msg);
+        return std::move(nngMsg);
+    }
+
+    // Only send to plugins which report CAPABILITY_MULTIPLEXED_SAMPLES -
+    // older plugins don't reply to commands longer than a byte
+    std::shared_ptr<NngMsg> sendMultiplexedStream(uint32_t token, uint32_t stream) {
+        nng_msg* msg;
+        uint8_t cmdInt = (uint8_t)Command::SetMultiplexedStream;
+        auto resMsg = nng_msg_alloc(&msg, 0);
+        assert(resMsg == 0);
+        resMsg = nng_msg_append(msg, &cmdInt, 1);
+        assert(resMsg == 0);
+        resMsg = nng_msg_append(msg, &token, sizeof(token));
+        assert(resMsg == 0);
+        resMsg = nng_msg_append(msg, &stream, sizeof(stream));
+        assert(resMsg == 0);
+        resMsg = nng_sendmsg(socket, msg, 0);
+        assert(resMsg == 0);
+        resMsg = nng_recvmsg(socket, &msg, 0);
+        assert(resMsg == 0);
+        auto nngMsg = std::make_shared<NngMsg>(msg);
+        nng_msg_free(msg);
+        return std::move(nngMsg);
+    }
+
 private:
     int openSpecifics() override {
         auto resOpen = nng_req_open(&socket);
@@ -556,6 +636,140 @@ private:
     }
 };
 
+/*
+Preallocated nng_msg's for sending sample blocks from an audio thread.
+
+nng_sendmsg takes ownership of (and eventually frees) each message, so they
+can't be recycled. Instead, whilst started, a background thread keeps the
+pool topped up so the audio thread never has to allocate.
+*/
+class SamplesMsgPool {
+public:
+    static constexpr uint32_t POOL_SIZE = 32;
+
+    SamplesMsgPool() {}
+    ~SamplesMsgPool() {
+        stop();
+        if (refiller.joinable()) refiller.join();
+        drain();
+    }
+
+    // Size to preallocate messages at, i.e, bytes for a full block
+    void prepare(size_t bytesPerBlock) { messageSize = bytesPerBlock; }
+
+    void start() {
+        stop();
+        if (refiller.joinable()) refiller.join();
+        drain();
+        running = true;
+        fill();
+        refiller = std::thread([this]() { refillLoop(); });
+    }
+
+    // Does not wait for the refill thread, so may be called from the audio thread
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(refillMutex);
+            running = false;
+        }
+        refillCondition.notify_all();
+    }
+
+    // Returns a message with a body of `size` bytes, or nullptr on allocation failure.
+    // Only allocates if the pool has run dry or `size` exceeds the prepared size.
+    nng_msg* acquire(size_t size) {
+        nng_msg* msg = nullptr;
+        auto readPos = readIndex.load(std::memory_order_relaxed);
+        auto available = writeIndex.load(std::memory_order_acquire) - readPos;
+        if (available > 0) {
+            msg = slots[readPos % POOL_SIZE];
+            readIndex.store(readPos + 1, std::memory_order_release);
+            if (available <= POOL_SIZE / 2) refillCondition.notify_one();
+            if (nng_msg_realloc(msg, size) != 0) {
+                nng_msg_free(msg);
+                return nullptr;
+            }
+            return msg;
+        }
+        if (nng_msg_alloc(&msg, size) != 0) return nullptr;
+        return msg;
+    }
+
+private:
+    void fill() {
+        auto writePos = writeIndex.load(std::memory_order_relaxed);
+        while (writePos - readIndex.load(std::memory_order_acquire) < POOL_SIZE) {
+            nng_msg* msg;
+            if (nng_msg_alloc(&msg, messageSize) != 0) break;
+            slots[writePos % POOL_SIZE] = msg;
+            writeIndex.store(++writePos, std::memory_order_release);
+        }
+    }
+
+    void refillLoop() {
+        std::unique_lock<std::mutex> lock(refillMutex);
+        while (running) {
+            lock.unlock();
+            fill();
+            lock.lock();
+            refillCondition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+
+    // Only when the refill thread is not running
+    void drain() {
+        auto readPos = readIndex.load();
+        auto writePos = writeIndex.load();
+        for (; readPos != writePos; ++readPos) {
+            nng_msg_free(slots[readPos % POOL_SIZE]);
+        }
+        readIndex = readPos;
+    }
+
+    nng_msg* slots[POOL_SIZE]{};
+    std::atomic<uint64_t> readIndex{0};
+    std::atomic<uint64_t> writeIndex{0};
+    std::atomic<size_t> messageSize{0};
+
+    std::mutex refillMutex;
+    std::condition_variable refillCondition;
+    bool running{false};
+    std::thread refiller;
+};
+
+/*
+Whether a plugin is streaming samples for a render, and whether its audio
+thread is part-way through sending a block. Lets the end-of-stream marker
+be sent strictly after the last block.
+*/
+class SamplesStreamState {
+public:
+    void start() { streaming = true; }
+    // Does not wait for a block in progress, so may be called from the audio thread
+    void stop() { streaming = false; }
+    bool isStreaming() const { return streaming; }
+
+    // Audio thread: if this returns true, send a block then call endBlock()
+    bool beginBlock() {
+        inBlock = true;
+        if (!streaming) {
+            inBlock = false;
+            return false;
+        }
+        return true;
+    }
+    void endBlock() { inBlock = false; }
+
+    // Call after stop(), from any thread other than the audio thread
+    void waitForBlockInProgress() const {
+        while (inBlock) std::this_thread::yield();
+    }
+
+private:
+    std::atomic<bool> streaming{false};
+    std::atomic<bool> inBlock{false};
+};
+
 class SamplesSender : public SocketBaseForListeners {
 public:
     SamplesSender() : SocketBaseForListeners() {}
@@ -567,6 +781,22 @@ public:
             (timeOut == 0) ? NNG_FLAG_NONBLOCK : 0);
     }
 
+    // A zero-length block marks the end of the stream. The socket is ordered,
+    // so the receiver sees it after every block sent before it.
+    int sendEndOfStream(int timeOut = 100) {
+        nng_setopt_ms(socket, NNG_OPT_SENDTIMEO, timeOut);
+        return nng_send(socket, nullptr, 0, 0);
+    }
+
+    // Passes ownership of `msg` to NNG, so the block isn't copied again.
+    // `msg` is freed if it could not be sent.
+    int sendBlock(nng_msg* msg, int timeOut = 0) {
+        nng_setopt_ms(socket, NNG_OPT_SENDTIMEO, timeOut);
+        auto res = nng_sendmsg(socket, msg, (timeOut == 0) ? NNG_FLAG_NONBLOCK : 0);
+        if (res != 0) nng_msg_free(msg);
+        return res;
+    }
+
 private:
     int openSpecifics() override {
         auto resOpen = nng_pair_open(&socket);
@@ -0,0 +1,77 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define EPS_INTERLEAVE_SSE 1
+#endif
+
+/*
+Planar to interleaved transpose used when streaming audio blocks from the
+plugins to the REAPER extension.
+
+Writes `numFrames` frames of `width` samples to `dest`, frames being `stride`
+samples apart, where sample `c` of frame `f` is `channels[c][offset + f]`.
+Channels which are nullptr, and any slots in the frame beyond `numChannels`,
+are written as silence. Samples beyond `width` are left untouched, so several
+writers can fill their own slots of the same frames. `width` 0 means `stride`.
+*/
+inline void interleaveBlock(const float* const* channels, uint32_t numChannels,
+                            uint32_t offset, uint32_t numFrames,
+                            float* dest, uint32_t stride, uint32_t width = 0) {
+    if (width == 0 || width > stride) width = stride;
+    numChannels = std::min(numChannels, width);
+    uint32_t channel = 0;
+
+#ifdef EPS_INTERLEAVE_SSE
+    // Transpose 4 channels x 4 frames at a time
+    for (; channel + 4 <= numChannels; channel += 4) {
+        const float* c0 = channels[channel];
+        const float* c1 = channels[channel + 1];
+        const float* c2 = channels[channel + 2];
+        const float* c3 = channels[channel + 3];
+        if (!c0 || !c1 || !c2 || !c3) break;
+        c0 += offset; c1 += offset; c2 += offset; c3 += offset;
+
+        float* out = dest + channel;
+        uint32_t frame = 0;
+        for (; frame + 4 <= numFrames; frame += 4) {
+            __m128 r0 = _mm_loadu_ps(c0 + frame);
+            __m128 r1 = _mm_loadu_ps(c1 + frame);
+            __m128 r2 = _mm_loadu_ps(c2 + frame);
+            __m128 r3 = _mm_loadu_ps(c3 + frame);
+            _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+            _mm_storeu_ps(out + static_cast<size_t>(frame) * stride, r0);
+            _mm_storeu_ps(out + static_cast<size_t>(frame + 1) * stride, r1);
+            _mm_storeu_ps(out + static_cast<size_t>(frame + 2) * stride, r2);
+            _mm_storeu_ps(out + static_cast<size_t>(frame + 3) * stride, r3);
+        }
+        for (; frame < numFrames; ++frame) {
+            float* o = out + static_cast<size_t>(frame) * stride;
+            o[0] = c0[frame]; o[1] = c1[frame]; o[2] = c2[frame]; o[3] = c3[frame];
+        }
+    }
+#endif
+
+    for (; channel < numChannels; ++channel) {
+        float* out = dest + channel;
+        if (const float* in = channels[channel]) {
+            in += offset;
+            for (uint32_t frame = 0; frame < numFrames; ++frame) {
+                out[static_cast<size_t>(frame) * stride] = in[frame];
+            }
+        } else {
+            for (uint32_t frame = 0; frame < numFrames; ++frame) {
+                out[static_cast<size_t>(frame) * stride] = 0.f;
+            }
+        }
+    }
+
+    if (numChannels < width) {
+        for (uint32_t frame = 0; frame < numFrames; ++frame) {
+            float* o = dest + static_cast<size_t>(frame) * stride;
+            std::fill(o + numChannels, o + width, 0.f);
+        }
+    }
+}
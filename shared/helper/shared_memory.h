@@ -0,0 +1,207 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+
+#ifdef WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+#endif
+
+/*
+NOTE:
+
+Building blocks for the shared-memory sample transports
+(SharedSamplesRing, MultiplexedSamplesRing).
+
+SharedMemoryRegion is a named block of memory which the creator
+removes again on destruction. SharedMemoryDoorbell lets one side wait
+for the other to change some state held in a region; a futex on Linux,
+a named semaphore on Windows, and short sleeps on other platforms.
+*/
+
+class SharedMemoryRegion {
+public:
+    ~SharedMemoryRegion() {
+#ifdef WIN32
+        if (view) UnmapViewOfFile(view);
+        if (mapping) CloseHandle(mapping);
+#else
+        if (view) munmap(view, mappedSize);
+        if (isCreator) shm_unlink(name.c_str());
+#endif
+    }
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    // Zero-filled. Fails if a region of this name is already open,
+    // unless `replaceStale` (POSIX only - names outlive crashed creators there).
+    static std::unique_ptr<SharedMemoryRegion> create(const std::string& name, size_t size, bool replaceStale) {
+        std::unique_ptr<SharedMemoryRegion> region{new SharedMemoryRegion(name, true)};
+#ifdef WIN32
+        region->mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+                                             static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                             static_cast<DWORD>(size & 0xFFFFFFFF), name.c_str());
+        if (!region->mapping) return nullptr;
+        if (GetLastError() == ERROR_ALREADY_EXISTS && !replaceStale) return nullptr;
+        region->view = MapViewOfFile(region->mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!region->view) return nullptr;
+#else
+        if (replaceStale) shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd < 0) {
+            region->isCreator = false;  // Someone else's
+            return nullptr;
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        if (!region->mapFd(fd, size)) return nullptr;
+#endif
+        region->mappedSize = size;
+        return region;
+    }
+
+    // Maps an existing region whole. The caller must validate the contents,
+    // as the creator may not have finished initialising it.
+    static std::unique_ptr<SharedMemoryRegion> open(const std::string& name) {
+        std::unique_ptr<SharedMemoryRegion> region{new SharedMemoryRegion(name, false)};
+#ifdef WIN32
+        region->mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+        if (!region->mapping) return nullptr;
+        region->view = MapViewOfFile(region->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+        if (!region->view) return nullptr;
+        MEMORY_BASIC_INFORMATION info{};
+        if (VirtualQuery(region->view, &info, sizeof(info)) == 0) return nullptr;
+        region->mappedSize = info.RegionSize;
+#else
+        int fd = shm_open(name.c_str(), O_RDWR, 0600);
+        if (fd < 0) return nullptr;
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return nullptr;
+        }
+        if (!region->mapFd(fd, static_cast<size_t>(st.st_size))) return nullptr;
+        region->mappedSize = static_cast<size_t>(st.st_size);
+#endif
+        return region;
+    }
+
+    void* data() const { return view; }
+    // May be rounded up to whole pages when opened on Windows
+    size_t size() const { return mappedSize; }
+
+private:
+    SharedMemoryRegion(const std::string& name, bool creator) : name{name}, isCreator{creator} {}
+
+#ifndef WIN32
+    bool mapFd(int fd, size_t size) {
+        void* mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) return false;
+        view = mapped;
+        return true;
+    }
+#endif
+
+    std::string name;
+    bool isCreator;
+    void* view{nullptr};
+    size_t mappedSize{0};
+#ifdef WIN32
+    HANDLE mapping{NULL};
+#endif
+};
+
+/*
+Wakes waiters when `sequence` (which lives in shared memory) is bumped.
+`waiters` counts those waiting, so ring() is cheap when nobody is.
+*/
+class SharedMemoryDoorbell {
+public:
+    ~SharedMemoryDoorbell() {
+#ifdef WIN32
+        if (semaphore) CloseHandle(semaphore);
+#endif
+    }
+
+    // `name` is only used on Windows, for the semaphore
+    void attach(std::atomic<uint32_t>* seq, std::atomic<uint32_t>* waitCount, const std::string& name) {
+        sequence = seq;
+        waiters = waitCount;
+#ifdef WIN32
+        semaphore = CreateSemaphoreA(NULL, 0, MAXLONG, name.c_str());
+#endif
+    }
+
+    uint32_t current() const { return sequence->load(std::memory_order_acquire); }
+
+    void ring() {
+        sequence->fetch_add(1);
+        auto waiting = waiters->load();
+        if (waiting == 0) return;
+#if defined(WIN32)
+        if (semaphore) ReleaseSemaphore(semaphore, static_cast<LONG>(waiting), NULL);
+#elif defined(__linux__)
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(sequence), FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+#endif
+    }
+
+    // Waits until `ready()` or the timeout, returning the last result of `ready()`
+    template <typename Condition>
+    bool waitUntil(int timeOutMs, Condition ready) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeOutMs);
+        waiters->fetch_add(1);
+        bool result = false;
+        while (true) {
+            auto seen = current();
+            if (ready()) { result = true; break; }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0) break;
+            wait(seen, remaining);
+        }
+        waiters->fetch_sub(1);
+        return result;
+    }
+
+private:
+    // Returns once the bell rings after `seen`, or on timeout (possibly spuriously)
+    void wait(uint32_t seen, std::chrono::milliseconds timeOut) {
+#if defined(WIN32)
+        if (semaphore) {
+            WaitForSingleObject(semaphore, static_cast<DWORD>(timeOut.count()));
+            return;
+        }
+#elif defined(__linux__)
+        timespec ts{static_cast<time_t>(timeOut.count() / 1000), static_cast<long>((timeOut.count() % 1000) * 1000000)};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(sequence), FUTEX_WAIT, seen, &ts, nullptr, 0);
+        return;
+#endif
+        std::this_thread::sleep_for(std::min(timeOut, std::chrono::milliseconds(1)));
+    }
+
+    std::atomic<uint32_t>* sequence{nullptr};
+    std::atomic<uint32_t>* waiters{nullptr};
+#ifdef WIN32
+    HANDLE semaphore{NULL};
+#endif
+};
@@ -0,0 +1,252 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+
+#include "sample_interleaving.hpp"
+#include "shared_memory.h"
+
+/*
+NOTE:
+
+Shared-memory transport for export audio from the EPS Scene plugin
+to the REAPER extension.
+
+The Scene (single producer) interleaves each block straight into a
+ring of frames which the extension (single consumer) reads in place,
+so no per-block allocation or socket copy is involved. The ring is
+named after the Scene's SAMPLES port, so the extension can find it
+using the port it already reads from the Scene's parameters.
+
+The NNG samples socket remains as a fallback: the Scene only writes
+to the ring when a reader has attached before StartRender is sent.
+
+Waiting on an empty (reader) or full (writer) ring uses a
+SharedMemoryDoorbell.
+*/
+
+namespace SharedSamplesRingAddr {
+#ifdef WIN32
+    const std::string basePath{"Local\\ep-r-"};
+    const std::string doorbellBasePath{"Local\\ep-rd-"};
+#else
+    const std::string basePath{"/ep-r-"};
+#endif
+}
+
+class SharedSamplesRing {
+public:
+    // Blocks of headroom the Scene allocates - must absorb the largest
+    // lead the render thread can build over the consumer.
+    static constexpr uint32_t BLOCKS_OF_HEADROOM = 64;
+    static constexpr uint32_t MIN_CAPACITY_FRAMES = 8192;
+
+    ~SharedSamplesRing() {
+        if (!isCreator && header) {
+            header->readerAttached.store(0, std::memory_order_release);
+            dataBell.ring();
+        }
+    }
+
+    SharedSamplesRing(const SharedSamplesRing&) = delete;
+    SharedSamplesRing& operator=(const SharedSamplesRing&) = delete;
+
+    static std::unique_ptr<SharedSamplesRing> create(int port, uint32_t channelCount, uint32_t blockSize) {
+        uint32_t capacityFrames = std::max(blockSize * BLOCKS_OF_HEADROOM, MIN_CAPACITY_FRAMES);
+        std::unique_ptr<SharedSamplesRing> ring{new SharedSamplesRing(port, true)};
+        // Stale ring left by a crashed Scene
+        ring->region = SharedMemoryRegion::create(ring->name, totalSize(channelCount, capacityFrames), true);
+        if (!ring->region) return nullptr;
+        ring->header = new (ring->region->data()) Header{};
+        ring->header->channelCount = channelCount;
+        ring->header->capacityFrames = capacityFrames;
+        ring->header->frameChannels = channelCount;
+        ring->header->magic.store(MAGIC, std::memory_order_release);
+        ring->attachDoorbells();
+        return ring;
+    }
+
+    static std::unique_ptr<SharedSamplesRing> open(int port) {
+        std::unique_ptr<SharedSamplesRing> ring{new SharedSamplesRing(port, false)};
+        ring->region = SharedMemoryRegion::open(ring->name);
+        if (!ring->region || ring->region->size() < HEADER_SIZE) return nullptr;
+        ring->header = static_cast<Header*>(ring->region->data());
+        // Magic is set last by the creator
+        if (ring->header->magic.load(std::memory_order_acquire) != MAGIC ||
+            ring->region->size() < totalSize(ring->header->channelCount, ring->header->capacityFrames)) {
+            return nullptr;
+        }
+        ring->attachDoorbells();
+        return ring;
+    }
+
+    uint32_t getChannelCount() const { return header->channelCount; }
+    // Channels per frame for the current render, at most getChannelCount()
+    uint32_t getFrameChannels() const { return header->frameChannels; }
+    uint32_t getCapacityFrames() const { return header->capacityFrames; }
+
+    // Writer side
+
+    bool readerAttached() const {
+        return header->readerAttached.load(std::memory_order_acquire) != 0;
+    }
+
+    // Only valid while the reader is not consuming (e.g. whilst it waits on StartRender)
+    void reset(uint32_t frameChannels) {
+        header->frameChannels = std::min(frameChannels, header->channelCount);
+        header->endOfStream.store(0, std::memory_order_relaxed);
+        header->droppedFrames.store(0, std::memory_order_relaxed);
+        header->writeFrame.store(0, std::memory_order_relaxed);
+        header->readFrame.store(0, std::memory_order_release);
+    }
+
+    // Frames which can be written without waiting for the reader
+    uint32_t writableFrames() const {
+        return header->capacityFrames - static_cast<uint32_t>(header->writeFrame.load(std::memory_order_relaxed) -
+                                                             header->readFrame.load(std::memory_order_acquire));
+    }
+
+    // Records frames the writer had to skip because the ring was full, so the reader can report them
+    void countDroppedFrames(uint32_t numFrames) {
+        header->droppedFrames.fetch_add(numFrames, std::memory_order_relaxed);
+    }
+
+    // Interleaves `numFrames` from planar `channels` into the ring.
+    // Channels beyond `numChannels`, or which are nullptr, are zeroed.
+    // Returns false if the reader did not make room within `timeOutMs`.
+    bool writeFrames(const float* const* channels, uint32_t numChannels, uint32_t numFrames, int timeOutMs) {
+        const uint32_t ringChannels = header->frameChannels;
+        const uint32_t capacity = header->capacityFrames;
+        numChannels = std::min(numChannels, ringChannels);
+        uint64_t writePos = header->writeFrame.load(std::memory_order_relaxed);
+        uint32_t written = 0;
+
+        while (written < numFrames) {
+            uint32_t space = capacity - static_cast<uint32_t>(writePos - header->readFrame.load(std::memory_order_acquire));
+            if (space == 0) {
+                if (!spaceBell.waitUntil(timeOutMs, [this, writePos, capacity]() {
+                        return writePos - header->readFrame.load(std::memory_order_acquire) < capacity;
+                    })) {
+                    return false;
+                }
+                continue;
+            }
+
+            uint32_t frameIndex = static_cast<uint32_t>(writePos % capacity);
+            uint32_t chunk = std::min({space, numFrames - written, capacity - frameIndex});
+            interleaveBlock(channels, numChannels, written, chunk,
+                            data + static_cast<size_t>(frameIndex) * ringChannels, ringChannels);
+
+            written += chunk;
+            writePos += chunk;
+            header->writeFrame.store(writePos, std::memory_order_release);
+            dataBell.ring();
+        }
+        return true;
+    }
+
+    // No more frames will be written until the next reset()
+    void markEndOfStream() {
+        header->endOfStream.store(1, std::memory_order_release);
+        dataBell.ring();
+    }
+
+    // Reader side
+
+    void setReaderAttached(bool attached) {
+        header->readerAttached.store(attached ? 1 : 0, std::memory_order_release);
+    }
+
+    uint64_t readableFrames() const {
+        return header->writeFrame.load(std::memory_order_acquire) -
+               header->readFrame.load(std::memory_order_relaxed);
+    }
+
+    // Returns early (false) at the end of the stream
+    uint64_t droppedFrames() const {
+        return header->droppedFrames.load(std::memory_order_relaxed);
+    }
+
+    bool waitForFrame(int timeOutMs) {
+        dataBell.waitUntil(timeOutMs, [this]() { return readableFrames() > 0 || writerFinished(); });
+        return readableFrames() > 0;
+    }
+
+    // True once the writer has marked the end of the stream and every frame has been read
+    bool endOfStream() const { return writerFinished() && readableFrames() == 0; }
+
+    // Pointer to the oldest unread frame (`getFrameChannels()` interleaved samples).
+    // Only valid if readableFrames() > 0, and until advanceFrame() is called.
+    const float* currentFrame() const {
+        uint64_t readPos = header->readFrame.load(std::memory_order_relaxed);
+        return data + static_cast<size_t>(readPos % header->capacityFrames) * header->frameChannels;
+    }
+
+    // Frames readable from currentFrame() onwards before the ring wraps
+    uint32_t contiguousReadableFrames() const {
+        uint64_t readPos = header->readFrame.load(std::memory_order_relaxed);
+        uint32_t untilWrap = header->capacityFrames - static_cast<uint32_t>(readPos % header->capacityFrames);
+        return static_cast<uint32_t>(std::min<uint64_t>(readableFrames(), untilWrap));
+    }
+
+    void advanceFrame() { advanceFrames(1); }
+
+    void advanceFrames(uint32_t count) {
+        header->readFrame.fetch_add(count, std::memory_order_release);
+        spaceBell.ring();
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x45505352;  // "EPSR"
+    static constexpr size_t CACHE_LINE = 64;
+
+    // Shared between processes - plain data only
+    struct Header {
+        std::atomic<uint32_t> magic{0};
+        uint32_t channelCount{0};
+        uint32_t capacityFrames{0};
+        uint32_t frameChannels{0};
+        alignas(CACHE_LINE) std::atomic<uint64_t> writeFrame{0};
+        std::atomic<uint64_t> droppedFrames{0};
+        alignas(CACHE_LINE) std::atomic<uint64_t> readFrame{0};
+        alignas(CACHE_LINE) std::atomic<uint32_t> readerAttached{0};
+        std::atomic<uint32_t> dataSequence{0};
+        std::atomic<uint32_t> dataWaiters{0};
+        std::atomic<uint32_t> spaceSequence{0};
+        std::atomic<uint32_t> spaceWaiters{0};
+        std::atomic<uint32_t> endOfStream{0};
+    };
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Ring positions must be lock-free to be shared between processes");
+    static constexpr size_t HEADER_SIZE = (sizeof(Header) + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+
+    bool writerFinished() const { return header->endOfStream.load(std::memory_order_acquire) != 0; }
+
+    static size_t totalSize(uint32_t channelCount, uint32_t capacityFrames) {
+        return HEADER_SIZE + static_cast<size_t>(channelCount) * capacityFrames * sizeof(float);
+    }
+
+    SharedSamplesRing(int port, bool creator)
+        : name{SharedSamplesRingAddr::basePath + std::to_string(port)}, port{port}, isCreator{creator} {}
+
+    void attachDoorbells() {
+        std::string bellName;
+#ifdef WIN32
+        bellName = SharedSamplesRingAddr::doorbellBasePath + std::to_string(port);
+#endif
+        dataBell.attach(&header->dataSequence, &header->dataWaiters, bellName + "-d");
+        spaceBell.attach(&header->spaceSequence, &header->spaceWaiters, bellName + "-s");
+        data = reinterpret_cast<float*>(reinterpret_cast<char*>(header) + HEADER_SIZE);
+    }
+
+    std::string name;
+    int port;
+    bool isCreator;
+    std::unique_ptr<SharedMemoryRegion> region;
+    Header* header{nullptr};
+    float* data{nullptr};
+    SharedMemoryDoorbell dataBell;
+    SharedMemoryDoorbell spaceBell;
+};